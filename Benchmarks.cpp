@@ -0,0 +1,1492 @@
+#include "Benchmarks.h"
+#include "FixedMaze.h"
+#include "Maze.h"
+#include "MazeBatch.h"
+#include "MazeFloodFill.h"
+#include "MazeInstrumentation.h"
+#include "MazeMultiBfs.h"
+#include "MazeParallelBfs.h"
+#include "MazePool.h"
+#include "MazeTreeIndex.h"
+#include "TiledGenerator.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <stack>
+#include <streambuf>
+#include <thread>
+#include <vector>
+
+namespace {
+/**
+ * Median wall-clock milliseconds of `repetitions` calls to fn
+ */
+template <typename Fn>
+double medianMillis(int repetitions, Fn fn) {
+    std::vector<double> samples;
+    for (int i = 0; i < repetitions; i++) {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        auto end = std::chrono::steady_clock::now();
+        samples.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+    }
+    std::sort(samples.begin(), samples.end());
+    return samples[samples.size() / 2];
+}
+
+/**
+ * Nearest-rank percentile of a sorted sample (p in [0, 100])
+ */
+template <typename T>
+T percentile(const std::vector<T>& sorted, double p) {
+    if (sorted.empty()) return T();
+    size_t rank = static_cast<size_t>(p / 100.0 * (sorted.size() - 1) + 0.5);
+    return sorted[std::min(rank, sorted.size() - 1)];
+}
+}
+
+/**
+ * Tiled generation scaling across thread counts
+ */
+void runParallelScalingBenchmark(std::ostream& out, int width, int height, int tileSize,
+                                 int maxThreads, unsigned int seed, int repetitions) {
+    if (maxThreads < 1) maxThreads = 1;
+    if (repetitions < 1) repetitions = 1;
+    double cells = static_cast<double>(width) * height;
+
+    out << "\nParallel tiled generation: " << width << "x" << height
+        << ", tile " << TiledGenerator::tileWidth(tileSize) << "x" << tileSize
+        << ", seed " << seed << "\n";
+    out << std::string(52, '-') << "\n";
+
+    Maze maze(width, height);
+    double serial = medianMillis(repetitions, [&] { maze.generate(MazeAlgorithm::DFS, seed); });
+    out << "Single-threaded iterative DFS: " << std::fixed << std::setprecision(1) << serial << " ms\n\n";
+
+    out << std::setw(8) << "Threads" << std::setw(12) << "Median ms" << std::setw(12) << "Mcells/s"
+        << std::setw(10) << "Speedup" << "\n";
+
+    std::vector<int> threadCounts;
+    for (int t = 1; t < maxThreads; t *= 2) threadCounts.push_back(t);
+    threadCounts.push_back(maxThreads);
+
+    double base = 0;
+    uint64_t reference = 0;
+    bool deterministic = true;
+    for (int threads : threadCounts) {
+        ThreadPool pool(threads);
+        double ms = medianMillis(repetitions, [&] { maze.generateParallel(seed, tileSize, pool); });
+        if (base == 0) {
+            base = ms;
+            reference = maze.getGrid().fingerprint();
+        } else if (maze.getGrid().fingerprint() != reference) {
+            deterministic = false;
+        }
+
+        out << std::setw(8) << threads << std::setw(12) << std::setprecision(1) << ms
+            << std::setw(12) << std::setprecision(2) << cells / ms / 1000.0
+            << std::setw(9) << std::setprecision(2) << base / ms << "x\n";
+    }
+
+    out << "\nSame maze for every thread count: " << (deterministic ? "yes" : "NO") << "\n";
+    out.unsetf(std::ios::floatfield);
+}
+
+/**
+ * Batch arena generation against one Maze per iteration
+ */
+void runBatchBenchmark(std::ostream& out, int width, int height, size_t count, int threads,
+                       unsigned int seed) {
+    if (count == 0) return;
+    out << "\nBatch generation: " << count << " mazes of " << width << "x" << height
+        << ", " << threads << " thread(s), seed " << seed << "\n";
+    out << std::string(64, '-') << "\n";
+
+    // Baseline: construct + generateMazeIterative per maze
+    std::vector<uint64_t> loopLatency(count);
+    auto loopStart = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < count; i++) {
+        auto start = std::chrono::steady_clock::now();
+        Maze maze(width, height, seed + static_cast<unsigned int>(i));
+        maze.generateMazeIterative();
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        loopLatency[i] = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+    }
+    double loopSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - loopStart).count();
+
+    // Batch: one arena, one pool; the first run warms up the scratch buffers
+    MazeBatch batch(width, height, count);
+    ThreadPool pool(threads);
+    std::vector<uint64_t> batchLatency;
+    batch.generate(seed, pool);
+    auto batchStart = std::chrono::steady_clock::now();
+    batch.generate(seed, pool, MazeAlgorithm::DFS, &batchLatency);
+    double batchSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - batchStart).count();
+
+    std::sort(loopLatency.begin(), loopLatency.end());
+    std::sort(batchLatency.begin(), batchLatency.end());
+
+    out << std::setw(22) << "" << std::setw(14) << "mazes/s" << std::setw(12) << "p50 us"
+        << std::setw(12) << "p99 us" << "\n";
+    out << std::fixed << std::setprecision(1);
+    out << std::setw(22) << "Maze loop" << std::setw(14) << count / loopSeconds
+        << std::setw(12) << percentile(loopLatency, 50) / 1000.0
+        << std::setw(12) << percentile(loopLatency, 99) / 1000.0 << "\n";
+    out << std::setw(22) << "MazeBatch" << std::setw(14) << count / batchSeconds
+        << std::setw(12) << percentile(batchLatency, 50) / 1000.0
+        << std::setw(12) << percentile(batchLatency, 99) / 1000.0 << "\n";
+    out << "\nSpeedup: " << std::setprecision(2) << loopSeconds / batchSeconds << "x, arena "
+        << batch.memoryBytes() / 1024 << " KiB (" << std::setprecision(1)
+        << static_cast<double>(batch.memoryBytes()) / count << " bytes/maze)\n";
+    out.unsetf(std::ios::floatfield);
+}
+
+/**
+ * Solver modes against plain BFS on the same queries
+ */
+void runSolverBenchmark(std::ostream& out, int width, int height, int queries, unsigned int seed) {
+    if (width < 1 || height < 1) return;
+    if (queries < 0) queries = 0;
+    out << "\nSolver comparison: " << width << "x" << height << " DFS maze, seed " << seed
+        << ", far corner + " << queries << " random pairs\n";
+    out << std::string(70, '-') << "\n";
+
+    Maze maze(width, height);
+    maze.generate(MazeAlgorithm::DFS, seed);
+
+    // Query 0 is corner to corner, the rest are uniform random pairs
+    MazeRandom rng(seed ^ 0x50175u);
+    std::vector<int> endpoints = {0, 0, width - 1, height - 1};
+    for (int q = 0; q < queries; q++) {
+        for (int i = 0; i < 2; i++) {
+            endpoints.push_back(static_cast<int>(boundedDraw(rng, static_cast<uint32_t>(width))));
+            endpoints.push_back(static_cast<int>(boundedDraw(rng, static_cast<uint32_t>(height))));
+        }
+    }
+    const size_t total = endpoints.size() / 4;
+
+    out << std::setw(20) << "Mode" << std::setw(12) << "us/query" << std::setw(16) << "nodes/query"
+        << std::setw(14) << "corner nodes" << std::setw(10) << "Speedup" << "\n";
+
+    MazeSolver solver;
+    std::vector<long long> reference(total);
+    double bfsMicros = 0;
+    bool allMatch = true;
+    for (int m = 0; m < SOLVER_MODE_COUNT; m++) {
+        SolverMode mode = static_cast<SolverMode>(m);
+        std::vector<long long> lengths(total);
+        size_t nodes = 0, cornerNodes = 0;
+
+        solver.shortestPathLength(maze.getGrid(), 0, 0, width - 1, height - 1, mode);  // Size the buffers
+        auto start = std::chrono::steady_clock::now();
+        for (size_t q = 0; q < total; q++) {
+            const int* p = &endpoints[q * 4];
+            lengths[q] = solver.shortestPathLength(maze.getGrid(), p[0], p[1], p[2], p[3], mode);
+            nodes += solver.nodesExpanded();
+            if (q == 0) cornerNodes = solver.nodesExpanded();
+        }
+        double micros = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count()
+                        / total;
+
+        if (mode == SolverMode::BFS) {
+            reference = lengths;
+            bfsMicros = micros;
+        } else if (lengths != reference) {
+            allMatch = false;
+        }
+
+        out << std::setw(20) << solverModeName(mode) << std::fixed << std::setprecision(1)
+            << std::setw(12) << micros << std::setw(16) << static_cast<double>(nodes) / total
+            << std::setw(14) << cornerNodes << std::setw(9) << std::setprecision(2) << bfsMicros / micros << "x\n";
+    }
+
+    out << "\nSame path lengths as BFS: " << (allMatch ? "yes" : "NO")
+        << ", corner-to-corner length " << reference[0] << ", solver scratch "
+        << solver.memoryBytes() / 1024 << " KiB\n";
+    out.unsetf(std::ios::floatfield);
+}
+
+/**
+ * Tree index queries against one BFS per query
+ */
+void runTreeIndexBenchmark(std::ostream& out, int width, int height, int queries, int bfsQueries,
+                           unsigned int seed) {
+    if (width < 1 || height < 1 || queries < 1) return;
+    bfsQueries = std::max(1, std::min(bfsQueries, queries));
+    out << "\nTree index: " << width << "x" << height << " DFS maze, seed " << seed
+        << ", " << queries << " random pairs\n";
+    out << std::string(60, '-') << "\n";
+
+    Maze maze(width, height);
+    maze.generate(MazeAlgorithm::DFS, seed);
+    const MazeGrid& grid = maze.getGrid();
+
+    MazeRandom rng(seed ^ 0x78EE5u);
+    std::vector<int> endpoints(static_cast<size_t>(queries) * 4);
+    for (int q = 0; q < queries; q++) {
+        endpoints[q * 4] = static_cast<int>(boundedDraw(rng, static_cast<uint32_t>(width)));
+        endpoints[q * 4 + 1] = static_cast<int>(boundedDraw(rng, static_cast<uint32_t>(height)));
+        endpoints[q * 4 + 2] = static_cast<int>(boundedDraw(rng, static_cast<uint32_t>(width)));
+        endpoints[q * 4 + 3] = static_cast<int>(boundedDraw(rng, static_cast<uint32_t>(height)));
+    }
+
+    MazeTreeIndex index;
+    double buildMs = medianMillis(1, [&] { index.build(grid); });
+    if (!index.valid()) {
+        out << "Maze is not perfect; no index built\n";
+        return;
+    }
+
+    std::vector<long long> distances(queries);
+    auto start = std::chrono::steady_clock::now();
+    for (int q = 0; q < queries; q++) {
+        const int* p = &endpoints[q * 4];
+        distances[q] = index.distance(p[0], p[1], p[2], p[3]);
+    }
+    double distanceNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count()
+                        / queries;
+
+    // Paths in DFS mazes are long, so extraction runs on a bounded subset
+    const int pathQueries = std::min(queries, 1000);
+    std::vector<uint32_t> path;
+    size_t pathCells = 0;
+    start = std::chrono::steady_clock::now();
+    for (int q = 0; q < pathQueries; q++) {
+        const int* p = &endpoints[q * 4];
+        index.path(p[0], p[1], p[2], p[3], path);
+        pathCells += path.size();
+    }
+    double pathNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count()
+                    / pathQueries;
+
+    MazeSolver solver;
+    bool agree = true;
+    solver.shortestPathLength(grid, 0, 0, 0, 0);  // Size the buffers
+    start = std::chrono::steady_clock::now();
+    for (int q = 0; q < bfsQueries; q++) {
+        const int* p = &endpoints[q * 4];
+        if (solver.shortestPathLength(grid, p[0], p[1], p[2], p[3]) != distances[q]) agree = false;
+    }
+    double bfsNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count()
+                   / bfsQueries;
+
+    out << std::fixed << std::setprecision(1);
+    out << "Build: " << buildMs << " ms, index " << index.memoryBytes() / 1024 << " KiB ("
+        << static_cast<double>(index.memoryBytes()) / grid.cellCount() << " bytes/cell)\n\n";
+    out << std::setw(22) << "" << std::setw(14) << "ns/query" << std::setw(16) << "queries/s" << "\n";
+    out << std::setw(22) << "Index distance" << std::setw(14) << distanceNs << std::setw(16) << 1e9 / distanceNs << "\n";
+    out << std::setw(22) << "Index path" << std::setw(14) << pathNs << std::setw(16) << 1e9 / pathNs << "\n";
+    out << std::setw(22) << "BFS per query" << std::setw(14) << bfsNs << std::setw(16) << 1e9 / bfsNs << "\n";
+    out << "\nDistance speedup over BFS: " << std::setprecision(0) << bfsNs / distanceNs
+        << "x, mean path " << std::setprecision(1) << static_cast<double>(pathCells) / pathQueries
+        << " cells (" << std::setprecision(2) << pathNs / (static_cast<double>(pathCells) / pathQueries)
+        << " ns/cell), BFS agrees on " << bfsQueries << " queries: " << (agree ? "yes" : "NO") << "\n";
+    out.unsetf(std::ios::floatfield);
+}
+
+/**
+ * Renderer throughput into memory and through a stream
+ */
+void runRenderBenchmark(std::ostream& out, int width, int height, unsigned int seed, int repetitions) {
+    if (width < 1 || height < 1) return;
+    if (repetitions < 1) repetitions = 1;
+    out << "\nRendering: " << width << "x" << height << " DFS maze, seed " << seed << "\n";
+    out << std::string(60, '-') << "\n";
+
+    Maze maze(width, height);
+    double generateMs = medianMillis(repetitions, [&] { maze.generate(MazeAlgorithm::DFS, seed); });
+    out << "Generation: " << std::fixed << std::setprecision(1) << generateMs << " ms\n\n";
+
+    out << std::setw(8) << "Format" << std::setw(12) << "MiB" << std::setw(14) << "string MB/s"
+        << std::setw(14) << "stream MB/s" << std::setw(12) << "vs gen" << "\n";
+
+    std::ofstream sink("/dev/null", std::ios::binary);
+    for (StreamFormat format : {StreamFormat::BOX, StreamFormat::ASCII}) {
+        std::string text;
+        maze.renderMaze(text, format);  // Sizes the string once
+        double bytes = static_cast<double>(text.size());
+
+        double stringMs = medianMillis(repetitions, [&] {
+            text.clear();
+            maze.renderMaze(text, format);
+        });
+        double streamMs = medianMillis(repetitions, [&] {
+            maze.writeMaze(sink, format);
+        });
+
+        out << std::setw(8) << (format == StreamFormat::BOX ? "box" : "ascii")
+            << std::setw(12) << std::setprecision(1) << bytes / (1024.0 * 1024.0)
+            << std::setw(14) << bytes / stringMs / 1000.0
+            << std::setw(14) << (sink ? bytes / streamMs / 1000.0 : 0.0)
+            << std::setw(11) << std::setprecision(2) << stringMs / generateMs << "x\n";
+    }
+    out.unsetf(std::ios::floatfield);
+}
+
+/**
+ * Mapped load against regeneration from the seed
+ */
+void runFileBenchmark(std::ostream& out, int width, int height, unsigned int seed, const std::string& path,
+                      int repetitions) {
+    if (width < 1 || height < 1) return;
+    if (repetitions < 1) repetitions = 1;
+    out << "\nMaze files: " << width << "x" << height << " DFS maze, seed " << seed << ", " << path << "\n";
+    out << std::string(60, '-') << "\n";
+
+    Maze original(width, height);
+    double generateMs = medianMillis(repetitions, [&] { original.generate(MazeAlgorithm::DFS, seed); });
+    MazeFileStatus status = MazeFileStatus::OK;
+    double saveMs = medianMillis(repetitions, [&] { status = original.save(path); });
+    if (status != MazeFileStatus::OK) {
+        out << "Save failed: " << mazeFileStatusName(status) << "\n";
+        return;
+    }
+
+    Maze loaded(1, 1);
+    double mapMs = medianMillis(repetitions, [&] { status = loaded.load(path, false); });
+    double verifyMs = medianMillis(repetitions, [&] { status = loaded.load(path, true); });
+    bool sameWalls = status == MazeFileStatus::OK && loaded.getGrid().fingerprint() == original.getGrid().fingerprint();
+
+    MazeSolver solver;
+    bool sameSolution = solver.shortestPathLength(loaded.getGrid(), 0, 0, width - 1, height - 1) ==
+                        solver.shortestPathLength(original.getGrid(), 0, 0, width - 1, height - 1);
+
+    Maze replay(width, height);
+    const MazeOrigin& origin = loaded.getOrigin();
+    double replayMs = medianMillis(repetitions, [&] { replay.generate(origin.algorithm, origin.seed); });
+    bool replayMatches = replay.getGrid().fingerprint() == original.getGrid().fingerprint();
+
+    // Flip one byte in the middle of the south plane; the checksum must notice
+    size_t fileBytes = MAZE_FILE_HEADER_BYTES + 16 * original.getGrid().getPlaneWords();
+    bool corruptionCaught = false;
+    {
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        std::streamoff offset = static_cast<std::streamoff>(fileBytes - 8 * original.getGrid().getPlaneWords() / 2 - 1);
+        char byte = 0;
+        file.seekg(offset);
+        file.get(byte);
+        file.seekp(offset);
+        file.put(static_cast<char>(byte ^ 0x10));
+    }
+    Maze corrupted(1, 1);
+    corruptionCaught = corrupted.load(path, true) == MazeFileStatus::CHECKSUM_MISMATCH;
+    std::remove(path.c_str());
+
+    out << std::fixed << std::setprecision(2);
+    out << "File size: " << fileBytes / 1024 << " KiB (" << static_cast<double>(fileBytes * 8) / (static_cast<double>(width) * height)
+        << " bits/cell)\n\n";
+    out << std::setw(30) << "" << std::setw(12) << "ms" << std::setw(12) << "vs regen" << "\n";
+    out << std::setw(30) << "Generate from seed" << std::setw(12) << replayMs << std::setw(11) << 1.0 << "x\n";
+    out << std::setw(30) << "Save" << std::setw(12) << saveMs << "\n";
+    out << std::setw(30) << "Load (map only)" << std::setw(12) << mapMs << std::setw(11) << replayMs / mapMs << "x\n";
+    out << std::setw(30) << "Load (map + verify checksum)" << std::setw(12) << verifyMs
+        << std::setw(11) << replayMs / verifyMs << "x\n";
+    out << "\nOriginal generation " << generateMs << " ms. Loaded walls match: " << (sameWalls ? "yes" : "NO")
+        << ", same solution: " << (sameSolution ? "yes" : "NO")
+        << ", seed replay matches: " << (replayMatches ? "yes" : "NO")
+        << ", corruption detected: " << (corruptionCaught ? "yes" : "NO") << "\n";
+    out.unsetf(std::ios::floatfield);
+}
+
+/**
+ * Connectivity: the old stack DFS over the visited plane, BFS, and the
+ * bit-parallel flood fill (scalar and AVX2)
+ */
+void runConnectivityBenchmark(std::ostream& out, int width, int height, unsigned int seed, int repetitions) {
+    if (width < 1 || height < 1) return;
+    if (repetitions < 1) repetitions = 1;
+    const double cells = static_cast<double>(width) * height;
+    const bool avx2 = MazeFloodFill::vectorized();
+    out << "\nConnectivity check: " << width << "x" << height << " mazes, seed " << seed << ", AVX2 "
+        << (avx2 ? "available" : "not available") << "\n";
+    out << std::string(92, '-') << "\n";
+    out << std::setw(22) << "Algorithm" << std::setw(12) << "DFS ms" << std::setw(12) << "BFS ms"
+        << std::setw(12) << "Fill ms" << std::setw(12) << "Fill AVX2" << std::setw(10) << "Speedup"
+        << std::setw(12) << "Mcells/s" << "\n";
+
+    MazeSolver solver;
+    MazeFloodFill floodFill;
+    for (int a = 0; a < MAZE_ALGORITHM_COUNT; a++) {
+        MazeAlgorithm algorithm = static_cast<MazeAlgorithm>(a);
+        Maze maze(width, height, seed);
+        maze.generate(algorithm, seed);
+        MazeGrid grid = maze.getGrid();
+
+        // The former Maze::isMazeConnected, which used the visited plane
+        size_t dfsCount = 0;
+        double dfsMs = medianMillis(repetitions, [&] {
+            grid.clearVisited();
+            std::stack<std::pair<int, int>> toVisit;
+            grid.markVisited(0, 0);
+            toVisit.push({0, 0});
+            dfsCount = 1;
+            while (!toVisit.empty()) {
+                auto [cx, cy] = toVisit.top();
+                toVisit.pop();
+                for (int d = TOP; d <= LEFT; d++) {
+                    if (grid.hasWall(cx, cy, static_cast<Direction>(d))) continue;
+                    int nx = cx + (d == RIGHT) - (d == LEFT);
+                    int ny = cy + (d == BOTTOM) - (d == TOP);
+                    if (!grid.isVisited(nx, ny)) {
+                        grid.markVisited(nx, ny);
+                        toVisit.push({nx, ny});
+                        dfsCount++;
+                    }
+                }
+            }
+        });
+        size_t bfsCount = 0;
+        double bfsMs = medianMillis(repetitions, [&] { bfsCount = solver.reachableCells(grid, 0, 0); });
+
+        size_t fillCount = 0;
+        MazeFloodFill::setVectorized(false);
+        double scalarMs = medianMillis(repetitions, [&] { fillCount = floodFill.fill(grid, 0, 0); });
+        MazeFloodFill::setVectorized(avx2);
+        size_t vectorCount = 0;
+        double vectorMs = medianMillis(repetitions, [&] { vectorCount = floodFill.fill(grid, 0, 0); });
+        double fillMs = std::min(scalarMs, vectorMs);
+
+        out << std::setw(22) << algorithmName(algorithm) << std::fixed << std::setprecision(2)
+            << std::setw(12) << dfsMs << std::setw(12) << bfsMs << std::setw(12) << scalarMs;
+        if (avx2) {
+            out << std::setw(12) << vectorMs;
+        } else {
+            out << std::setw(12) << "-";
+        }
+        out << std::setw(9) << std::setprecision(1) << dfsMs / fillMs << "x" << std::setw(12)
+            << cells / fillMs / 1000.0;
+        if (dfsCount != fillCount || bfsCount != fillCount || vectorCount != fillCount) {
+            out << "  MISMATCH (" << dfsCount << "/" << bfsCount << "/" << fillCount << "/" << vectorCount << ")";
+        }
+        out << "\n";
+    }
+    out << "Speedup: old DFS against the faster flood fill; the flood fill does not touch the visited plane.\n";
+    out.unsetf(std::ios::floatfield);
+}
+
+/**
+ * Random engines: raw draws, seeding, and generation throughput
+ */
+void runRandomBenchmark(std::ostream& out, int width, int height, unsigned int seed, int repetitions) {
+    if (width < 1 || height < 1) return;
+    if (repetitions < 1) repetitions = 1;
+    const bool avx2 = MazeRandom::vectorized();
+    out << "\nRandom engines: " << width << "x" << height << " mazes, seed " << seed
+        << ", AVX2 kernels " << (avx2 ? "available" : "not available") << "\n";
+    out << std::string(76, '-') << "\n";
+
+    const size_t draws = 1 << 24;
+    const int seeds = 20000;
+    std::vector<uint32_t> block(draws);
+    volatile uint32_t keep = 0;
+
+    out << std::setw(22) << "Engine" << std::setw(14) << "Mdraws/s" << std::setw(14) << "fill Md/s"
+        << std::setw(14) << "scalar fill" << std::setw(12) << "seeds/ms" << "\n";
+    for (int e = 0; e < RANDOM_ENGINE_COUNT; e++) {
+        RandomEngine engine = static_cast<RandomEngine>(e);
+        MazeRandom rng(seed, engine);
+        double oneMs = medianMillis(repetitions, [&] {
+            uint32_t sum = 0;
+            for (size_t i = 0; i < draws; i++) sum += rng();
+            keep = keep + sum;
+        });
+        double fillMs = medianMillis(repetitions, [&] { rng.fill(block.data(), draws); });
+        MazeRandom::setVectorized(false);
+        double scalarMs = medianMillis(repetitions, [&] { rng.fill(block.data(), draws); });
+        MazeRandom::setVectorized(avx2);
+        double seedMs = medianMillis(repetitions, [&] {
+            for (int i = 0; i < seeds; i++) {
+                rng.seed(seed + static_cast<unsigned int>(i));
+                keep = keep + rng();
+            }
+        });
+
+        out << std::setw(22) << randomEngineName(engine) << std::fixed << std::setprecision(1)
+            << std::setw(14) << draws / oneMs / 1000.0 << std::setw(14) << draws / fillMs / 1000.0
+            << std::setw(14) << draws / scalarMs / 1000.0 << std::setw(12) << seeds / seedMs << "\n";
+    }
+
+    // Generation: same algorithm, same seed, only the engine changes
+    const double cells = static_cast<double>(width) * height;
+    const MazeAlgorithm algorithms[] = {MazeAlgorithm::DFS, MazeAlgorithm::KRUSKAL, MazeAlgorithm::WILSON,
+                                        MazeAlgorithm::BINARY_TREE};
+    out << "\nGeneration Mcells/s (speedup over mt19937)\n";
+    out << std::setw(22) << "Algorithm";
+    for (int e = 0; e < RANDOM_ENGINE_COUNT; e++) out << std::setw(18) << randomEngineKey(static_cast<RandomEngine>(e));
+    out << "\n";
+
+    MazeGrid grid(width, height);
+    MazeGeneratorEngine generators;
+    for (MazeAlgorithm algorithm : algorithms) {
+        out << std::setw(22) << algorithmName(algorithm);
+        double baseMs = 0;
+        for (int e = 0; e < RANDOM_ENGINE_COUNT; e++) {
+            MazeRandom rng(seed, static_cast<RandomEngine>(e));
+            double ms = medianMillis(repetitions, [&] {
+                rng.seed(seed);
+                generators.generate(algorithm, grid, rng);
+            });
+            if (e == 0) baseMs = ms;
+            out << std::setw(10) << std::setprecision(2) << cells / ms / 1000.0
+                << " (" << std::setw(4) << baseMs / ms << "x)";
+        }
+        out << "\n";
+    }
+
+    // Small mazes: per-stream seeding is a visible share of the work
+    const size_t batchCount = 20000;
+    MazeBatch batch(16, 16, batchCount);
+    ThreadPool pool(1);
+    out << std::setw(22) << "Batch 16x16 (mazes/ms)";
+    for (int e = 0; e < RANDOM_ENGINE_COUNT; e++) {
+        RandomEngine engine = static_cast<RandomEngine>(e);
+        double ms = medianMillis(repetitions, [&] {
+            batch.generate(seed, pool, MazeAlgorithm::DFS, nullptr, engine);
+        });
+        out << std::setw(18) << std::setprecision(1) << batchCount / ms;
+    }
+    out << "\n";
+    out.unsetf(std::ios::floatfield);
+}
+
+/**
+ * Parallel BFS distance fields across thread counts
+ */
+void runParallelBfsBenchmark(std::ostream& out, int width, int height, int maxThreads, unsigned int seed,
+                             int repetitions) {
+    if (width < 1 || height < 1) return;
+    if (maxThreads < 1) maxThreads = 1;
+    if (repetitions < 1) repetitions = 1;
+    const double cells = static_cast<double>(width) * height;
+
+    std::vector<int> threadCounts;
+    for (int t = 1; t < maxThreads; t *= 2) threadCounts.push_back(t);
+    threadCounts.push_back(maxThreads);
+    std::vector<std::unique_ptr<ThreadPool>> pools;
+    for (int threads : threadCounts) pools.emplace_back(new ThreadPool(threads));
+
+    out << "\nParallel BFS distance field from (0, 0): " << width << "x" << height << " mazes, seed " << seed
+        << ", " << std::max(1u, std::thread::hardware_concurrency()) << " hardware threads\n";
+    out << std::string(44 + 10 * threadCounts.size() + 18, '-') << "\n";
+    out << std::setw(22) << "Algorithm" << std::setw(10) << "Levels" << std::setw(12) << "Serial BFS";
+    for (int threads : threadCounts) out << std::setw(8) << threads << " t";
+    out << std::setw(10) << "Speedup" << std::setw(8) << "Mc/s" << "\n";
+
+    MazeSolver solver;
+    MazeParallelBfs bfs;
+    std::vector<uint32_t> reference;
+    bool allMatch = true;
+    size_t bottomUp = 0;
+    for (int a = 0; a < MAZE_ALGORITHM_COUNT; a++) {
+        MazeAlgorithm algorithm = static_cast<MazeAlgorithm>(a);
+        Maze maze(width, height, seed);
+        maze.generate(algorithm, seed);
+        const MazeGrid& grid = maze.getGrid();
+
+        double serialMs = medianMillis(repetitions, [&] { solver.reachableCells(grid, 0, 0); });
+        out << std::setw(22) << algorithmName(algorithm) << std::fixed << std::setprecision(2);
+
+        double firstMs = 0, bestMs = 0;
+        bool match = true;
+        for (size_t i = 0; i < pools.size(); i++) {
+            double ms = medianMillis(repetitions, [&] { bfs.distanceField(grid, 0, 0, *pools[i]); });
+            if (i == 0) {
+                reference = bfs.distances();
+                firstMs = bestMs = ms;
+                out << std::setw(10) << bfs.levels() << std::setw(12) << serialMs;
+            } else {
+                match = match && bfs.distances() == reference;
+                bestMs = std::min(bestMs, ms);
+            }
+            bottomUp += bfs.bottomUpLevels();
+            out << std::setw(10) << ms;
+        }
+
+        // Point queries against the serial solver: far corner and middle
+        for (int q = 0; q < 2; q++) {
+            int x = q == 0 ? width - 1 : width / 2;
+            int y = q == 0 ? height - 1 : height / 2;
+            match = match && bfs.shortestPathLength(grid, 0, 0, x, y, *pools.back()) ==
+                                 solver.shortestPathLength(grid, 0, 0, x, y) &&
+                    static_cast<long long>(reference[static_cast<size_t>(y) * width + x]) ==
+                        solver.shortestPathLength(grid, 0, 0, x, y);
+        }
+        allMatch = allMatch && match;
+
+        out << std::setw(9) << std::setprecision(2) << firstMs / bestMs << "x" << std::setw(8)
+            << std::setprecision(1) << cells / bestMs / 1000.0 << (match ? "" : "  MISMATCH") << "\n";
+    }
+    out << "Columns: milliseconds per thread count; speedup of the best against 1 thread.\n"
+        << "Bottom-up levels: " << bottomUp << "; levels under " << MazeParallelBfs::PARALLEL_MIN
+        << " cells run on the calling thread.\n"
+        << "Same distances for every thread count and same lengths as MazeSolver: " << (allMatch ? "yes" : "NO")
+        << "\n";
+    out.unsetf(std::ios::floatfield);
+}
+
+/**
+ * Maze analytics: statistics and cost per algorithm
+ */
+void runAnalyticsBenchmark(std::ostream& out, int width, int height, unsigned int seed, int repetitions) {
+    if (width < 1 || height < 1) return;
+    if (repetitions < 1) repetitions = 1;
+    const double cells = static_cast<double>(width) * height;
+    out << "\nMaze analytics: " << width << "x" << height << " mazes, seed " << seed << "\n";
+    out << std::string(106, '-') << "\n";
+    out << std::setw(22) << "Algorithm" << std::setw(10) << "Dead end%" << std::setw(10) << "Junctions"
+        << std::setw(10) << "Corridor" << std::setw(10) << "Diameter" << std::setw(10) << "Solution"
+        << std::setw(8) << "Tort." << std::setw(8) << "River" << std::setw(10) << "ms" << std::setw(8) << "Mc/s"
+        << "\n";
+
+    MazeAnalytics analytics;
+    for (int a = 0; a < MAZE_ALGORITHM_COUNT; a++) {
+        MazeAlgorithm algorithm = static_cast<MazeAlgorithm>(a);
+        Maze maze(width, height, seed);
+        maze.generate(algorithm, seed);
+        double ms = medianMillis(repetitions, [&] { analytics.analyze(maze.getGrid()); });
+        const MazeStats& stats = analytics.stats();
+
+        out << std::setw(22) << algorithmName(algorithm) << std::fixed << std::setprecision(1) << std::setw(10)
+            << 100.0 * stats.deadEnds / cells << std::setw(10) << stats.junctions << std::setw(10)
+            << std::setprecision(2) << stats.meanCorridor << std::setw(10) << stats.diameter << std::setw(10)
+            << stats.solutionLength << std::setw(8) << stats.tortuosity << std::setw(8) << stats.riverFactor
+            << std::setw(10) << ms << std::setw(8) << std::setprecision(1) << cells / ms / 1000.0 << "\n";
+    }
+
+    // Scoring throughput on small mazes: generate and analyze, one context for all
+    const int small = 32;
+    const int count = 20000;
+    Maze maze(small, small, seed);
+    double ms = medianMillis(repetitions, [&] {
+        for (int i = 0; i < count; i++) {
+            maze.generate(MazeAlgorithm::DFS, seed + static_cast<unsigned int>(i));
+            maze.analyze();
+        }
+    });
+    out << "\n" << count << " DFS mazes of " << small << "x" << small << ", generated and analyzed: "
+        << std::setprecision(1) << ms << " ms (" << std::setprecision(2) << count / ms * 3.6 << "M mazes/hour)\n"
+        << "Corridor: mean steps between cells that are not two-sided; Tort.: solution / Manhattan distance;\n"
+        << "River: mean steps from a dead end to its corridor's other end.\n";
+    out.unsetf(std::ios::floatfield);
+}
+
+/**
+ * Maze object reuse: construction, assignment, reset and pool leases
+ */
+void runPoolBenchmark(std::ostream& out, int width, int height, int cycles, unsigned int seed, int repetitions) {
+    if (width < 1 || height < 1) return;
+    if (cycles < 1) cycles = 1;
+    if (repetitions < 1) repetitions = 1;
+
+    // Mixed cycles rotate through three sizes, so reuse has to resize in place
+    const int mixedWidth[3] = {width, std::max(1, width / 2), std::max(1, width * 3 / 4)};
+    const int mixedHeight[3] = {height, std::max(1, height * 3 / 4), std::max(1, height / 2)};
+
+    out << "\nMaze reuse: " << cycles << " cycles of create, generate (DFS) and release, " << width << "x" << height
+        << " (mixed: also " << mixedWidth[1] << "x" << mixedHeight[1] << " and " << mixedWidth[2] << "x"
+        << mixedHeight[2] << "), seed " << seed << "\n";
+    out << std::string(84, '-') << "\n";
+    out << std::setw(28) << "Cycle" << std::setw(14) << "us/cycle" << std::setw(14) << "overhead us"
+        << std::setw(14) << "mixed us" << std::setw(14) << "allocs/cycle" << "\n";
+
+    Maze current(width, height, seed);
+    MazePool pool(4);
+    bool same = true;
+    uint64_t reference = 0;
+    double generateOnly = 0;
+
+    for (int c = 0; c < 5; c++) {
+        const char* names[5] = {"Generate only (no reset)", "Construct and destroy", "Assign a temporary",
+                                "Maze::reset", "MazePool lease"};
+        double micros[2] = {0, 0};
+        uint64_t allocations = 0;
+        for (int mixed = 0; mixed < 2; mixed++) {
+            if (c == 0 && mixed) break;  // Generating in place cannot change size
+            current.reset(width, height, seed);
+            MazeCounters before = mazeCounters();
+            double ms = medianMillis(repetitions, [&] {
+                for (int i = 0; i < cycles; i++) {
+                    int w = mixed ? mixedWidth[i % 3] : width;
+                    int h = mixed ? mixedHeight[i % 3] : height;
+                    unsigned int cycleSeed = seed + static_cast<unsigned int>(i);
+                    switch (c) {
+                        case 0:
+                            current.generate(MazeAlgorithm::DFS, cycleSeed);
+                            break;
+                        case 1: {
+                            Maze maze(w, h, cycleSeed);
+                            maze.generate(MazeAlgorithm::DFS, cycleSeed);
+                            if (i == cycles - 1) current = maze;
+                            break;
+                        }
+                        case 2:
+                            current = Maze(w, h, cycleSeed);
+                            current.generate(MazeAlgorithm::DFS, cycleSeed);
+                            break;
+                        case 3:
+                            current.reset(w, h, cycleSeed);
+                            current.generate(MazeAlgorithm::DFS, cycleSeed);
+                            break;
+                        case 4: {
+                            MazePool::Lease lease = pool.lease(w, h, cycleSeed);
+                            lease->generate(MazeAlgorithm::DFS, cycleSeed);
+                            if (i == cycles - 1) current = *lease;
+                            break;
+                        }
+                    }
+                }
+            });
+            if (!mixed) allocations = mazeCounters().allocations - before.allocations;
+            micros[mixed] = ms * 1000.0 / cycles;
+
+            // Every way of getting a maze must give the same walls for the same seed
+            uint64_t print = current.getGrid().fingerprint();
+            if (mixed) {
+                // Checked against a fresh maze of the last cycle's size
+                Maze check(current.getWidth(), current.getHeight(), seed + static_cast<unsigned int>(cycles - 1));
+                check.generate(MazeAlgorithm::DFS, seed + static_cast<unsigned int>(cycles - 1));
+                same = same && check.getGrid().fingerprint() == print;
+            } else if (c == 0) {
+                reference = print;
+            } else {
+                same = same && print == reference;
+            }
+        }
+        if (c == 0) generateOnly = micros[0];
+
+        out << std::setw(28) << names[c] << std::fixed << std::setprecision(2) << std::setw(14) << micros[0]
+            << std::setw(14) << micros[0] - generateOnly;
+        if (c == 0) {
+            out << std::setw(14) << "-";
+        } else {
+            out << std::setw(14) << micros[1];
+        }
+        if (MAZE_INSTRUMENTED) {
+            out << std::setw(14) << std::setprecision(1)
+                << static_cast<double>(allocations) / (static_cast<double>(cycles) * repetitions);
+        } else {
+            out << std::setw(14) << "-";
+        }
+        out << "\n";
+    }
+    out << "Pool: " << pool.created() << " mazes created, " << pool.reused() << " leases reused\n"
+        << "Same maze for a seed whichever way it was obtained: " << (same ? "yes" : "NO") << "\n";
+    if (!MAZE_INSTRUMENTED) out << "(allocation counts need `make instrument`)\n";
+    out.unsetf(std::ios::floatfield);
+}
+
+/**
+ * Live wall edits: the dynamic forest against re-running the solver and
+ * the connectivity check after every edit
+ */
+void runEditBenchmark(std::ostream& out, int width, int height, int edits, unsigned int seed) {
+    if (width < 2 || height < 2) return;
+    if (edits < 1) edits = 1;
+
+    struct Edit {
+        int x1, y1, x2, y2;
+        bool open;
+    };
+    std::mt19937 random(seed);
+    auto randomWall = [&](int& x1, int& y1, int& x2, int& y2) {
+        for (;;) {
+            x1 = static_cast<int>(random() % static_cast<unsigned int>(width));
+            y1 = static_cast<int>(random() % static_cast<unsigned int>(height));
+            bool east = random() & 1;
+            x2 = x1 + east;
+            y2 = y1 + !east;
+            if (x2 < width && y2 < height) return;
+        }
+    };
+
+    out << "\nLive wall edits: " << width << "x" << height << " DFS maze, " << edits
+        << " edits per stream, seed " << seed << "\n"
+        << "After each edit: start-end connected, shortest path length, whole maze connected\n";
+    out << std::string(94, '-') << "\n";
+    out << std::setw(26) << "Edit stream" << std::setw(12) << "Loops" << std::setw(14) << "Recompute us"
+        << std::setw(14) << "Edit us" << std::setw(10) << "Speedup" << std::setw(10) << "Searches"
+        << std::setw(8) << "Match" << "\n";
+
+    const int endX = width - 1;
+    const int endY = height - 1;
+    const char* streamNames[3] = {"Loop-free: cut and rejoin", "Braided: random toggles", "Perfect: door open/close"};
+    for (int stream = 0; stream < 3; stream++) {
+        // Stream 0 never makes a loop: each close splits the maze and the
+        // next edit opens a wall between the halves. Stream 1 braids 10% of
+        // the walls first, then toggles walls at random. Stream 2 opens a
+        // wall of the perfect maze (a shortcut, so one loop) and closes it
+        // again, as doors in a game level do.
+        Maze start(width, height, seed);
+        start.generate(MazeAlgorithm::DFS, seed);
+        if (stream == 1) {
+            for (size_t i = 0; i < start.getGrid().cellCount() / 10; i++) {
+                int x1, y1, x2, y2;
+                randomWall(x1, y1, x2, y2);
+                start.openWall(x1, y1, x2, y2);
+            }
+        }
+        const MazeGrid initial = start.getGrid();
+
+        std::vector<Edit> replay;
+        replay.reserve(static_cast<size_t>(edits));
+        Maze scratch(initial);
+        while (replay.size() < static_cast<size_t>(edits)) {
+            Edit edit;
+            if (stream == 2 && !replay.empty() && replay.back().open) {
+                edit = replay.back();
+                edit.open = false;
+                scratch.closeWall(edit.x1, edit.y1, edit.x2, edit.y2);
+                replay.push_back(edit);
+                continue;
+            }
+            randomWall(edit.x1, edit.y1, edit.x2, edit.y2);
+            edit.open = scratch.getGrid().hasWall(edit.x1, edit.y1, edit.x2 > edit.x1 ? RIGHT : BOTTOM);
+            if (stream == 2 && !edit.open) continue;
+            if (stream == 0) {
+                // Alternate: close a passage, then open a wall across the cut
+                bool rejoin = !replay.empty() && !replay.back().open;
+                if (edit.open != rejoin) continue;
+                if (rejoin && scratch.cellsConnected(edit.x1, edit.y1, edit.x2, edit.y2)) continue;
+            }
+            if (edit.open) scratch.openWall(edit.x1, edit.y1, edit.x2, edit.y2);
+            else scratch.closeWall(edit.x1, edit.y1, edit.x2, edit.y2);
+            replay.push_back(edit);
+        }
+
+        // Full recompute: what solveMaze and isMazeConnected do, without the console output
+        std::vector<long long> expected(replay.size());
+        std::vector<char> expectedConnected(replay.size());
+        MazeGrid grid = initial;
+        MazeSolver solver;
+        MazeFloodFill fill;
+        double recomputeMs = medianMillis(1, [&] {
+            for (size_t i = 0; i < replay.size(); i++) {
+                const Edit& edit = replay[i];
+                Direction dir = edit.x2 > edit.x1 ? RIGHT : BOTTOM;
+                if (edit.open) grid.removeWall(edit.x1, edit.y1, dir);
+                else grid.addWall(edit.x1, edit.y1, dir);
+                expected[i] = solver.shortestPathLength(grid, 0, 0, endX, endY);
+                expectedConnected[i] = fill.isConnected(grid);
+            }
+        });
+
+        Maze maze(initial);
+        maze.trackPath(0, 0, endX, endY);
+        maze.trackedPathLength();  // Index and first solve outside the timing
+        bool match = true;
+        double editMs = medianMillis(1, [&] {
+            for (size_t i = 0; i < replay.size(); i++) {
+                const Edit& edit = replay[i];
+                if (edit.open) maze.openWall(edit.x1, edit.y1, edit.x2, edit.y2);
+                else maze.closeWall(edit.x1, edit.y1, edit.x2, edit.y2);
+                long long length = maze.cellsConnected(0, 0, endX, endY) ? maze.trackedPathLength() : -1;
+                bool connected = maze.isMazeConnected();
+                match = match && length == expected[i] && connected == (expectedConnected[i] != 0);
+            }
+        });
+        match = match && maze.getGrid().fingerprint() == grid.fingerprint();
+
+        double recomputeUs = recomputeMs * 1000.0 / edits;
+        double editUs = editMs * 1000.0 / edits;
+        out << std::setw(26) << streamNames[stream]
+            << std::setw(12) << maze.getEditIndex().loopPassages() << std::fixed << std::setprecision(2)
+            << std::setw(14) << recomputeUs << std::setw(14) << editUs << std::setw(9) << std::setprecision(1)
+            << recomputeUs / editUs << "x" << std::setw(10) << maze.getEditIndex().replacementSearches() << std::setw(8)
+            << (match ? "yes" : "NO") << "\n";
+    }
+    out.unsetf(std::ios::floatfield);
+}
+
+/**
+ * Solver scratch layouts: the same searches with each cell order
+ */
+void runLayoutBenchmark(std::ostream& out, int width, int height, unsigned int seed, int repetitions) {
+    if (width < 1 || height < 1) return;
+    if (repetitions < 1) repetitions = 1;
+
+    struct Variant {
+        const char* name;
+        CellLayout layout;
+        bool bmi2;
+    };
+    std::vector<Variant> variants = {{"Row-major", CellLayout::ROW_MAJOR, false},
+                                     {"Morton (scalar)", CellLayout::MORTON, false}};
+    setLayoutBmi2(true);
+    const bool bmi2 = layoutUsesBmi2();
+    if (bmi2) variants.push_back({"Morton (BMI2)", CellLayout::MORTON, true});
+    variants.push_back({"Hilbert", CellLayout::HILBERT, false});
+
+    Maze maze(width, height, seed);
+    maze.generate(MazeAlgorithm::DFS, seed);
+    const MazeGrid& grid = maze.getGrid();
+    const int endX = width - 1;
+    const int endY = height - 1;
+
+    out << "\nCell layouts of the solver scratch: " << width << "x" << height << " DFS maze, seed " << seed
+        << ", BMI2 " << (bmi2 ? "available" : "not available") << "\n";
+    out << std::string(96, '-') << "\n";
+    out << std::setw(18) << "Layout" << std::setw(12) << "Fill ms" << std::setw(12) << "BFS ms" << std::setw(12)
+        << "Bidir ms" << std::setw(12) << "A* ms" << std::setw(10) << "Mc/s" << std::setw(12) << "Misses/c"
+        << std::setw(8) << "Match" << "\n";
+
+    MazeSolver solver;
+    const size_t reachable = solver.reachableCells(grid, 0, 0);
+    const long long length = solver.shortestPathLength(grid, 0, 0, endX, endY);
+    bool allMatch = true;
+    bool counted = false;
+    double rowMajorMs = 0, bestMs = 0;
+    const char* best = "";
+    for (const Variant& variant : variants) {
+        setLayoutBmi2(variant.bmi2);
+        solver.setLayout(variant.layout);
+        solver.reachableCells(grid, 0, 0);  // Scratch sized outside the timing
+
+        double fillMs = medianMillis(repetitions, [&] { solver.reachableCells(grid, 0, 0); });
+        double bfsMs = medianMillis(repetitions, [&] { solver.shortestPathLength(grid, 0, 0, endX, endY); });
+        double bidirMs = medianMillis(repetitions, [&] {
+            solver.shortestPathLength(grid, 0, 0, endX, endY, SolverMode::BIDIRECTIONAL);
+        });
+        double astarMs = medianMillis(repetitions, [&] {
+            solver.shortestPathLength(grid, 0, 0, endX, endY, SolverMode::ASTAR);
+        });
+
+        PhaseProfiler profiler;
+        profiler.begin(variant.name);
+        bool match = solver.reachableCells(grid, 0, 0) == reachable;
+        profiler.end();
+        for (int m = 0; m < 4; m++) {
+            match = match && solver.shortestPathLength(grid, 0, 0, endX, endY, static_cast<SolverMode>(m)) == length;
+        }
+        allMatch = allMatch && match;
+
+        if (variant.layout == CellLayout::ROW_MAJOR) rowMajorMs = fillMs;
+        if (bestMs == 0 || fillMs < bestMs) {
+            bestMs = fillMs;
+            best = variant.name;
+        }
+        out << std::setw(18) << variant.name << std::fixed << std::setprecision(2) << std::setw(12) << fillMs
+            << std::setw(12) << bfsMs << std::setw(12) << bidirMs << std::setw(12) << astarMs << std::setw(10)
+            << std::setprecision(1) << reachable / fillMs / 1000.0;
+        if (profiler.hardwareAvailable()) {
+            counted = true;
+            out << std::setw(12) << std::setprecision(3)
+                << profiler.phases().back().hardware.cacheMisses / static_cast<double>(reachable);
+        } else {
+            out << std::setw(12) << "-";
+        }
+        out << std::setw(8) << (match ? "yes" : "NO") << "\n";
+    }
+    setLayoutBmi2(true);
+
+    out << "Fill: all " << reachable << " reachable cells; BFS, Bidir, A*: (0, 0) to the far corner.\n"
+        << "Misses/c: cache misses per cell during one fill"
+        << (counted ? "" : " (needs an instrumented build and perf access)") << ".\n"
+        << "Fastest fill: " << best << ", " << std::setprecision(2) << rowMajorMs / bestMs
+        << "x row-major. Same results in every layout: " << (allMatch ? "yes" : "NO") << "\n";
+    out.unsetf(std::ios::floatfield);
+}
+
+namespace {
+// Compile-time fixture: generated by the compiler, checked against Maze at run time
+constexpr FixedMaze<16, 16> FIXTURE = FixedMaze<16, 16>::generated(12345);
+static_assert(FIXTURE.isConnected() && FIXTURE.countPassages() == 255, "fixture is a perfect maze");
+
+/**
+ * One row of runFixedBenchmark: `count` N x N mazes through the dynamic
+ * path and through FixedMaze<N, N>, from the same random streams
+ */
+template <int N>
+bool fixedSizeRow(std::ostream& out, int count, unsigned int seed, int repetitions) {
+    std::vector<MazeGrid> grids(static_cast<size_t>(count), MazeGrid(N, N));
+    std::vector<FixedMaze<N, N>> fixed(static_cast<size_t>(count));
+    DfsGenerator dfs;
+    MazeRandom rng(seed, RandomEngine::SPLITMIX);
+    MazeSolver solver;
+    MazeFloodFill fill;
+    long long dynamicSum = 0, fixedSum = 0;
+    size_t dynamicConnected = 0, fixedConnected = 0;
+
+    double genDynamic = medianMillis(repetitions, [&] {
+        for (int i = 0; i < count; i++) {
+            rng.seed(seed + static_cast<unsigned int>(i));
+            dfs.generate(grids[static_cast<size_t>(i)], rng);
+        }
+    });
+    double genFixed = medianMillis(repetitions, [&] {
+        for (int i = 0; i < count; i++) {
+            rng.seed(seed + static_cast<unsigned int>(i));
+            fixed[static_cast<size_t>(i)].generate(rng);
+        }
+    });
+    double bfsDynamic = medianMillis(repetitions, [&] {
+        dynamicSum = 0;
+        for (const MazeGrid& grid : grids) dynamicSum += solver.shortestPathLength(grid, 0, 0, N - 1, N - 1);
+    });
+    double bfsFixed = medianMillis(repetitions, [&] {
+        fixedSum = 0;
+        for (const FixedMaze<N, N>& maze : fixed) fixedSum += maze.shortestPathLength(0, 0, N - 1, N - 1);
+    });
+    double connDynamic = medianMillis(repetitions, [&] {
+        dynamicConnected = 0;
+        for (const MazeGrid& grid : grids) dynamicConnected += fill.isConnected(grid);
+    });
+    double connFixed = medianMillis(repetitions, [&] {
+        fixedConnected = 0;
+        for (const FixedMaze<N, N>& maze : fixed) fixedConnected += maze.isConnected();
+    });
+
+    bool match = dynamicSum == fixedSum && dynamicConnected == fixedConnected &&
+                 fixedConnected == static_cast<size_t>(count);
+    MazeGrid converted;
+    for (int i = 0; i < count && match; i++) {
+        fixed[static_cast<size_t>(i)].toGrid(converted);
+        match = converted.fingerprint() == grids[static_cast<size_t>(i)].fingerprint();
+    }
+
+    auto ns = [count](double ms) { return ms * 1e6 / count; };
+    out << std::setw(8) << (std::to_string(N) + "x" + std::to_string(N)) << std::fixed << std::setprecision(0)
+        << std::setw(11) << ns(genDynamic) << std::setw(11) << ns(genFixed) << std::setw(7) << std::setprecision(2)
+        << genDynamic / genFixed << "x" << std::setprecision(0) << std::setw(11) << ns(bfsDynamic) << std::setw(11)
+        << ns(bfsFixed) << std::setw(7) << std::setprecision(2) << bfsDynamic / bfsFixed << "x"
+        << std::setprecision(0) << std::setw(11) << ns(connDynamic) << std::setw(11) << ns(connFixed)
+        << std::setw(7) << std::setprecision(2) << connDynamic / connFixed << "x" << std::setw(7)
+        << (match ? "yes" : "NO") << "\n";
+    return match;
+}
+}
+
+/**
+ * FixedMaze against MazeGrid with the shared generator, solver and flood fill
+ */
+void runFixedBenchmark(std::ostream& out, int count, unsigned int seed, int repetitions) {
+    if (count < 1) count = 1;
+    if (repetitions < 1) repetitions = 1;
+
+    out << "\nCompile-time sizes: " << count << " DFS mazes per size, seeds " << seed << "+, SplitMix stream\n"
+        << "Nanoseconds per maze: DFS generation, corner-to-corner BFS length, connectivity check\n";
+    out << std::string(104, '-') << "\n";
+    out << std::setw(8) << "Size" << std::setw(11) << "Gen dyn" << std::setw(11) << "Gen fixed" << std::setw(8)
+        << "Speedup" << std::setw(11) << "BFS dyn" << std::setw(11) << "BFS fixed" << std::setw(8) << "Speedup"
+        << std::setw(11) << "Conn dyn" << std::setw(11) << "Conn fixed" << std::setw(8) << "Speedup"
+        << std::setw(7) << "Match" << "\n";
+
+    bool allMatch = fixedSizeRow<16>(out, count, seed, repetitions);
+    allMatch = fixedSizeRow<32>(out, count, seed, repetitions) && allMatch;
+    allMatch = fixedSizeRow<64>(out, count, seed, repetitions) && allMatch;
+
+    Maze reference(16, 16, 12345);
+    reference.setRandomEngine(RandomEngine::SPLITMIX);
+    reference.generate(MazeAlgorithm::DFS, 12345);
+    FixedMaze<16, 16> loaded;
+    bool fixture = loaded.fromMaze(reference) && loaded == FIXTURE;
+    out << "Dynamic: MazeGrid + DfsGenerator / MazeSolver / MazeFloodFill, scratch reused.\n"
+        << "Same mazes, lengths and connectivity: " << (allMatch ? "yes" : "NO")
+        << "; compile-time 16x16 fixture matches Maze: " << (fixture ? "yes" : "NO") << "\n";
+    out.unsetf(std::ios::floatfield);
+}
+
+/**
+ * Batched distance queries: spawn-point style fields and pairs
+ */
+void runMultiSourceBenchmark(std::ostream& out, int width, int height, int sources, int pairs, int maxThreads,
+                             unsigned int seed, int repetitions) {
+    if (width < 1 || height < 1) return;
+    if (sources < 1) sources = 1;
+    if (pairs < 1) pairs = 1;
+    if (maxThreads < 1) maxThreads = 1;
+    if (repetitions < 1) repetitions = 1;
+
+    std::vector<int> threadCounts;
+    for (int t = 1; t < maxThreads; t *= 2) threadCounts.push_back(t);
+    threadCounts.push_back(maxThreads);
+    std::vector<std::unique_ptr<ThreadPool>> pools;
+    for (int threads : threadCounts) pools.emplace_back(new ThreadPool(threads));
+
+    const size_t cells = static_cast<size_t>(width) * height;
+    std::mt19937 random(seed);
+    std::vector<uint32_t> candidates(static_cast<size_t>(sources));
+    for (uint32_t& cell : candidates) cell = static_cast<uint32_t>(random() % cells);
+    // Pairs start at the candidate cells, as when scoring spawn points
+    std::vector<MazeMultiBfs::Query> queries(static_cast<size_t>(pairs));
+    for (MazeMultiBfs::Query& query : queries) {
+        query.start = candidates[random() % candidates.size()];
+        query.end = static_cast<uint32_t>(random() % cells);
+    }
+
+    out << "\nBatched distance queries: " << width << "x" << height << " mazes, " << sources
+        << " source cells, " << pairs << " pairs from them, seed " << seed << ", "
+        << std::max(1u, std::thread::hardware_concurrency()) << " hardware threads\n";
+    out << std::string(100, '-') << "\n";
+    out << std::setw(10) << "Maze" << std::setw(9) << "Queries" << std::setw(20) << "Method" << std::setw(9)
+        << "Threads" << std::setw(12) << "ms" << std::setw(14) << "Queries/s" << std::setw(10) << "Speedup"
+        << std::setw(9) << "Exp/bfs" << std::setw(7) << "Match" << "\n";
+
+    bool allMatch = true;
+    for (int braided = 0; braided < 2; braided++) {
+        Maze maze(width, height, seed);
+        maze.generate(MazeAlgorithm::DFS, seed);
+        MazeGrid grid = maze.getGrid();
+        if (braided) {
+            // Open 10% of the walls: loops, so wavefronts meet and merge
+            for (size_t i = 0; i < cells / 10; i++) {
+                int x = static_cast<int>(random() % static_cast<unsigned int>(width));
+                int y = static_cast<int>(random() % static_cast<unsigned int>(height));
+                Direction dir = (random() & 1) ? RIGHT : BOTTOM;
+                if ((dir == RIGHT && x + 1 < width) || (dir == BOTTOM && y + 1 < height)) grid.removeWall(x, y, dir);
+            }
+        }
+        const char* mazeName = braided ? "Braided" : "Perfect";
+        // expandRatio < 0: not a breadth-first batch, no expansion count
+        auto row = [&](const char* workload, const char* method, int threads, double ms, size_t count,
+                       double baselineMs, double expandRatio, bool match) {
+            out << std::setw(10) << mazeName << std::setw(9) << workload << std::setw(20) << method << std::setw(9)
+                << threads << std::fixed << std::setprecision(2) << std::setw(12) << ms << std::setprecision(0)
+                << std::setw(14) << count / (ms / 1000.0) << std::setprecision(1) << std::setw(9)
+                << baselineMs / ms << "x" << std::setprecision(2) << std::setw(9);
+            if (expandRatio < 0) out << "-";
+            else out << expandRatio;
+            out << std::setw(7) << (match ? "yes" : "NO") << "\n";
+            allMatch = allMatch && match;
+        };
+        auto kernelName = [](BatchKernel kernel) {
+            return kernel == BatchKernel::PER_SOURCE ? "Batched BFS" : "Bit-parallel BFS";
+        };
+        const BatchKernel kernels[2] = {BatchKernel::PER_SOURCE, BatchKernel::BIT_PARALLEL};
+        // Sources reach only their own component, so count expansions against reachable cells
+        size_t reachableSum = 0;
+
+        // Distance fields: one BFS per source, copied into the same flat layout
+        std::vector<uint32_t> expected(candidates.size() * cells);
+        MazeDistanceField field;
+        double fieldsMs = medianMillis(1, [&] {
+            for (size_t i = 0; i < candidates.size(); i++) {
+                field.compute(grid, static_cast<int>(candidates[i] % width), static_cast<int>(candidates[i] / width));
+                std::copy(field.getDistances().begin(), field.getDistances().end(), expected.begin() + i * cells);
+            }
+        });
+        for (size_t i = 0; i < expected.size(); i++) reachableSum += expected[i] != MazeMultiBfs::UNREACHED;
+        row("Fields", "BFS per source", 1, fieldsMs, candidates.size(), fieldsMs, -1, true);
+
+        MazeMultiBfs batch;
+        std::vector<uint32_t> fields;
+        for (BatchKernel kernel : kernels) {
+            batch.setKernel(kernel);
+            for (size_t p = 0; p < pools.size(); p++) {
+                batch.distanceFields(grid, candidates, fields, *pools[p]);  // Scratch sized outside the timing
+                double ms = medianMillis(repetitions, [&] { batch.distanceFields(grid, candidates, fields, *pools[p]); });
+                row("Fields", kernelName(kernel), threadCounts[p], ms, candidates.size(), fieldsMs,
+                    static_cast<double>(batch.expansions()) / reachableSum, fields == expected);
+            }
+        }
+        expected = std::vector<uint32_t>();
+        fields = std::vector<uint32_t>();
+
+        // Pairs: one early-exit BFS per pair, as solveMaze does
+        std::vector<uint32_t> expectedLengths(queries.size());
+        MazeSolver solver;
+        double pairsMs = medianMillis(1, [&] {
+            for (size_t i = 0; i < queries.size(); i++) {
+                long long length = solver.shortestPathLength(
+                    grid, static_cast<int>(queries[i].start % width), static_cast<int>(queries[i].start / width),
+                    static_cast<int>(queries[i].end % width), static_cast<int>(queries[i].end / width));
+                expectedLengths[i] = length < 0 ? MazeMultiBfs::UNREACHED : static_cast<uint32_t>(length);
+            }
+        });
+        row("Pairs", "BFS per pair", 1, pairsMs, queries.size(), pairsMs, -1, true);
+
+        std::vector<uint32_t> lengths;
+        for (int method = 0; method < 3; method++) {
+            const bool tree = method == 2;
+            batch.setTreeIndex(tree);
+            if (!tree) batch.setKernel(kernels[method]);
+            for (size_t p = 0; p < pools.size(); p++) {
+                batch.pairLengths(grid, queries, lengths, *pools[p]);
+                if (tree && !batch.usedTreeIndex()) break;  // Only perfect mazes have one
+                double ms = medianMillis(repetitions, [&] { batch.pairLengths(grid, queries, lengths, *pools[p]); });
+                row("Pairs", tree ? "Tree index" : kernelName(kernels[method]), threadCounts[p], ms, queries.size(),
+                    pairsMs, -1, lengths == expectedLengths);
+            }
+        }
+    }
+    out << "Exp/bfs: cells expanded per source and reachable cell (1.00 = no sharing; below 1\n"
+        << "when wavefronts of several sources move together). Tree index includes its build.\n"
+        << "All methods give the same distances: " << (allMatch ? "yes" : "NO") << "\n";
+    out.unsetf(std::ios::floatfield);
+}
+
+bool parseBenchmarkFormat(const std::string& name, BenchmarkFormat& format) {
+    if (name == "table") format = BenchmarkFormat::TABLE;
+    else if (name == "csv") format = BenchmarkFormat::CSV;
+    else if (name == "json") format = BenchmarkFormat::JSON;
+    else return false;
+    return true;
+}
+
+namespace {
+/**
+ * Stream buffer that only counts bytes, so rendering is timed without
+ * the cost of a destination
+ */
+class CountingBuffer : public std::streambuf {
+public:
+    size_t bytes = 0;
+
+protected:
+    std::streamsize xsputn(const char*, std::streamsize count) override {
+        bytes += static_cast<size_t>(count);
+        return count;
+    }
+    int_type overflow(int_type c) override {
+        if (!traits_type::eq_int_type(c, traits_type::eof())) bytes++;
+        return traits_type::not_eof(c);
+    }
+};
+
+/**
+ * One finished case of the suite
+ */
+struct SuiteResult {
+    SuiteResult(const char* operation, const char* variant, int width, int height)
+        : operation(operation), variant(variant), width(width), height(height) {}
+
+    const char* operation;
+    const char* variant;
+    int width;
+    int height;
+    int samples = 0;
+    long long batch = 1;  // Operations per timed sample
+    double minMs = 0, p10Ms = 0, medianMs = 0, p90Ms = 0, maxMs = 0;
+    double bytesPerCell = 0;
+};
+
+/**
+ * Warm up, size the batch, then take samples within the time budget.
+ * Fills the timing fields of `result` (per operation).
+ */
+template <typename Fn>
+void measureCase(const BenchmarkSuiteOptions& options, SuiteResult& result, Fn fn) {
+    using Clock = std::chrono::steady_clock;
+    auto millisSince = [](Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    };
+
+    double probeMs = 0;
+    for (int i = 0; i < options.warmup; i++) {
+        auto start = Clock::now();
+        fn();
+        probeMs = millisSince(start);
+    }
+    long long batch = 1;
+    if (options.warmup > 0 && probeMs < options.minSampleMs) {
+        batch = std::min<long long>(1000000, static_cast<long long>(options.minSampleMs / std::max(probeMs, 1e-6)) + 1);
+    }
+
+    std::vector<double> samples;
+    const int wanted = std::max(options.repetitions, 1);
+    const int minimum = std::min(std::max(options.minRepetitions, 1), wanted);
+    double spentMs = 0;
+    while (static_cast<int>(samples.size()) < wanted &&
+           (static_cast<int>(samples.size()) < minimum || spentMs < options.budgetMs)) {
+        auto start = Clock::now();
+        for (long long i = 0; i < batch; i++) fn();
+        double ms = millisSince(start);
+        spentMs += ms;
+        samples.push_back(ms / static_cast<double>(batch));
+    }
+
+    std::sort(samples.begin(), samples.end());
+    result.samples = static_cast<int>(samples.size());
+    result.batch = batch;
+    result.minMs = samples.front();
+    result.p10Ms = percentile(samples, 10);
+    result.medianMs = percentile(samples, 50);
+    result.p90Ms = percentile(samples, 90);
+    result.maxMs = samples.back();
+}
+
+void writeSuiteHeader(std::ostream& out, const BenchmarkSuiteOptions& options) {
+    switch (options.format) {
+        case BenchmarkFormat::TABLE:
+            out << "\nMaze benchmark suite: seed " << options.seed << ", " << options.warmup << " warm-up, "
+                << options.minRepetitions << ".." << options.repetitions << " samples, "
+                << options.budgetMs << " ms budget per case\n";
+            out << std::left << std::setw(24) << "Case" << std::right << std::setw(13) << "Size"
+                << std::setw(8) << "Samples" << std::setw(12) << "Median ms" << std::setw(12) << "p10 ms"
+                << std::setw(12) << "p90 ms" << std::setw(11) << "Mcells/s" << std::setw(9) << "B/cell" << "\n";
+            out << std::string(101, '-') << "\n";
+            break;
+        case BenchmarkFormat::CSV:
+            out << "operation,variant,width,height,cells,samples,batch,min_ms,p10_ms,median_ms,p90_ms,max_ms,"
+                << "mcells_per_s,bytes_per_cell\n";
+            break;
+        case BenchmarkFormat::JSON:
+            out << "{\"seed\":" << options.seed << ",\"warmup\":" << options.warmup
+                << ",\"repetitions\":" << options.repetitions << ",\"min_repetitions\":" << options.minRepetitions
+                << ",\"budget_ms\":" << options.budgetMs << ",\"min_sample_ms\":" << options.minSampleMs
+                << ",\"results\":[";
+            break;
+    }
+}
+
+void writeSuiteRow(std::ostream& out, BenchmarkFormat format, const SuiteResult& r, bool first) {
+    const double cells = static_cast<double>(r.width) * r.height;
+    const double mcellsPerSecond = r.medianMs > 0 ? cells / r.medianMs / 1000.0 : 0;
+    out << std::fixed << std::setprecision(4);
+    switch (format) {
+        case BenchmarkFormat::TABLE: {
+            std::string name = std::string(r.operation) + "/" + r.variant;
+            std::string size = std::to_string(r.width) + "x" + std::to_string(r.height);
+            out << std::left << std::setw(24) << name << std::right << std::setw(13) << size
+                << std::setw(8) << r.samples << std::setw(12) << r.medianMs << std::setw(12) << r.p10Ms
+                << std::setw(12) << r.p90Ms << std::setw(11) << std::setprecision(2) << mcellsPerSecond
+                << std::setw(9) << r.bytesPerCell << "\n";
+            break;
+        }
+        case BenchmarkFormat::CSV:
+            out << r.operation << "," << r.variant << "," << r.width << "," << r.height << ","
+                << static_cast<unsigned long long>(cells) << "," << r.samples << "," << r.batch << ","
+                << r.minMs << "," << r.p10Ms << "," << r.medianMs << "," << r.p90Ms << "," << r.maxMs << ","
+                << mcellsPerSecond << "," << r.bytesPerCell << "\n";
+            break;
+        case BenchmarkFormat::JSON:
+            out << (first ? "\n" : ",\n") << "{\"operation\":\"" << r.operation << "\",\"variant\":\"" << r.variant
+                << "\",\"width\":" << r.width << ",\"height\":" << r.height
+                << ",\"cells\":" << static_cast<unsigned long long>(cells) << ",\"samples\":" << r.samples
+                << ",\"batch\":" << r.batch << ",\"min_ms\":" << r.minMs << ",\"p10_ms\":" << r.p10Ms
+                << ",\"median_ms\":" << r.medianMs << ",\"p90_ms\":" << r.p90Ms << ",\"max_ms\":" << r.maxMs
+                << ",\"mcells_per_s\":" << mcellsPerSecond << ",\"bytes_per_cell\":" << r.bytesPerCell << "}";
+            break;
+    }
+    out.unsetf(std::ios::floatfield);
+    out.flush();
+}
+}
+
+/**
+ * Every case at every size, one fixed seed throughout
+ */
+bool runBenchmarkSuite(std::ostream& out, const BenchmarkSuiteOptions& options) {
+    static const char* const SOLVER_KEYS[SOLVER_MODE_COUNT] = {"bfs", "bidirectional", "astar", "deadend"};
+    const unsigned int seed = options.seed;
+    bool first = true;
+    bool fileCases = true;
+    writeSuiteHeader(out, options);
+
+    auto wanted = [&](const char* operation, const char* variant) {
+        return options.filter.empty() ||
+               (std::string(operation) + "/" + variant).find(options.filter) != std::string::npos;
+    };
+    auto report = [&](SuiteResult& result) {
+        writeSuiteRow(out, options.format, result, first);
+        first = false;
+    };
+
+    for (unsigned long long cells = 100; cells <= options.maxCells; cells *= 10) {
+        if (cells < options.minCells) continue;
+        int width = static_cast<int>(std::llround(std::sqrt(static_cast<double>(cells))));
+        int height = static_cast<int>(std::llround(static_cast<double>(cells) / width));
+        const double cellCount = static_cast<double>(width) * height;
+
+        // Generation: a fresh engine per algorithm, so scratch is not shared
+        // between cases and peak memory stays at one algorithm's worth
+        MazeGrid grid(width, height);
+        MazeRandom rng;
+        for (int a = 0; a < MAZE_ALGORITHM_COUNT; a++) {
+            MazeAlgorithm algorithm = static_cast<MazeAlgorithm>(a);
+            if (!wanted("generate", algorithmKey(algorithm))) continue;
+            MazeGeneratorEngine engine;
+            SuiteResult result("generate", algorithmKey(algorithm), width, height);
+            measureCase(options, result, [&] {
+                rng.seed(seed);
+                engine.generate(algorithm, grid, rng);
+            });
+            result.bytesPerCell = static_cast<double>(grid.memoryBytes() + engine.memoryBytes()) / cellCount;
+            report(result);
+        }
+
+        // Everything else runs on one DFS maze
+        {
+            MazeGeneratorEngine engine;
+            rng.seed(seed);
+            engine.generate(MazeAlgorithm::DFS, grid, rng);
+        }
+
+        MazeSolver solver;
+        for (int m = 0; m < SOLVER_MODE_COUNT; m++) {
+            if (!wanted("solve", SOLVER_KEYS[m])) continue;
+            SolverMode mode = static_cast<SolverMode>(m);
+            SuiteResult result("solve", SOLVER_KEYS[m], width, height);
+            measureCase(options, result, [&] {
+                solver.shortestPathLength(grid, 0, 0, width - 1, height - 1, mode);
+            });
+            result.bytesPerCell = static_cast<double>(solver.memoryBytes()) / cellCount;
+            report(result);
+        }
+
+        if (wanted("check", "connectivity")) {
+            MazeFloodFill checker;
+            SuiteResult result("check", "connectivity", width, height);
+            measureCase(options, result, [&] { checker.fill(grid, 0, 0); });
+            result.bytesPerCell = static_cast<double>(checker.memoryBytes()) / cellCount;
+            report(result);
+        }
+
+        // Rendering into a byte counter: formatting cost only
+        const char* const RENDER_KEYS[3] = {"box", "ascii", "pgm"};
+        for (int f = 0; f < 3; f++) {
+            if (!wanted("render", RENDER_KEYS[f])) continue;
+            CountingBuffer counter;
+            std::ostream sinkStream(&counter);
+            SuiteResult result("render", RENDER_KEYS[f], width, height);
+            measureCase(options, result, [&] {
+                counter.bytes = 0;
+                std::unique_ptr<MazeRowSink> sink;
+                if (f == 0) sink.reset(new BoxDrawingSink(sinkStream));
+                else if (f == 1) sink.reset(new AsciiSink(sinkStream));
+                else sink.reset(new RasterSink(sinkStream, RasterOptions()));
+                sink->begin(width, height, seed);
+                for (int y = 0; y < height; y++) sink->row(grid.eastRow(y), grid.southRow(y));
+                sink->end();
+            });
+            result.bytesPerCell = static_cast<double>(counter.bytes) / cellCount;
+            report(result);
+        }
+
+        MazeOrigin origin;
+        origin.seed = seed;
+        origin.replayable = true;
+        const bool saveWanted = wanted("file", "save");
+        const bool loadWanted = wanted("file", "load");
+        if (fileCases && (saveWanted || loadWanted)) {
+            MazeFileStatus status = MazeFileStatus::OK;
+            SuiteResult save("file", "save", width, height);
+            measureCase(options, save, [&] { status = writeMazeFile(options.scratchPath, grid, origin); });
+            save.bytesPerCell = static_cast<double>(MAZE_FILE_HEADER_BYTES + 16 * grid.getPlaneWords()) / cellCount;
+            if (status != MazeFileStatus::OK) {
+                std::remove(options.scratchPath.c_str());
+                fileCases = false;
+                continue;
+            }
+            if (saveWanted) report(save);
+
+            if (loadWanted) {
+                SuiteResult load("file", "load", width, height);
+                measureCase(options, load, [&] {
+                    MappedMazeFile file;
+                    status = file.open(options.scratchPath, true);
+                });
+                load.bytesPerCell = save.bytesPerCell;
+                report(load);
+            }
+            std::remove(options.scratchPath.c_str());
+        }
+    }
+
+    if (options.format == BenchmarkFormat::JSON) out << "\n]}\n";
+    out.flush();
+    return fileCases;
+}
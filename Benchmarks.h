@@ -0,0 +1,189 @@
+#ifndef BENCHMARKS_H
+#define BENCHMARKS_H
+
+#include <ostream>
+#include <string>
+
+/**
+ * Speedup of tiled parallel generation for 1, 2, 4, ... maxThreads
+ * threads (median of `repetitions` runs each), compared with the
+ * single-threaded iterative generator. Also reports whether every thread
+ * count produced the same maze.
+ */
+void runParallelScalingBenchmark(std::ostream& out, int width, int height, int tileSize,
+                                 int maxThreads, unsigned int seed, int repetitions = 3);
+
+/**
+ * Throughput of MazeBatch (count mazes of width x height in one arena on
+ * `threads` threads) against a plain loop constructing a Maze and calling
+ * generateMazeIterative() for each. Reports mazes/second and p50/p99
+ * per-maze latency for both.
+ */
+void runBatchBenchmark(std::ostream& out, int width, int height, size_t count, int threads,
+                       unsigned int seed);
+
+/**
+ * Point-to-point solver comparison on one width x height DFS maze: the
+ * far-corner query plus `queries` random pairs, solved with every
+ * SolverMode. Reports time and nodes expanded per query and checks that
+ * every mode finds the same path lengths as BFS.
+ */
+void runSolverBenchmark(std::ostream& out, int width, int height, int queries, unsigned int seed);
+
+/**
+ * MazeTreeIndex on one width x height DFS maze: build time and memory,
+ * then `queries` random distance queries (path extraction on up to 1000
+ * of them) against repeated BFS (BFS runs on at most `bfsQueries` of
+ * them and must agree).
+ */
+void runTreeIndexBenchmark(std::ostream& out, int width, int height, int queries, int bfsQueries,
+                           unsigned int seed);
+
+/**
+ * Text rendering throughput (box drawing and ASCII) of one width x height
+ * maze, into a reused string and through an ostream, in MB/s, next to
+ * the time it took to generate the maze.
+ */
+void runRenderBenchmark(std::ostream& out, int width, int height, unsigned int seed, int repetitions = 3);
+
+/**
+ * Maze files: save a width x height DFS maze to `path`, then compare
+ * loading it (mapped, with and without checksum verification) against
+ * regenerating it from its seed. Checks that the loaded maze matches and
+ * solves the same, and that a flipped byte is caught. Removes the file.
+ */
+void runFileBenchmark(std::ostream& out, int width, int height, unsigned int seed, const std::string& path,
+                      int repetitions = 3);
+
+/**
+ * Reachability from (0, 0) for every algorithm's maze: the former stack
+ * DFS over the visited plane, MazeSolver::reachableCells (BFS) and
+ * MazeFloodFill with scalar and AVX2 blocks. Counts are cross-checked.
+ */
+void runConnectivityBenchmark(std::ostream& out, int width, int height, unsigned int seed, int repetitions = 3);
+
+/**
+ * MazeRandom engines compared: draws/second one at a time and in bulk
+ * (AVX2 and scalar kernels), seeding cost, generation throughput of a
+ * few algorithms on a width x height maze, and MazeBatch throughput on
+ * 16x16 mazes.
+ */
+void runRandomBenchmark(std::ostream& out, int width, int height, unsigned int seed, int repetitions = 3);
+
+/**
+ * MazeParallelBfs distance fields from (0, 0) for every algorithm's maze
+ * on 1, 2, 4, ... maxThreads threads, against MazeSolver's serial BFS
+ * over the same cells. Checks that every thread count gives the same
+ * field and that point queries give MazeSolver's lengths.
+ */
+void runParallelBfsBenchmark(std::ostream& out, int width, int height, int maxThreads, unsigned int seed,
+                             int repetitions = 3);
+
+/**
+ * MazeAnalytics on every algorithm's maze: dead ends, junctions, mean
+ * corridor, diameter, solution length and shape, river factor and the
+ * time per analysis; then generate-and-analyze throughput on 32x32 mazes.
+ */
+void runAnalyticsBenchmark(std::ostream& out, int width, int height, unsigned int seed, int repetitions = 3);
+
+/**
+ * Cost of getting a fresh maze, `cycles` times: generating in place
+ * (the floor), constructing and destroying a Maze, assigning a temporary
+ * (the old menu code), Maze::reset and a MazePool lease, each followed by
+ * DFS generation. Also with sizes changing every cycle, and allocations
+ * per cycle in instrumented builds. Checks the mazes match per seed.
+ */
+void runPoolBenchmark(std::ostream& out, int width, int height, int cycles, unsigned int seed, int repetitions = 3);
+
+/**
+ * Live wall edits on a DFS maze, `edits` per stream: after every edit,
+ * whether start and end are connected, the shortest path length and
+ * whether the whole maze is connected. Full recompute (solver and flood
+ * fill, as solveMaze and isMazeConnected) against Maze::openWall /
+ * closeWall with the dynamic forest, on a loop-free stream, on a braided
+ * maze with random toggles and on a perfect maze whose doors are opened
+ * and closed again. Checks both give the same answers.
+ */
+void runEditBenchmark(std::ostream& out, int width, int height, int edits, unsigned int seed);
+
+/**
+ * The solver on a DFS maze with each CellLayout of its scratch (Morton
+ * with and without BMI2): a full flood fill, then corner-to-corner BFS,
+ * bidirectional BFS and A*. Cache misses per cell where the hardware
+ * counters can be read (see PhaseProfiler). Checks that every layout gives
+ * the same results.
+ */
+void runLayoutBenchmark(std::ostream& out, int width, int height, unsigned int seed, int repetitions = 3);
+
+/**
+ * FixedMaze<N, N> against the dynamic path (MazeGrid with DfsGenerator,
+ * MazeSolver and MazeFloodFill) at 16, 32 and 64: DFS generation,
+ * corner-to-corner BFS and the connectivity check over `count` mazes per
+ * size. Checks both give the same mazes and answers, and that a
+ * compile-time fixture matches Maze.
+ */
+void runFixedBenchmark(std::ostream& out, int count, unsigned int seed, int repetitions = 3);
+
+/**
+ * MazeMultiBfs on a width x height DFS maze and the same maze braided:
+ * distance fields from `sources` random cells and `pairs` random queries
+ * starting at those cells, with both kernels on 1, 2, 4, ... maxThreads
+ * threads, against one BFS per source (MazeDistanceField) and per pair
+ * (MazeSolver), plus the tree index for pairs on the perfect maze.
+ * Reports queries/second and how much the bit-parallel kernel shared, and
+ * checks every method gives the same distances.
+ */
+void runMultiSourceBenchmark(std::ostream& out, int width, int height, int sources, int pairs, int maxThreads,
+                             unsigned int seed, int repetitions = 3);
+
+/**
+ * Output formats of the benchmark suite
+ */
+enum class BenchmarkFormat {
+    TABLE,  // Aligned columns for reading
+    CSV,    // Header line, then one line per case
+    JSON    // One object: settings plus a "results" array
+};
+
+/**
+ * Parse "table", "csv" or "json"; false for anything else
+ */
+bool parseBenchmarkFormat(const std::string& name, BenchmarkFormat& format);
+
+/**
+ * Settings of runBenchmarkSuite()
+ *
+ * Every case is run `warmup` times untimed, then timed in samples until
+ * `repetitions` samples exist or, once `minRepetitions` are in, the case
+ * has used `budgetMs`. A sample repeats the operation enough times to
+ * last at least `minSampleMs`, so tiny mazes are not timed at the clock's
+ * resolution; reported times are per operation.
+ */
+struct BenchmarkSuiteOptions {
+    unsigned long long minCells = 100;          // Sizes are 10^k cells, square-ish,
+    unsigned long long maxCells = 100000000;    // for every 10^k in [minCells, maxCells]
+    int warmup = 1;
+    int repetitions = 21;
+    int minRepetitions = 3;
+    double budgetMs = 2000;
+    double minSampleMs = 1;
+    unsigned int seed = 12345;
+    BenchmarkFormat format = BenchmarkFormat::TABLE;
+    std::string filter;                         // Only cases whose name contains this
+    std::string scratchPath = "maze_bench.tmp"; // Written and removed by the file cases
+};
+
+/**
+ * Reproducible benchmark suite over maze sizes from options.minCells to
+ * options.maxCells: generation with every algorithm, every solver mode
+ * (far-corner query), the connectivity check, box/ASCII/PGM rendering
+ * and maze file save/load. Each case reports min, p10, median, p90 and
+ * max milliseconds, cells/second at the median and bytes per cell (the
+ * working memory for generation, solving and the check; the output size
+ * for rendering and files). Rows are written as each case finishes.
+ * Returns false if the file cases had to be skipped because
+ * options.scratchPath could not be written.
+ */
+bool runBenchmarkSuite(std::ostream& out, const BenchmarkSuiteOptions& options);
+
+#endif // BENCHMARKS_H
@@ -0,0 +1,448 @@
+#ifndef FIXED_MAZE_H
+#define FIXED_MAZE_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Maze.h"
+#include "MazeGrid.h"
+#include "MazeRandom.h"
+
+/**
+ * SplitMix64 stream usable in constant expressions
+ *
+ * Yields exactly the values of MazeRandom with RandomEngine::SPLITMIX
+ * (the low, then the high half of each 64-bit output), so a maze
+ * generated at compile time matches the same seed generated at run time.
+ */
+class FixedRandom {
+public:
+    using result_type = uint32_t;
+
+    constexpr explicit FixedRandom(uint64_t seed) : streamSeed(seed) {}
+
+    constexpr result_type operator()() {
+        if (high) {
+            high = false;
+            return static_cast<uint32_t>(value >> 32);
+        }
+        value = splitMixAt(streamSeed, index++);
+        high = true;
+        return static_cast<uint32_t>(value);
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return 0xFFFFFFFFu; }
+
+private:
+    uint64_t streamSeed;
+    uint64_t index = 0;
+    uint64_t value = 0;
+    bool high = false;
+};
+
+/**
+ * Maze of a size fixed at compile time (16x16, 32x32, 64x64 and the like)
+ *
+ * The walls are one std::array of two bit planes, so a FixedMaze has no
+ * heap allocation and is a literal type. Generation (the iterative DFS of
+ * DfsGenerator), BFS and the connectivity check are constexpr: they can
+ * build test fixtures at compile time and still run at full speed at run
+ * time, with all sizes and masks folded into the code.
+ *
+ * Each plane is dense and word-aligned: bit c is the east (south) wall of
+ * cell c = y * W + x. Padding words before each plane are always set, as
+ * are the outer border walls, so no kernel tests for the border: the wall
+ * of c in direction d is bit c + WALL_BIT[d] of the array (the west wall
+ * of column 0 reads the east border of the row before, the north wall of
+ * row 0 the padding). When W divides 64 a word holds whole rows, and the
+ * connectivity check fills a word of rows at a time like MazeFloodFill.
+ *
+ * generate(rng) consumes the stream exactly as DfsGenerator does, so with
+ * the same MazeRandom (or FixedRandom for SplitMix) it produces the same
+ * maze as Maze::generate(MazeAlgorithm::DFS). Paths are cell indices
+ * y * W + x, as in Maze.
+ */
+template <int W, int H>
+class FixedMaze {
+    static_assert(W > 0 && H > 0, "FixedMaze needs a positive size");
+    static_assert(W * H <= 65536, "FixedMaze is for small mazes (16-bit cell indices); use Maze");
+
+public:
+    static constexpr int WIDTH = W;
+    static constexpr int HEIGHT = H;
+    static constexpr int CELLS = W * H;
+
+    constexpr FixedMaze() { reset(); }
+
+    /**
+     * DFS maze for `seed` with the SplitMix stream; usable for constexpr
+     * fixtures. Same as Maze::generate(DFS, seed) with RandomEngine::SPLITMIX.
+     */
+    static constexpr FixedMaze generated(uint64_t seed) {
+        FixedMaze maze;
+        FixedRandom rng(seed);
+        maze.generate(rng);
+        return maze;
+    }
+
+    /**
+     * Every wall up
+     */
+    constexpr void reset() {
+        for (uint64_t& word : walls) word = ~0ULL;
+    }
+
+    /**
+     * Iterative DFS from (0, 0), following DfsGenerator's reference
+     * sequence draw for draw. Apart from backtracking, a step has no
+     * data-dependent branch: the visited plane is padded by a row on each
+     * side, the border comes from a compile-time mask, and the chosen
+     * direction from a table.
+     */
+    template <class Rng>
+    constexpr void generate(Rng& rng) {
+        reset();
+        Bits<CELLS + 2 * W> visited{};  // Bit cell + W
+        std::array<Index, CELLS> stack{};
+        size_t top = 0;
+        Index cell = 0;
+        set(visited, W);
+        stack[top++] = 0;
+
+        while (true) {
+            const size_t at = cell + static_cast<size_t>(W);
+            unsigned mask = NEIGHBOURS[cell] & ((!test(visited, at - W) ? 1u << TOP : 0u) |
+                                                (!test(visited, at + 1) ? 1u << RIGHT : 0u) |
+                                                (!test(visited, at + W) ? 1u << BOTTOM : 0u) |
+                                                (!test(visited, at - 1) ? 1u << LEFT : 0u));
+
+            if (mask) {
+                uint64_t r = rng();
+                unsigned k = static_cast<unsigned>((r * static_cast<unsigned>(__builtin_popcount(mask))) >> 32);
+                unsigned dir = PICK[mask][k];
+                clear(walls, cell + WALL_BIT[dir]);
+                cell = static_cast<Index>(cell + STEP[dir]);
+                set(visited, cell + static_cast<size_t>(W));
+                stack[top++] = cell;
+            } else {
+                if (--top == 0) break;
+                cell = stack[top - 1];
+            }
+        }
+    }
+
+    static constexpr bool inBounds(int x, int y) { return x >= 0 && x < W && y >= 0 && y < H; }
+
+    /**
+     * Bitmask (1 << Direction) of the directions without a wall
+     */
+    constexpr unsigned openDirections(int x, int y) const { return openAt(cellIndex(x, y)); }
+
+    constexpr bool hasWall(int x, int y, Direction dir) const { return !(openDirections(x, y) & (1u << dir)); }
+
+    /**
+     * Open / put back the wall between (x, y) and its neighbour in dir.
+     * Border walls are never removed.
+     */
+    constexpr void removeWall(int x, int y, Direction dir) {
+        if (inBounds(x, y) && (NEIGHBOURS[cellIndex(x, y)] & (1u << dir))) {
+            clear(walls, cellIndex(x, y) + WALL_BIT[dir]);
+        }
+    }
+    constexpr void addWall(int x, int y, Direction dir) {
+        if (inBounds(x, y) && (NEIGHBOURS[cellIndex(x, y)] & (1u << dir))) {
+            set(walls, cellIndex(x, y) + WALL_BIT[dir]);
+        }
+    }
+
+    /**
+     * Open passages; CELLS - 1 for a perfect maze
+     */
+    constexpr size_t countPassages() const {
+        size_t open = 0;
+        for (Index cell = 0; cell < CELLS; cell++) {
+            open += !test(walls, cell + WALL_BIT[RIGHT]) + !test(walls, cell + WALL_BIT[BOTTOM]);
+        }
+        return open;
+    }
+
+    /**
+     * Cells reachable from (x, y); 0 if out of range. Bit-parallel when
+     * whole rows fit in a word (W divides 64), else a BFS.
+     */
+    constexpr size_t reachableCells(int x = 0, int y = 0) const {
+        if (!inBounds(x, y)) return 0;
+        if constexpr (64 % W == 0) {
+            return flood(cellIndex(x, y));
+        } else {
+            return search(cellIndex(x, y), -1, nullptr).reached;
+        }
+    }
+
+    constexpr bool isConnected() const { return reachableCells(0, 0) == static_cast<size_t>(CELLS); }
+
+    /**
+     * Steps on a shortest path, -1 without a path or out of range
+     */
+    constexpr int shortestPathLength(int startX, int startY, int endX, int endY) const {
+        if (!inBounds(startX, startY) || !inBounds(endX, endY)) return -1;
+        return search(cellIndex(startX, startY), cellIndex(endX, endY), nullptr).length;
+    }
+
+    /**
+     * Shortest path from start to end into path (cell indices y * W + x,
+     * both ends included); returns the number of cells, 0 without a path
+     */
+    constexpr size_t solve(int startX, int startY, int endX, int endY, std::array<uint32_t, CELLS>& path) const {
+        if (!inBounds(startX, startY) || !inBounds(endX, endY)) return 0;
+        std::array<uint8_t, CELLS> parents{};
+        Index start = cellIndex(startX, startY);
+        Index end = cellIndex(endX, endY);
+        int length = search(start, end, &parents).length;
+        if (length < 0) return 0;
+
+        // Walk back from the end, filling the path from its back
+        size_t count = static_cast<size_t>(length) + 1;
+        Index cell = end;
+        for (size_t i = count; i-- > 0;) {
+            path[i] = cell;
+            if (i > 0) cell = static_cast<Index>(cell - STEP[parents[cell]]);
+        }
+        return count;
+    }
+
+    bool solve(int startX, int startY, int endX, int endY, std::vector<uint32_t>& path) const {
+        std::array<uint32_t, CELLS> cells{};
+        size_t count = solve(startX, startY, endX, endY, cells);
+        path.assign(cells.begin(), cells.begin() + count);
+        return count > 0;
+    }
+
+    constexpr bool operator==(const FixedMaze& other) const {
+        for (size_t i = 0; i < walls.size(); i++) {
+            if (walls[i] != other.walls[i]) return false;
+        }
+        return true;
+    }
+    constexpr bool operator!=(const FixedMaze& other) const { return !(*this == other); }
+
+    /**
+     * Conversion to and from the dynamic types. toGrid reuses the grid's
+     * buffers; fromGrid returns false, leaving this maze unchanged, when
+     * the sizes differ.
+     */
+    void toGrid(MazeGrid& grid) const {
+        grid.resize(W, H);
+        for (int y = 0; y < H; y++) {
+            for (int x = 0; x < W; x++) {
+                Index cell = cellIndex(x, y);
+                if (!test(walls, cell + WALL_BIT[RIGHT])) grid.removeWall(x, y, RIGHT);
+                if (!test(walls, cell + WALL_BIT[BOTTOM])) grid.removeWall(x, y, BOTTOM);
+            }
+        }
+    }
+    MazeGrid toGrid() const {
+        MazeGrid grid;
+        toGrid(grid);
+        return grid;
+    }
+    Maze toMaze() const { return Maze(toGrid()); }
+
+    bool fromGrid(const MazeGrid& grid) {
+        if (grid.getWidth() != W || grid.getHeight() != H) return false;
+        reset();
+        for (int y = 0; y < H; y++) {
+            for (int x = 0; x < W; x++) {
+                if (x < W - 1 && !grid.hasEastWall(x, y)) clear(walls, cellIndex(x, y) + WALL_BIT[RIGHT]);
+                if (y < H - 1 && !grid.hasSouthWall(x, y)) clear(walls, cellIndex(x, y) + WALL_BIT[BOTTOM]);
+            }
+        }
+        return true;
+    }
+    bool fromMaze(const Maze& maze) { return fromGrid(maze.getGrid()); }
+
+private:
+    using Index = uint16_t;
+    template <size_t N>
+    using Bits = std::array<uint64_t, (N + 63) / 64>;
+
+    static constexpr size_t PLANE_WORDS = (static_cast<size_t>(CELLS) + 63) / 64;
+    static constexpr size_t EAST_WORD = 1;                                      // After one padding word
+    static constexpr size_t SOUTH_WORD = EAST_WORD + PLANE_WORDS + (W + 63) / 64;  // After a row of padding
+    static constexpr int STEP[4] = {-W, 1, W, -1};  // Index offset per Direction
+    static constexpr size_t WALL_BIT[4] = {SOUTH_WORD * 64 - W, EAST_WORD * 64, SOUTH_WORD * 64,
+                                           EAST_WORD * 64 - 1};  // Wall of cell c: bit c + WALL_BIT
+
+    /**
+     * In-bounds directions of every cell, computed at compile time
+     */
+    static constexpr std::array<uint8_t, CELLS> neighbourMasks() {
+        std::array<uint8_t, CELLS> masks{};
+        for (int y = 0; y < H; y++) {
+            for (int x = 0; x < W; x++) {
+                unsigned mask = 0;
+                if (y > 0) mask |= 1u << TOP;
+                if (x < W - 1) mask |= 1u << RIGHT;
+                if (y < H - 1) mask |= 1u << BOTTOM;
+                if (x > 0) mask |= 1u << LEFT;
+                masks[static_cast<size_t>(y * W + x)] = static_cast<uint8_t>(mask);
+            }
+        }
+        return masks;
+    }
+    static constexpr std::array<uint8_t, CELLS> NEIGHBOURS = neighbourMasks();
+
+    /**
+     * PICK[mask][k]: the k-th set direction of mask
+     */
+    static constexpr std::array<std::array<uint8_t, 4>, 16> pickTable() {
+        std::array<std::array<uint8_t, 4>, 16> table{};
+        for (unsigned mask = 0; mask < 16; mask++) {
+            unsigned k = 0;
+            for (unsigned dir = 0; dir < 4; dir++) {
+                if (mask & (1u << dir)) table[mask][k++] = static_cast<uint8_t>(dir);
+            }
+        }
+        return table;
+    }
+    static constexpr std::array<std::array<uint8_t, 4>, 16> PICK = pickTable();
+
+    struct SearchResult {
+        size_t reached;  // Cells dequeued
+        int length;      // Steps to the end, -1 if not reached
+    };
+
+    static constexpr Index cellIndex(int x, int y) { return static_cast<Index>(y * W + x); }
+
+    template <size_t N>
+    static constexpr bool test(const std::array<uint64_t, N>& bits, size_t i) {
+        return (bits[i >> 6] >> (i & 63)) & 1u;
+    }
+    template <size_t N>
+    static constexpr void set(std::array<uint64_t, N>& bits, size_t i) {
+        bits[i >> 6] |= 1ULL << (i & 63);
+    }
+    template <size_t N>
+    static constexpr void clear(std::array<uint64_t, N>& bits, size_t i) {
+        bits[i >> 6] &= ~(1ULL << (i & 63));
+    }
+
+    /**
+     * Open directions from the sentinel layout: four bit tests, no border
+     * checks
+     */
+    constexpr unsigned openAt(Index cell) const {
+        return (!test(walls, cell + WALL_BIT[TOP]) ? 1u << TOP : 0u) |
+               (!test(walls, cell + WALL_BIT[RIGHT]) ? 1u << RIGHT : 0u) |
+               (!test(walls, cell + WALL_BIT[BOTTOM]) ? 1u << BOTTOM : 0u) |
+               (!test(walls, cell + WALL_BIT[LEFT]) ? 1u << LEFT : 0u);
+    }
+
+    /**
+     * Spread seeds along the runs of cells joined by eastOpen within one
+     * word (MazeFloodFill's trick): subtracting the seeds borrows each one
+     * up to the end of its run, and a shift-and-mask fill takes it down to
+     * the start
+     */
+    static constexpr uint64_t fillWord(uint64_t seeds, uint64_t eastOpen) {
+        const uint64_t ends = ~eastOpen;
+        seeds |= (ends - (seeds & eastOpen)) ^ ends;
+        uint64_t left = eastOpen;
+        for (int shift = 1; shift < 64; shift *= 2) {
+            seeds |= left & (seeds >> shift);
+            left &= left >> shift;
+        }
+        return seeds;
+    }
+
+    /**
+     * Reachable cells from start, a word of rows at a time: a dirty word
+     * is refilled with seeds from its neighbours above and below until it
+     * stops changing, and the words its new cells open into are marked
+     * dirty. The lowest dirty word goes next.
+     */
+    constexpr size_t flood(Index start) const {
+        Bits<CELLS> reached{};
+        Bits<PLANE_WORDS> dirty{};
+        const size_t first = start >> 6;
+        set(reached, start);
+        size_t low = first > 0 ? first - 1 : 0;
+        for (size_t w = low; w <= first + 1 && w < PLANE_WORDS; w++) set(dirty, w);
+
+        for (;;) {
+            size_t i = low >> 6;
+            while (i < dirty.size() && !dirty[i]) i++;
+            if (i == dirty.size()) break;
+            const size_t w = i * 64 + static_cast<size_t>(__builtin_ctzll(dirty[i]));
+            dirty[i] &= dirty[i] - 1;
+            low = w;
+
+            const uint64_t east = ~walls[EAST_WORD + w];
+            const uint64_t south = ~walls[SOUTH_WORD + w];
+            const uint64_t southAbove = w > 0 ? ~walls[SOUTH_WORD + w - 1] : 0;
+            const uint64_t above = w > 0 ? reached[w - 1] & southAbove : 0;
+            const uint64_t below = w + 1 < PLANE_WORDS ? reached[w + 1] : 0;
+            uint64_t cells = reached[w];
+            for (;;) {
+                uint64_t seeds = cells;
+                if constexpr (W == 64) {
+                    seeds |= above | (below & south);
+                } else {
+                    seeds |= ((cells & south) << W) | (above >> (64 - W));
+                    seeds |= ((cells >> W) | (below << (64 - W))) & south;
+                }
+                const uint64_t grown = fillWord(seeds, east);
+                if (grown == cells) break;
+                const uint64_t added = grown & ~cells;
+                cells = grown;
+                if constexpr (W == 64) {
+                    if (added & south) set(dirty, w + 1);
+                    if (added & southAbove) set(dirty, w - 1);
+                } else {
+                    if ((added & south) >> (64 - W)) set(dirty, w + 1);
+                    if ((added << (64 - W)) & southAbove) set(dirty, w - 1);
+                }
+            }
+            reached[w] = cells;
+            if (w > 0 && test(dirty, w - 1)) low = w - 1;
+        }
+
+        size_t count = 0;
+        for (uint64_t word : reached) count += static_cast<size_t>(__builtin_popcountll(word));
+        return count;
+    }
+
+    /**
+     * Level-by-level BFS from start, stopping at end (-1: visit all).
+     * With parents set, records the direction each cell was entered by.
+     */
+    constexpr SearchResult search(Index start, int end, std::array<uint8_t, CELLS>* parents) const {
+        if (start == end) return {1, 0};
+        Bits<CELLS> visited{};
+        std::array<Index, CELLS> queue{};
+        size_t head = 0, tail = 0;
+        queue[tail++] = start;
+        set(visited, start);
+        for (int level = 1; head < tail; level++) {
+            for (size_t levelEnd = tail; head < levelEnd; head++) {
+                Index cell = queue[head];
+                for (unsigned open = openAt(cell); open; open &= open - 1) {
+                    unsigned dir = static_cast<unsigned>(__builtin_ctz(open));
+                    Index next = static_cast<Index>(cell + STEP[dir]);
+                    if (test(visited, next)) continue;
+                    set(visited, next);
+                    if (parents) (*parents)[next] = static_cast<uint8_t>(dir);
+                    if (next == end) return {head + 1, level};
+                    queue[tail++] = next;
+                }
+            }
+        }
+        return {tail, -1};
+    }
+
+    std::array<uint64_t, SOUTH_WORD + PLANE_WORDS> walls{};  // Padding, east plane, padding, south plane
+};
+
+#endif // FIXED_MAZE_H
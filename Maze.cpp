@@ -1,118 +1,78 @@
 #include "Maze.h"
+#include "TiledGenerator.h"
 #include <algorithm>
+#include <cassert>
 #include <chrono>
-#include <queue>
+#include <string>
+
+namespace {
+// Maze seeds are 32-bit (mt19937 only uses the low 32 bits), so this loses nothing
+unsigned int clockSeed() {
+    return static_cast<unsigned int>(std::chrono::steady_clock::now().time_since_epoch().count());
+}
+}
 
 /**
  * Default constructor - creates a 10x10 maze
  */
-Maze::Maze() : width(10), height(10), rng(std::chrono::steady_clock::now().time_since_epoch().count()) {
-    grid.resize(height, std::vector<Cell>(width));
-    
-    // Initialize grid with coordinates
-    for (int y = 0; y < height; y++) {
-        for (int x = 0; x < width; x++) {
-            grid[y][x] = Cell(x, y);
-        }
-    }
+Maze::Maze() : Maze(10, 10) {
 }
 
 /**
  * Constructor with custom dimensions
  */
-Maze::Maze(int w, int h) : width(w), height(h), rng(std::chrono::steady_clock::now().time_since_epoch().count()) {
-    grid.resize(height, std::vector<Cell>(width));
-    
-    // Initialize grid with coordinates
-    for (int y = 0; y < height; y++) {
-        for (int x = 0; x < width; x++) {
-            grid[y][x] = Cell(x, y);
-        }
-    }
+Maze::Maze(int w, int h) : Maze(w, h, clockSeed()) {
 }
 
 /**
  * Constructor with custom dimensions and seed
  */
-Maze::Maze(int w, int h, unsigned int seed) : width(w), height(h), rng(seed) {
-    grid.resize(height, std::vector<Cell>(width));
-    
-    // Initialize grid with coordinates
-    for (int y = 0; y < height; y++) {
-        for (int x = 0; x < width; x++) {
-            grid[y][x] = Cell(x, y);
-        }
-    }
+Maze::Maze(int w, int h, unsigned int seed) : width(w), height(h), grid(w, h), rng(seed) {
+    origin.seed = seed;
 }
 
 /**
- * Get cell at specific coordinates
+ * Constructor from an existing grid (walls are copied as they are),
+ * seeded from the clock like Maze(w, h)
  */
-Cell* Maze::getCell(int x, int y) {
-    if (x >= 0 && x < width && y >= 0 && y < height) {
-        return &grid[y][x];
-    }
-    return nullptr;
+Maze::Maze(const MazeGrid& source) : Maze(source, clockSeed()) {
 }
 
-/**
- * Get all unvisited neighbors of a cell
- */
-std::vector<Cell*> Maze::getUnvisitedNeighbors(Cell* cell) {
-    std::vector<Cell*> neighbors;
-    
-    if (!cell) return neighbors;
-    
-    // Check all four directions
-    Cell* top = getCell(cell->x, cell->y - 1);
-    Cell* right = getCell(cell->x + 1, cell->y);
-    Cell* bottom = getCell(cell->x, cell->y + 1);
-    Cell* left = getCell(cell->x - 1, cell->y);
-    
-    if (top && !top->visited) neighbors.push_back(top);
-    if (right && !right->visited) neighbors.push_back(right);
-    if (bottom && !bottom->visited) neighbors.push_back(bottom);
-    if (left && !left->visited) neighbors.push_back(left);
-    
-    return neighbors;
+Maze::Maze(const MazeGrid& source, unsigned int seed)
+    : width(source.getWidth()), height(source.getHeight()), grid(source), rng(seed) {
+    origin.seed = seed;
 }
 
 /**
- * Get direction from one cell to another
+ * Reuse the object: new size and seed, all walls up, scratch kept
  */
-Direction Maze::getDirection(Cell* from, Cell* to) {
-    if (to->y < from->y) return TOP;
-    if (to->x > from->x) return RIGHT;
-    if (to->y > from->y) return BOTTOM;
-    return LEFT;
+void Maze::reset(int w, int h, unsigned int seed) {
+    width = w;
+    height = h;
+    grid.resize(w, h);  // Back on owned planes before any mapping goes
+    mapping.file.reset();
+    wallsReplaced();
+    tracking = false;  // Tracked cells may not exist at the new size
+    rng.seed(seed);
+    rngFresh = true;
+    solution.clear();
+    origin = MazeOrigin();
+    origin.seed = seed;
+    origin.random = rng.getEngine();
 }
 
 /**
- * Remove wall between two adjacent cells
+ * The walls changed other than through openWall / closeWall: the edit
+ * index is rebuilt and the tracked distances recomputed on next use
  */
-void Maze::removeWall(Cell* current, Cell* neighbor) {
-    if (!current || !neighbor) return;
-    
-    Direction dir = getDirection(current, neighbor);
-    
-    // Remove wall from current cell
-    current->walls[dir] = false;
-    
-    // Remove corresponding wall from neighbor
-    switch (dir) {
-        case TOP:
-            neighbor->walls[BOTTOM] = false;
-            break;
-        case RIGHT:
-            neighbor->walls[LEFT] = false;
-            break;
-        case BOTTOM:
-            neighbor->walls[TOP] = false;
-            break;
-        case LEFT:
-            neighbor->walls[RIGHT] = false;
-            break;
-    }
+void Maze::wallsReplaced() {
+    connectivity.clear();
+    trackedStale = true;
+    doorA = NO_DOOR;
+}
+
+void Maze::reset(int w, int h) {
+    reset(w, h, clockSeed());
 }
 
 /**
@@ -124,105 +84,135 @@ void Maze::generateMaze() {
 
 /**
  * Iterative maze generation using stack-based depth-first search
+ * (see DfsGenerator for the exact reference sequence per seed)
  */
 void Maze::generateMazeIterative() {
-    resetMaze();
-    
-    // Start from top-left corner
-    Cell* currentCell = getCell(0, 0);
-    currentCell->visited = true;
-    cellStack.push(currentCell);
-    
-    while (!cellStack.empty()) {
-        currentCell = cellStack.top();
-        
-        // Get unvisited neighbors
-        std::vector<Cell*> neighbors = getUnvisitedNeighbors(currentCell);
-        
-        if (!neighbors.empty()) {
-            // Choose random neighbor
-            std::uniform_int_distribution<int> dist(0, neighbors.size() - 1);
-            Cell* chosenNeighbor = neighbors[dist(rng)];
-            
-            // Remove wall between current and chosen neighbor
-            removeWall(currentCell, chosenNeighbor);
-            
-            // Mark chosen neighbor as visited and push to stack
-            chosenNeighbor->visited = true;
-            cellStack.push(chosenNeighbor);
-        } else {
-            // Backtrack - pop from stack
-            cellStack.pop();
-        }
-    }
+    generate(MazeAlgorithm::DFS);
 }
 
 /**
  * Recursive maze generation algorithm
+ *
+ * Same visit order as a plain recursive backtracker, but the recursion runs
+ * on RecursiveGenerator's explicit frame stack, so large mazes cannot
+ * overflow the native stack and repeated calls are independent.
  */
 void Maze::generateMazeRecursive(int x, int y) {
-    // Base case: if starting a new maze
-    static bool isNewMaze = true;
-    if (isNewMaze) {
-        resetMaze();
-        isNewMaze = false;
-    }
-    
-    Cell* currentCell = getCell(x, y);
-    if (!currentCell) {
-        isNewMaze = true; // Reset for next call
-        return;
-    }
-    
-    currentCell->visited = true;
-    
-    // Get all unvisited neighbors
-    std::vector<Cell*> neighbors = getUnvisitedNeighbors(currentCell);
-    
-    // Shuffle neighbors for randomness
-    std::shuffle(neighbors.begin(), neighbors.end(), rng);
-    
-    // Recursively visit each unvisited neighbor
-    for (Cell* neighbor : neighbors) {
-        if (!neighbor->visited) {
-            removeWall(currentCell, neighbor);
-            generateMazeRecursive(neighbor->x, neighbor->y);
-        }
-    }
-    
-    // Check if we're done (all cells visited)
-    bool allVisited = true;
-    for (int cy = 0; cy < height && allVisited; cy++) {
-        for (int cx = 0; cx < width && allVisited; cx++) {
-            if (!grid[cy][cx].visited) {
-                allVisited = false;
-            }
-        }
-    }
-    
-    if (allVisited) {
-        isNewMaze = true; // Reset for next call
-    }
+    generators.generateRecursive(grid, rng, x, y);
+    wallsReplaced();
+    origin.algorithm = MazeAlgorithm::RECURSIVE;
+    origin.random = rng.getEngine();
+    origin.tileSize = 0;
+    origin.replayable = rngFresh && x == 0 && y == 0;
+    rngFresh = false;
+}
+
+/**
+ * Generate with any of the available algorithms using the current RNG state
+ */
+void Maze::generate(MazeAlgorithm algorithm) {
+    generators.generate(algorithm, grid, rng);
+    wallsReplaced();
+    origin.algorithm = algorithm;
+    origin.random = rng.getEngine();
+    origin.tileSize = 0;
+    origin.replayable = rngFresh;
+    rngFresh = false;
+    
+    // Every algorithm must produce a perfect maze (a spanning tree)
+    assert(grid.cellCount() == 0 || countPassages() == grid.cellCount() - 1);
+}
+
+/**
+ * Reseed, then generate with the given algorithm (reproducible per seed)
+ */
+void Maze::generate(MazeAlgorithm algorithm, unsigned int seed) {
+    rng.seed(seed);
+    origin.seed = seed;
+    rngFresh = true;
+    generate(algorithm);
+}
+
+/**
+ * Parallel tiled generation on an existing pool
+ */
+void Maze::generateParallel(unsigned int seed, int tileSize, ThreadPool& pool, MazeAlgorithm algorithm) {
+    TiledGenerator tiled;
+    tiled.generate(grid, seed, tileSize, pool, algorithm, rng.getEngine());
+    wallsReplaced();
+    origin.seed = seed;
+    origin.random = rng.getEngine();
+    origin.algorithm = algorithm;
+    origin.tileSize = std::max(tileSize, 1);
+    origin.replayable = true;
+    
+    assert(grid.cellCount() == 0 || countPassages() == grid.cellCount() - 1);
+}
+
+/**
+ * Parallel tiled generation on a temporary pool of the given size
+ */
+void Maze::generateParallel(unsigned int seed, int tileSize, int threads, MazeAlgorithm algorithm) {
+    ThreadPool pool(threads);
+    generateParallel(seed, tileSize, pool, algorithm);
+}
+
+/**
+ * Switch engines and restart the stream from the current seed
+ */
+void Maze::setRandomEngine(RandomEngine engine) {
+    rng.setEngine(engine, origin.seed);
+    rngFresh = true;
 }
 
 /**
  * Reset maze to initial state
  */
 void Maze::resetMaze() {
-    // Clear stack
-    while (!cellStack.empty()) {
-        cellStack.pop();
-    }
-    
-    // Reset all cells
-    for (int y = 0; y < height; y++) {
-        for (int x = 0; x < width; x++) {
-            grid[y][x].visited = false;
-            for (int i = 0; i < 4; i++) {
-                grid[y][x].walls[i] = true;
-            }
-        }
+    // Reset all cells: every wall up, nothing visited
+    grid.reset();
+    wallsReplaced();
+    origin.replayable = false;
+}
+
+/**
+ * Write header and wall planes (see MazeFile.h)
+ */
+MazeFileStatus Maze::save(const std::string& path) const {
+    return writeMazeFile(path, grid, origin);
+}
+
+/**
+ * Map the file and use its wall planes in place. On failure the maze is
+ * left unchanged.
+ */
+MazeFileStatus Maze::load(const std::string& path, bool verifyChecksum) {
+    auto file = std::make_shared<MappedMazeFile>();
+    MazeFileStatus status = file->open(path, verifyChecksum);
+    if (status != MazeFileStatus::OK) return status;
+    
+    width = file->getWidth();
+    height = file->getHeight();
+    grid.attach(width, height, file->eastPlane(), file->southPlane());
+    origin = file->getOrigin();
+    rng.setEngine(origin.random, origin.seed);  // generate(origin.algorithm, origin.seed) replays it
+    rngFresh = false;
+    solution.clear();
+    wallsReplaced();
+    tracking = false;
+    mapping.file = std::move(file);  // Releases any previous mapping after the grid moved off it
+    return MazeFileStatus::OK;
+}
+
+/**
+ * Feed every row of the grid to a row sink
+ */
+static void writeRows(const MazeGrid& grid, unsigned int seed, MazeRowSink& sink) {
+    sink.begin(grid.getWidth(), grid.getHeight(), seed);
+    for (int y = 0; y < grid.getHeight(); y++) {
+        sink.row(grid.eastRow(y), grid.southRow(y));
     }
+    sink.end();
 }
 
 /**
@@ -231,57 +221,8 @@ void Maze::resetMaze() {
 void Maze::printMaze() const {
     std::cout << "\n=== MAZE (" << width << "x" << height << ") ===\n";
     
-    // Top border
-    std::cout << "┌";
-    for (int x = 0; x < width; x++) {
-        std::cout << "──";
-        if (x < width - 1) std::cout << "┬";
-    }
-    std::cout << "┐\n";
-    
-    // Maze content
-    for (int y = 0; y < height; y++) {
-        // Vertical walls and spaces
-        std::cout << "│";
-        for (int x = 0; x < width; x++) {
-            std::cout << "  ";
-            if (x < width - 1) {
-                std::cout << (grid[y][x].walls[RIGHT] ? "│" : " ");
-            }
-        }
-        std::cout << "│\n";
-        
-        // Horizontal walls (except for last row)
-        if (y < height - 1) {
-            std::cout << "├";
-            for (int x = 0; x < width; x++) {
-                std::cout << (grid[y][x].walls[BOTTOM] ? "──" : "  ");
-                if (x < width - 1) {
-                    // Corner character
-                    bool hasBottom = grid[y][x].walls[BOTTOM];
-                    bool hasRight = grid[y][x].walls[RIGHT];
-                    bool hasBottomRight = grid[y][x + 1].walls[BOTTOM];
-                    bool hasBottomLeft = grid[y + 1][x].walls[RIGHT];
-                    
-                    if (hasBottom && hasRight && hasBottomRight && hasBottomLeft) std::cout << "┼";
-                    else if (hasBottom && hasBottomRight) std::cout << "┬";
-                    else if (hasRight && hasBottomLeft) std::cout << "├";
-                    else if (hasBottom || hasBottomRight) std::cout << "─";
-                    else if (hasRight || hasBottomLeft) std::cout << "│";
-                    else std::cout << " ";
-                }
-            }
-            std::cout << "┤\n";
-        }
-    }
-    
-    // Bottom border
-    std::cout << "└";
-    for (int x = 0; x < width; x++) {
-        std::cout << "──";
-        if (x < width - 1) std::cout << "┴";
-    }
-    std::cout << "┘\n";
+    BoxDrawingSink sink(std::cout);
+    writeRows(grid, 0, sink);
 }
 
 /**
@@ -290,39 +231,101 @@ void Maze::printMaze() const {
 void Maze::printMazeASCII() const {
     std::cout << "\n=== ASCII MAZE (" << width << "x" << height << ") ===\n";
     
-    // Top border
-    for (int x = 0; x < width * 2 + 1; x++) {
-        std::cout << "#";
-    }
-    std::cout << "\n";
-    
-    for (int y = 0; y < height; y++) {
-        // Left border
-        std::cout << "#";
-        
-        // Cell content and right walls
-        for (int x = 0; x < width; x++) {
-            std::cout << " ";  // Cell space
-            std::cout << (grid[y][x].walls[RIGHT] ? "#" : " ");
+    AsciiSink sink(std::cout);
+    writeRows(grid, 0, sink);
+}
+
+/**
+ * Run the grid through the sink for `format`; Target is an ostream or a string
+ */
+template <typename Target>
+static void renderRows(const MazeGrid& grid, StreamFormat format, Target& target) {
+    switch (format) {
+        case StreamFormat::BOX: {
+            BoxDrawingSink sink(target);
+            writeRows(grid, 0, sink);
+            break;
         }
-        std::cout << "\n";
-        
-        // Bottom walls (except for last row)
-        if (y < height - 1) {
-            std::cout << "#";
-            for (int x = 0; x < width; x++) {
-                std::cout << (grid[y][x].walls[BOTTOM] ? "#" : " ");
-                std::cout << "#";
-            }
-            std::cout << "\n";
+        case StreamFormat::ASCII: {
+            AsciiSink sink(target);
+            writeRows(grid, 0, sink);
+            break;
+        }
+        case StreamFormat::BINARY: {
+            BinaryRowSink sink(target);
+            writeRows(grid, 0, sink);
+            break;
         }
     }
+}
+
+/**
+ * Render into a caller-owned string; same bytes as printMaze/printMazeASCII
+ * after their header line
+ */
+void Maze::renderMaze(std::string& target, StreamFormat format) const {
+    renderRows(grid, format, target);
+}
+
+/**
+ * Render straight into a stream, without the header line
+ */
+void Maze::writeMaze(std::ostream& out, StreamFormat format) const {
+    renderRows(grid, format, out);
+}
+
+/**
+ * Raster image, optionally with a path (e.g. getSolution())
+ */
+void Maze::writeImage(std::ostream& out, const RasterOptions& options, const std::vector<uint32_t>* path) const {
+    RasterSink sink(out, options, path);
+    writeRows(grid, 0, sink);
+}
+
+/**
+ * Streaming Eller generation: only the current row and its set labels
+ * are held in memory; each finished row is handed to the sink
+ */
+void Maze::generateMazeStreaming(int w, int h, unsigned int seed, MazeRowSink& sink) {
+    if (w <= 0 || h <= 0) return;
+    
+    MazeRandom streamRng(seed);
+    EllerRowGenerator rows;
+    rows.begin(w);
     
-    // Bottom border
-    for (int x = 0; x < width * 2 + 1; x++) {
-        std::cout << "#";
+    size_t words = (static_cast<size_t>(w) + 63) / 64;
+    std::vector<uint64_t> eastRow(words);
+    std::vector<uint64_t> southRow(words);
+    
+    sink.begin(w, h, seed);
+    for (int y = 0; y < h; y++) {
+        rows.nextRow(streamRng, y == h - 1, eastRow.data(), southRow.data());
+        sink.row(eastRow.data(), southRow.data());
+    }
+    sink.end();
+}
+
+/**
+ * Streaming generation into a text or binary stream
+ */
+void Maze::generateMazeStreaming(int w, int h, unsigned int seed, StreamFormat format, std::ostream& out) {
+    switch (format) {
+        case StreamFormat::BOX: {
+            BoxDrawingSink sink(out);
+            generateMazeStreaming(w, h, seed, sink);
+            break;
+        }
+        case StreamFormat::ASCII: {
+            AsciiSink sink(out);
+            generateMazeStreaming(w, h, seed, sink);
+            break;
+        }
+        case StreamFormat::BINARY: {
+            BinaryRowSink sink(out);
+            generateMazeStreaming(w, h, seed, sink);
+            break;
+        }
     }
-    std::cout << "\n";
 }
 
 /**
@@ -337,202 +340,225 @@ void Maze::printMazeDetailed() const {
     for (int y = 0; y < height; y++) {
         for (int x = 0; x < width; x++) {
             for (int w = 0; w < 4; w++) {
-                if (grid[y][x].walls[w]) wallCount++;
+                if (grid.hasWall(x, y, static_cast<Direction>(w))) wallCount++;
             }
         }
     }
     std::cout << "Total walls: " << wallCount / 2 << "\n"; // Divide by 2 since walls are shared
     
+    const MazeStats& stats = analyze();
+    std::ios::fmtflags flags = std::cout.flags();
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Dead ends: " << stats.deadEnds << "\n";
+    std::cout << "Junctions: " << stats.junctions << " (branching factor " << stats.branchingFactor << ")\n";
+    std::cout << "Corridors: " << stats.corridors << " (mean " << stats.meanCorridor << " steps, longest "
+              << stats.longestCorridor << ")\n";
+    std::cout << "Diameter: " << stats.diameter << " steps\n";
+    if (stats.solutionLength >= 0) {
+        std::cout << "Solution: " << stats.solutionLength << " steps, " << stats.solutionTurns
+                  << " turns, tortuosity " << stats.tortuosity << "\n";
+    }
+    std::cout << "River factor: " << stats.riverFactor << "\n";
+    std::cout.flags(flags);
+    
     printMaze();
 }
 
 /**
- * Simple maze solver using DFS (bonus feature)
+ * Shortest path without console output; uses the maze's solver context
+ */
+bool Maze::findPath(int startX, int startY, int endX, int endY, std::vector<uint32_t>& path,
+                    SolverMode mode) {
+    return solver.solve(grid, startX, startY, endX, endY, path, mode);
+}
+
+/**
+ * Solve (BFS unless another mode is given), report on the console and keep the path for printSolution
  */
-bool Maze::solveMaze(int startX, int startY, int endX, int endY) {
+bool Maze::solveMaze(int startX, int startY, int endX, int endY, SolverMode mode) {
     // Set default end position if not specified
     if (endX == -1) endX = width - 1;
     if (endY == -1) endY = height - 1;
     
     // Validate start and end positions
-    if (startX < 0 || startX >= width || startY < 0 || startY >= height) {
+    if (!grid.inBounds(startX, startY)) {
         std::cout << "\nInvalid start position!\n";
+        solution.clear();
         return false;
     }
-    if (endX < 0 || endX >= width || endY < 0 || endY >= height) {
+    if (!grid.inBounds(endX, endY)) {
         std::cout << "\nInvalid end position!\n";
+        solution.clear();
         return false;
     }
     
-    // Use BFS to reliably find the shortest path from start to end.
-    if (endX == -1) endX = width - 1;
-    if (endY == -1) endY = height - 1;
-
-    // Validate start and end positions
-    if (startX < 0 || startX >= width || startY < 0 || startY >= height) {
-        std::cout << "\nInvalid start position!\n";
-        return false;
-    }
-    if (endX < 0 || endX >= width || endY < 0 || endY >= height) {
-        std::cout << "\nInvalid end position!\n";
+    if (!solver.solve(grid, startX, startY, endX, endY, solution, mode)) {
+        std::cout << "\nNo solution found: end is unreachable from start.\n";
         return false;
     }
+    
+    std::cout << "\nSolution found! Shortest path length: " << solution.size() - 1 << " steps\n";
+    return true;
+}
 
-    // Local visited and parent trackers (do not modify grid visited flags here)
-    std::vector<std::vector<bool>> visitedLocal(height, std::vector<bool>(width, false));
-    std::vector<std::vector<std::pair<int,int>>> parent(height, std::vector<std::pair<int,int>>(width, {-1,-1}));
-
-    std::queue<std::pair<int,int>> q;
-    q.push({startX, startY});
-    visitedLocal[startY][startX] = true;
-    bool found = false;
-
-    while (!q.empty()) {
-        auto [cx, cy] = q.front(); q.pop();
-
-        if (cx == endX && cy == endY) {
-            found = true;
-            break;
-        }
-
-        Cell* current = getCell(cx, cy);
-        if (!current) continue;
-
-        // Explore neighbors allowed by removed walls
-        // TOP
-        if (!current->walls[TOP]) {
-            int nx = cx, ny = cy - 1;
-            if (ny >= 0 && !visitedLocal[ny][nx]) {
-                visitedLocal[ny][nx] = true;
-                parent[ny][nx] = {cx, cy};
-                q.push({nx, ny});
-            }
-        }
-        // RIGHT
-        if (!current->walls[RIGHT]) {
-            int nx = cx + 1, ny = cy;
-            if (nx < width && !visitedLocal[ny][nx]) {
-                visitedLocal[ny][nx] = true;
-                parent[ny][nx] = {cx, cy};
-                q.push({nx, ny});
-            }
-        }
-        // BOTTOM
-        if (!current->walls[BOTTOM]) {
-            int nx = cx, ny = cy + 1;
-            if (ny < height && !visitedLocal[ny][nx]) {
-                visitedLocal[ny][nx] = true;
-                parent[ny][nx] = {cx, cy};
-                q.push({nx, ny});
-            }
+/**
+ * Print the maze in ASCII with the last solution path marked by '.'
+ */
+void Maze::printSolution() const {
+    if (solution.empty()) {
+        std::cout << "No solution to show. Use solveMaze() first.\n";
+        return;
+    }
+    
+    // Same (2w + 1) x (2h + 1) layout as printMazeASCII
+    const size_t lineWidth = static_cast<size_t>(width) * 2 + 2;
+    std::string canvas(lineWidth * (static_cast<size_t>(height) * 2 + 1), ' ');
+    for (int row = 0; row <= height * 2; row++) {
+        char* line = &canvas[row * lineWidth];
+        line[lineWidth - 1] = '\n';
+        for (int col = 0; col <= width * 2; col++) {
+            bool wall;
+            if (row == 0 || row == height * 2 || col == 0 || col == width * 2) wall = true;
+            else if (row % 2 == 1 && col % 2 == 1) wall = false;                                    // Cell
+            else if (row % 2 == 1) wall = grid.hasEastWall(col / 2 - 1, row / 2);                  // East wall
+            else if (col % 2 == 1) wall = grid.hasSouthWall(col / 2, row / 2 - 1);                 // South wall
+            else wall = true;                                                                       // Corner
+            if (wall) line[col] = '#';
         }
-        // LEFT
-        if (!current->walls[LEFT]) {
-            int nx = cx - 1, ny = cy;
-            if (nx >= 0 && !visitedLocal[ny][nx]) {
-                visitedLocal[ny][nx] = true;
-                parent[ny][nx] = {cx, cy};
-                q.push({nx, ny});
-            }
+    }
+    
+    // Mark each path cell and the opening between consecutive cells
+    for (size_t i = 0; i < solution.size(); i++) {
+        int x = static_cast<int>(solution[i] % width);
+        int y = static_cast<int>(solution[i] / width);
+        canvas[(y * 2 + 1) * lineWidth + x * 2 + 1] = '.';
+        if (i > 0) {
+            int px = static_cast<int>(solution[i - 1] % width);
+            int py = static_cast<int>(solution[i - 1] / width);
+            canvas[(y + py + 1) * lineWidth + x + px + 1] = '.';
         }
     }
+    
+    std::cout << "\n=== SOLUTION (" << solution.size() - 1 << " steps) ===\n" << canvas;
+}
 
-    if (!found) {
-        std::cout << "\nNo solution found: end is unreachable from start.\n";
-        return false;
+/**
+ * Check if the maze is properly connected (all cells reachable)
+ */
+bool Maze::isMazeConnected() const {
+    if (connectivity.isBuilt()) return connectivity.components() == 1;
+    return reachability.isConnected(grid);
+}
+
+/**
+ * Direction from (x1, y1) to (x2, y2) if both are in range and adjacent
+ */
+bool Maze::wallBetween(int x1, int y1, int x2, int y2, Direction& dir) const {
+    if (!grid.inBounds(x1, y1) || !grid.inBounds(x2, y2)) return false;
+    for (int d = 0; d < 4; d++) {
+        if (x1 + DX[d] == x2 && y1 + DY[d] == y2) {
+            dir = static_cast<Direction>(d);
+            return true;
+        }
     }
+    return false;
+}
 
-    // Reconstruct path length
-    int pathLen = 0;
-    int px = endX, py = endY;
-    while (!(px == startX && py == startY)) {
-        auto p = parent[py][px];
-        if (p.first == -1) break; // safety
-        px = p.first; py = p.second;
-        pathLen++;
+/**
+ * Open a wall and update the forest, and the tracked distances once they
+ * have been computed. The wall that gives a forest its first loop is
+ * remembered as the door for trackedPathLength().
+ */
+bool Maze::openWall(int x1, int y1, int x2, int y2) {
+    Direction dir;
+    if (!wallBetween(x1, y1, x2, y2, dir) || !grid.hasWall(x1, y1, dir)) return false;
+    buildConnectivity();
+    const size_t loopsBefore = connectivity.loopPassages();
+    grid.removeWall(x1, y1, dir);
+    connectivity.opened(grid, x1, y1, dir);
+    origin.replayable = false;
+    solution.clear();
+    
+    // A passage that joined two components is a forest edge and leaves the door alone
+    if (loopsBefore == 0 && connectivity.loopPassages() == 1) {
+        doorA = static_cast<uint32_t>(y1) * static_cast<uint32_t>(width) + static_cast<uint32_t>(x1);
+        doorB = static_cast<uint32_t>(y2) * static_cast<uint32_t>(width) + static_cast<uint32_t>(x2);
+    } else if (connectivity.loopPassages() != loopsBefore) {
+        doorA = NO_DOOR;
     }
+    if (tracking && !trackedStale) trackedField.opened(grid, x1, y1, dir);
+    return true;
+}
 
-    std::cout << "\nSolution found! Shortest path length: " << pathLen << " steps\n";
+bool Maze::closeWall(int x1, int y1, int x2, int y2) {
+    Direction dir;
+    if (!wallBetween(x1, y1, x2, y2, dir) || grid.hasWall(x1, y1, dir)) return false;
+    buildConnectivity();
+    grid.addWall(x1, y1, dir);
+    connectivity.closed(grid, x1, y1, dir);
+    origin.replayable = false;
+    solution.clear();
+    
+    // A close either leaves the door the only loop passage or drops the
+    // loop count to zero (the door closed, or it replaced a cut passage)
+    if (connectivity.isForest()) doorA = NO_DOOR;
+    if (tracking && !trackedStale) trackedField.closed(grid, x1, y1, dir);
     return true;
 }
 
-/**
- * Print solution path (placeholder implementation)
- */
-void Maze::printSolution() const {
-    std::cout << "Solution visualization not implemented in this version.\n";
-    std::cout << "Use solveMaze() method to find if a solution exists.\n";
+bool Maze::cellsConnected(int x1, int y1, int x2, int y2) {
+    if (!grid.inBounds(x1, y1) || !grid.inBounds(x2, y2)) return false;
+    buildConnectivity();
+    const uint32_t w = static_cast<uint32_t>(width);
+    return connectivity.connected(static_cast<uint32_t>(y1) * w + static_cast<uint32_t>(x1),
+                                  static_cast<uint32_t>(y2) * w + static_cast<uint32_t>(x2));
+}
+
+size_t Maze::componentCount() {
+    if (grid.cellCount() == 0) return 0;
+    buildConnectivity();
+    return connectivity.components();
+}
+
+bool Maze::trackPath(int startX, int startY, int endX, int endY) {
+    if (!grid.inBounds(startX, startY) || !grid.inBounds(endX, endY)) {
+        tracking = false;
+        return false;
+    }
+    tracking = true;
+    trackedStale = true;
+    trackedStart = static_cast<uint32_t>(startY) * static_cast<uint32_t>(width) + static_cast<uint32_t>(startX);
+    trackedEnd = static_cast<uint32_t>(endY) * static_cast<uint32_t>(width) + static_cast<uint32_t>(endX);
+    return true;
 }
 
 /**
- * Check if the maze is properly connected (all cells reachable)
+ * Forest distance when there are no loops (the only path). With one loop
+ * made by a known door, the shortest path either avoids the door - the
+ * forest path - or crosses it once, so it is the best of three forest
+ * distances. Otherwise the tracked distance field: computed in full on
+ * the first such query after trackPath() or a wall change other than
+ * openWall / closeWall, and repaired by every edit after that.
  */
-bool Maze::isMazeConnected() {
-    // Reset visited flags
-    for (int y = 0; y < height; y++) {
-        for (int x = 0; x < width; x++) {
-            grid[y][x].visited = false;
-        }
-    }
-    
-    // Use DFS to visit all reachable cells from (0,0)
-    std::stack<Cell*> toVisit;
-    Cell* start = getCell(0, 0);
-    if (!start) return false;
-    
-    start->visited = true;
-    toVisit.push(start);
-    int visitedCount = 1;
-    
-    while (!toVisit.empty()) {
-        Cell* current = toVisit.top();
-        toVisit.pop();
-        
-        // Check all four directions
-        if (!current->walls[TOP]) {
-            Cell* neighbor = getCell(current->x, current->y - 1);
-            if (neighbor && !neighbor->visited) {
-                neighbor->visited = true;
-                toVisit.push(neighbor);
-                visitedCount++;
-            }
-        }
-        if (!current->walls[RIGHT]) {
-            Cell* neighbor = getCell(current->x + 1, current->y);
-            if (neighbor && !neighbor->visited) {
-                neighbor->visited = true;
-                toVisit.push(neighbor);
-                visitedCount++;
-            }
-        }
-        if (!current->walls[BOTTOM]) {
-            Cell* neighbor = getCell(current->x, current->y + 1);
-            if (neighbor && !neighbor->visited) {
-                neighbor->visited = true;
-                toVisit.push(neighbor);
-                visitedCount++;
-            }
-        }
-        if (!current->walls[LEFT]) {
-            Cell* neighbor = getCell(current->x - 1, current->y);
-            if (neighbor && !neighbor->visited) {
-                neighbor->visited = true;
-                toVisit.push(neighbor);
-                visitedCount++;
-            }
+long long Maze::trackedPathLength() {
+    if (!tracking) return -1;
+    buildConnectivity();
+    if (connectivity.isForest()) return connectivity.treeDistance(trackedStart, trackedEnd);
+    if (doorA != NO_DOOR && connectivity.loopPassages() == 1) {
+        long long best = connectivity.treeDistance(trackedStart, trackedEnd);
+        const uint32_t ends[2][2] = {{doorA, doorB}, {doorB, doorA}};
+        for (const auto& door : ends) {
+            long long toDoor = connectivity.treeDistance(trackedStart, door[0]);
+            long long fromDoor = connectivity.treeDistance(door[1], trackedEnd);
+            if (toDoor < 0 || fromDoor < 0) continue;
+            if (best < 0 || toDoor + 1 + fromDoor < best) best = toDoor + 1 + fromDoor;
         }
+        return best;
     }
-    
-    // All cells should be reachable in a proper maze
-    int totalCells = width * height;
-    std::cout << "\nMaze connectivity check:\n";
-    std::cout << "Visited cells: " << visitedCount << "/" << totalCells << "\n";
-    
-    if (visitedCount == totalCells) {
-        std::cout << "✓ Maze is properly connected!\n";
-        return true;
-    } else {
-        std::cout << "✗ Maze has isolated regions! " << (totalCells - visitedCount) << " cells unreachable.\n";
-        return false;
+    if (trackedStale) {
+        trackedField.compute(grid, static_cast<int>(trackedStart % width), static_cast<int>(trackedStart / width));
+        trackedStale = false;
     }
+    uint32_t steps = trackedField.distance(trackedEnd);
+    return steps == MazeDistanceField::UNREACHED ? -1 : static_cast<long long>(steps);
 }
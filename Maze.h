@@ -1,44 +1,24 @@
 #ifndef MAZE_H
 #define MAZE_H
 
+#include <memory>
 #include <vector>
 #include <stack>
+#include <utility>
 #include <random>
 #include <iostream>
 #include <iomanip>
-
-/**
- * Cell structure representing each position in the maze
- */
-struct Cell {
-    bool visited;           // Has this cell been visited during generation?
-    bool walls[4];         // Walls: 0=top, 1=right, 2=bottom, 3=left
-    int x, y;              // Coordinates
-    
-    Cell() : visited(false), x(0), y(0) {
-        // Initialize all walls as present
-        for (int i = 0; i < 4; i++) {
-            walls[i] = true;
-        }
-    }
-    
-    Cell(int x_pos, int y_pos) : visited(false), x(x_pos), y(y_pos) {
-        // Initialize all walls as present
-        for (int i = 0; i < 4; i++) {
-            walls[i] = true;
-        }
-    }
-};
-
-/**
- * Direction enumeration for easier navigation
- */
-enum Direction {
-    TOP = 0,
-    RIGHT = 1,
-    BOTTOM = 2,
-    LEFT = 3
-};
+#include "MazeGrid.h"
+#include "MazeAnalytics.h"
+#include "MazeDistanceField.h"
+#include "MazeDynamicConnectivity.h"
+#include "MazeFile.h"
+#include "MazeFloodFill.h"
+#include "MazeGenerators.h"
+#include "MazeImage.h"
+#include "MazeSolver.h"
+#include "MazeStream.h"
+#include "ThreadPool.h"
 
 /**
  * Maze class implementing recursive maze generation algorithm
@@ -47,44 +27,154 @@ class Maze {
 private:
     int width;              // Maze width
     int height;             // Maze height
-    std::vector<std::vector<Cell>> grid;  // 2D grid of cells
-    std::stack<Cell*> cellStack;          // Stack for backtracking
-    std::mt19937 rng;                     // Random number generator
+    MazeGrid grid;                        // Packed wall and visited bit planes
+    MazeGeneratorEngine generators;       // Generation algorithms and their scratch
+    MazeRandom rng;                       // Random number generator (mt19937 unless changed)
+    MazeSolver solver;                    // Reused BFS scratch
+    mutable MazeFloodFill reachability;   // Connectivity scratch; never touches grid
+    mutable MazeAnalytics analytics;      // Statistics scratch; never touches grid
+    std::vector<uint32_t> solution;       // Last path found by solveMaze
+    MazeOrigin origin;                    // How the current walls were made (saved in files)
+    bool rngFresh = true;                 // No draws from rng since it was seeded
+    
+    // Backs grid's wall planes after load(). A copied grid owns its planes,
+    // so copies of the maze drop the mapping; moves hand it over.
+    struct FileMapping {
+        std::shared_ptr<MappedMazeFile> file;
+        FileMapping() = default;
+        FileMapping(const FileMapping&) {}
+        FileMapping& operator=(const FileMapping&) { file.reset(); return *this; }
+        FileMapping(FileMapping&&) noexcept = default;
+        FileMapping& operator=(FileMapping&&) noexcept = default;
+    };
+    FileMapping mapping;
     
-    // Helper methods
-    Cell* getCell(int x, int y);
-    std::vector<Cell*> getUnvisitedNeighbors(Cell* cell);
-    void removeWall(Cell* current, Cell* neighbor);
-    Direction getDirection(Cell* from, Cell* to);
+    // Live editing state: the forest index is built on the first edit or
+    // query and dropped whenever the walls change any other way
+    MazeDynamicConnectivity connectivity;
+    bool tracking = false;                // trackPath() was called
+    bool trackedStale = true;             // trackedField must be recomputed
+    uint32_t trackedStart = 0;
+    uint32_t trackedEnd = 0;
+    MazeDistanceField trackedField;       // Distances from trackedStart (mazes with loops)
+    static constexpr uint32_t NO_DOOR = 0xFFFFFFFFu;
+    uint32_t doorA = NO_DOOR;             // The only loop passage, when an edit made it
+    uint32_t doorB = NO_DOOR;
+    
+    Maze(const MazeGrid& source, unsigned int seed);
+    void wallsReplaced();
+    void buildConnectivity() { if (!connectivity.isBuilt()) connectivity.build(grid); }
+    bool wallBetween(int x1, int y1, int x2, int y2, Direction& dir) const;
     
 public:
     // Constructors
     Maze();
     Maze(int w, int h);
     Maze(int w, int h, unsigned int seed);
+    explicit Maze(const MazeGrid& source); // Adopt existing walls (e.g. from a MazeBatch)
+    
+    // Copies duplicate the wall planes and scratch (a copy of a loaded maze
+    // owns its planes and is not mapped); moves hand every buffer over
+    // without allocating. A moved-from maze may only be assigned or reset().
+    Maze(const Maze&) = default;
+    Maze& operator=(const Maze&) = default;
+    Maze(Maze&&) noexcept = default;
+    Maze& operator=(Maze&&) noexcept = default;
+    
+    // Reuse this object for a new maze: resize in place (buffers keep their
+    // capacity), every wall up, reseed. O(cells / 64) for an unchanged size.
+    // The random engine and cell layout are kept.
+    void reset(int w, int h, unsigned int seed);
+    void reset(int w, int h); // Seeded from the clock, like Maze(w, h)
     
     // Core functionality
     void generateMaze();
     void generateMazeIterative();
     void generateMazeRecursive(int x = 0, int y = 0);
+    void generate(MazeAlgorithm algorithm);
+    void generate(MazeAlgorithm algorithm, unsigned int seed);
+    
+    // Parallel tiled generation (see TiledGenerator); deterministic for a
+    // given (seed, tileSize, algorithm) whatever the thread count
+    void generateParallel(unsigned int seed, int tileSize, ThreadPool& pool,
+                          MazeAlgorithm algorithm = MazeAlgorithm::DFS);
+    void generateParallel(unsigned int seed, int tileSize, int threads,
+                          MazeAlgorithm algorithm = MazeAlgorithm::DFS);
+    
+    // Random engine for all later generation (see MazeRandom); the stream
+    // restarts from the current seed. Saved in maze files.
+    void setRandomEngine(RandomEngine engine);
+    RandomEngine getRandomEngine() const { return rng.getEngine(); }
+
+    // Memory order of the solver's per-cell scratch (see MazeLayout.h);
+    // paths and lengths are the same in every layout
+    void setCellLayout(CellLayout layout) { solver.setLayout(layout); }
+    CellLayout getCellLayout() const { return solver.getLayout(); }
+
+    // Streaming generation (Eller's algorithm): rows go straight to the sink,
+    // memory is O(width) regardless of height, no Maze object is built
+    static void generateMazeStreaming(int w, int h, unsigned int seed, MazeRowSink& sink);
+    static void generateMazeStreaming(int w, int h, unsigned int seed, StreamFormat format, std::ostream& out);
     
     // Display and utility methods
     void printMaze() const;
     void printMazeASCII() const;
     void printMazeDetailed() const;
+    void renderMaze(std::string& target, StreamFormat format = StreamFormat::BOX) const; // Appends, no header
+    void writeMaze(std::ostream& out, StreamFormat format = StreamFormat::BOX) const;   // No header
+    void writeImage(std::ostream& out, const RasterOptions& options,
+                    const std::vector<uint32_t>* path = nullptr) const;                  // PBM/PGM, see RasterSink
     void resetMaze();
     
+    // Binary maze files (format in MazeFile.h). load() maps the file and
+    // attaches the grid to the mapped wall planes - no parse step.
+    MazeFileStatus save(const std::string& path) const;
+    MazeFileStatus load(const std::string& path, bool verifyChecksum = true);
+    bool isMapped() const { return mapping.file != nullptr; }
+    
     // Getters
     int getWidth() const { return width; }
     int getHeight() const { return height; }
-    const std::vector<std::vector<Cell>>& getGrid() const { return grid; }
+    const MazeGrid& getGrid() const { return grid; } // grid[y][x] yields a Cell
+    const MazeOrigin& getOrigin() const { return origin; }
     
     // Maze solving (bonus feature)
-    bool solveMaze(int startX = 0, int startY = 0, int endX = -1, int endY = -1);
+    bool solveMaze(int startX = 0, int startY = 0, int endX = -1, int endY = -1,
+                   SolverMode mode = SolverMode::BFS);
     void printSolution() const;
+    bool findPath(int startX, int startY, int endX, int endY, std::vector<uint32_t>& path,
+                  SolverMode mode = SolverMode::BFS); // No console output
+    const std::vector<uint32_t>& getSolution() const { return solution; } // Cell indices y * width + x
     
     // Debug and validation methods
-    bool isMazeConnected(); // Check if all cells are reachable
+    bool isMazeConnected() const; // All cells reachable from (0, 0); O(1) while edits are indexed, no output
+    size_t reachableCells(int x = 0, int y = 0) const { return reachability.fill(grid, x, y); }
+    size_t countPassages() const { return grid.countPassages(); } // cells - 1 for a perfect maze
+    
+    // Live editing (see MazeDynamicConnectivity). openWall / closeWall change
+    // the wall between two adjacent cells and return false, changing
+    // nothing, if the cells are not adjacent or the wall is already in that
+    // state. Queries after an edit cost O(log n) amortized instead of a
+    // traversal; the first edit or query after any other wall change
+    // indexes the maze in O(n).
+    bool openWall(int x1, int y1, int x2, int y2);
+    bool closeWall(int x1, int y1, int x2, int y2);
+    bool cellsConnected(int x1, int y1, int x2, int y2);
+    size_t componentCount();
+    const MazeDynamicConnectivity& getEditIndex() const { return connectivity; } // Counters; may be unbuilt
+    
+    // Shortest-path length between tracked endpoints, kept across edits:
+    // the forest distance while the maze has no loops or one door made
+    // its only loop; otherwise a distance field from the start, computed
+    // once and repaired locally after each edit
+    bool trackPath(int startX, int startY, int endX, int endY);
+    long long trackedPathLength(); // -1 if no path or nothing tracked
+    
+    // Dead ends, corridors, junctions, diameter, solution shape (see MazeAnalytics);
+    // O(cells), no output. Valid until the next analyze().
+    const MazeStats& analyze(int startX = 0, int startY = 0, int endX = -1, int endY = -1) const {
+        return analytics.analyze(grid, startX, startY, endX, endY);
+    }
 };
 
 #endif // MAZE_H
@@ -0,0 +1,181 @@
+#include "MazeAnalytics.h"
+#include <algorithm>
+#include <cstdlib>
+
+namespace {
+const uint32_t UNREACHED = 0xFFFFFFFFu;
+
+inline unsigned opposite(unsigned dir) {
+    return (dir + 2) & 3;
+}
+
+}
+
+size_t MazeAnalytics::memoryBytes() const {
+    return (distance.capacity() + queue.capacity()) * sizeof(uint32_t) + sides.capacity()
+         + result.corridorHistogram.capacity() * sizeof(size_t);
+}
+
+/**
+ * Breadth-first search over the whole reachable area; returns the last
+ * cell dequeued, which is one of the farthest from `start`
+ */
+uint32_t MazeAnalytics::bfs(const MazeGrid& grid, uint32_t start, size_t& reached) {
+    const int width = grid.getWidth();
+    std::fill(distance.begin(), distance.end(), UNREACHED);
+    size_t head = 0, tail = 0;
+    queue[tail++] = start;
+    distance[start] = 0;
+
+    uint32_t cell = start;
+    while (head < tail) {
+        cell = queue[head++];
+        unsigned open = sides[cell];
+        while (open) {
+            unsigned dir = static_cast<unsigned>(__builtin_ctz(open));
+            open &= open - 1;
+            uint32_t next = neighbourIndex(cell, dir, width);
+            if (distance[next] == UNREACHED) {
+                distance[next] = distance[cell] + 1;
+                queue[tail++] = next;
+            }
+        }
+    }
+    reached = tail;
+    return cell;
+}
+
+/**
+ * Open sides and degree counts of every cell
+ */
+void MazeAnalytics::countSides(const MazeGrid& grid) {
+    const int width = grid.getWidth();
+    const int height = grid.getHeight();
+    uint8_t* out = sides.data();
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            unsigned open = grid.openDirections(x, y);
+            *out++ = static_cast<uint8_t>(open);
+            result.degreeCounts[__builtin_popcount(open)]++;
+        }
+    }
+    result.passages = (result.degreeCounts[1] + 2 * result.degreeCounts[2] + 3 * result.degreeCounts[3] +
+                       4 * result.degreeCounts[4]) / 2;
+    result.deadEnds = result.degreeCounts[1];
+    result.junctions = result.degreeCounts[3] + result.degreeCounts[4];
+    if (result.junctions) {
+        result.branchingFactor = static_cast<double>(3 * result.degreeCounts[3] + 4 * result.degreeCounts[4]) /
+                                 static_cast<double>(result.junctions);
+    }
+}
+
+/**
+ * Every corridor, walked from each end that is not a two-sided cell. A
+ * corridor is counted from the end with the lower index (from the lower
+ * direction when both ends are the same cell).
+ */
+void MazeAnalytics::walkCorridors(const MazeGrid& grid) {
+    const int width = grid.getWidth();
+    size_t steps = 0;
+    size_t deadEndSteps = 0;
+    size_t deadEndCorridors = 0;
+
+    for (uint32_t cell = 0; cell < result.cells; cell++) {
+        int degree = __builtin_popcount(sides[cell]);
+        if (degree == 2) continue;
+
+        for (unsigned open = sides[cell]; open; open &= open - 1) {
+            unsigned dir = static_cast<unsigned>(__builtin_ctz(open));
+            uint32_t at = neighbourIndex(cell, dir, width);
+            unsigned entered = dir;
+            size_t length = 1;
+            unsigned atSides = sides[at];
+            while (__builtin_popcount(atSides) == 2) {
+                entered = static_cast<unsigned>(__builtin_ctz(atSides & ~(1u << opposite(entered))));
+                at = neighbourIndex(at, entered, width);
+                atSides = sides[at];
+                length++;
+            }
+            if (at < cell || (at == cell && opposite(entered) < dir)) continue;
+
+            if (length >= result.corridorHistogram.size()) result.corridorHistogram.resize(length + 1);
+            result.corridorHistogram[length]++;
+            result.corridors++;
+            result.longestCorridor = std::max(result.longestCorridor, length);
+            steps += length;
+            int deadEnds = (degree == 1) + (__builtin_popcount(atSides) == 1);
+            if (deadEnds) {
+                deadEndSteps += length * static_cast<size_t>(deadEnds);
+                deadEndCorridors += static_cast<size_t>(deadEnds);
+            }
+        }
+    }
+
+    if (result.corridors) result.meanCorridor = static_cast<double>(steps) / result.corridors;
+    if (deadEndCorridors) result.riverFactor = static_cast<double>(deadEndSteps) / deadEndCorridors;
+}
+
+/**
+ * Solution length and turns from the distances of the BFS from `start`,
+ * walking back from `end` through neighbours one step closer
+ */
+void MazeAnalytics::traceSolution(const MazeGrid& grid, uint32_t start, uint32_t end) {
+    if (distance[end] == UNREACHED) return;
+    const int width = grid.getWidth();
+    result.solutionLength = distance[end];
+
+    unsigned previous = 4;
+    for (uint32_t cell = end; cell != start;) {
+        unsigned open = sides[cell];
+        while (open) {
+            unsigned dir = static_cast<unsigned>(__builtin_ctz(open));
+            open &= open - 1;
+            uint32_t from = neighbourIndex(cell, dir, width);
+            if (distance[from] == distance[cell] - 1) {
+                if (previous != 4 && dir != previous) result.solutionTurns++;
+                previous = dir;
+                cell = from;
+                break;
+            }
+        }
+    }
+
+    long long manhattan = std::abs(static_cast<long long>(start % width) - static_cast<long long>(end % width)) +
+                          std::abs(static_cast<long long>(start / width) - static_cast<long long>(end / width));
+    if (manhattan > 0) result.tortuosity = static_cast<double>(result.solutionLength) / static_cast<double>(manhattan);
+}
+
+const MazeStats& MazeAnalytics::analyze(const MazeGrid& grid, int startX, int startY, int endX, int endY) {
+    // Reset in place, keeping the histogram's capacity
+    std::vector<size_t> histogram;
+    histogram.swap(result.corridorHistogram);
+    histogram.clear();
+    result = MazeStats();
+    result.corridorHistogram.swap(histogram);
+
+    if (endX == -1) endX = grid.getWidth() - 1;
+    if (endY == -1) endY = grid.getHeight() - 1;
+    if (!grid.inBounds(startX, startY) || !grid.inBounds(endX, endY)) return result;
+
+    result.cells = grid.cellCount();
+    if (distance.size() != result.cells) {
+        distance.assign(result.cells, UNREACHED);
+        queue.assign(result.cells, 0);
+        sides.assign(result.cells, 0);
+    }
+
+    countSides(grid);
+    walkCorridors(grid);
+
+    const uint32_t width = static_cast<uint32_t>(grid.getWidth());
+    uint32_t start = static_cast<uint32_t>(startY) * width + static_cast<uint32_t>(startX);
+    uint32_t end = static_cast<uint32_t>(endY) * width + static_cast<uint32_t>(endX);
+    uint32_t farthest = bfs(grid, start, result.reachable);
+    traceSolution(grid, start, end);
+
+    size_t reached;
+    result.diameterFrom = farthest;
+    result.diameterTo = bfs(grid, farthest, reached);
+    result.diameter = distance[result.diameterTo];
+    return result;
+}
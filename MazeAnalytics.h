@@ -0,0 +1,85 @@
+#ifndef MAZE_ANALYTICS_H
+#define MAZE_ANALYTICS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "MazeGrid.h"
+
+/**
+ * Structural statistics of one maze, as computed by MazeAnalytics.
+ * Cells are indices y * width + x, as in solver paths.
+ */
+struct MazeStats {
+    size_t cells = 0;
+    size_t passages = 0;              // Open walls; cells - 1 for a perfect maze
+    size_t reachable = 0;             // Cells reachable from the start
+    size_t degreeCounts[5] = {};      // Cells with 0-4 open sides
+    size_t deadEnds = 0;              // One open side
+    size_t junctions = 0;             // Three or four open sides
+    double branchingFactor = 0;       // Mean open sides of a junction
+
+    // Corridors: runs of two-sided cells between cells that are not
+    // two-sided, measured in steps. corridorHistogram[n] counts corridors
+    // of n steps (index 0 is unused).
+    std::vector<size_t> corridorHistogram;
+    size_t corridors = 0;
+    size_t longestCorridor = 0;
+    double meanCorridor = 0;
+
+    // Longest shortest path among the cells reachable from the start:
+    // exact for perfect mazes (two BFS passes), a lower bound with loops
+    uint32_t diameter = 0;
+    uint32_t diameterFrom = 0;
+    uint32_t diameterTo = 0;
+
+    // Solution from start to end; length -1 when there is none.
+    // Tortuosity is length / Manhattan distance (0 when undefined).
+    long long solutionLength = -1;
+    size_t solutionTurns = 0;
+    double tortuosity = 0;
+
+    // Mean steps from a dead end to the corridor's other end. High
+    // values mean few, long side branches ("river"); low values many
+    // short stubs.
+    double riverFactor = 0;
+};
+
+/**
+ * Reusable maze analytics context
+ *
+ * analyze() makes one pass over the walls for each cell's open sides
+ * and the degree counts, walks the corridors over those masks (each from
+ * both of its ends), then runs two BFS passes: from the start, which
+ * gives the solution and the farthest cell, and from that cell, which
+ * gives the diameter. The work is O(cells) and the walls are only read.
+ * The side masks, BFS queue, distances and histogram are owned by the
+ * context and sized once per maze size, so repeated queries on same-size
+ * mazes do not allocate.
+ */
+class MazeAnalytics {
+public:
+    /**
+     * Statistics for the maze, solving (startX, startY) -> (endX, endY);
+     * an end of -1 means the last column / row. Out-of-range points give
+     * an empty result (cells == 0). Valid until the next analyze().
+     */
+    const MazeStats& analyze(const MazeGrid& grid, int startX = 0, int startY = 0, int endX = -1, int endY = -1);
+
+    const MazeStats& stats() const { return result; }
+
+    size_t memoryBytes() const;
+
+private:
+    uint32_t bfs(const MazeGrid& grid, uint32_t start, size_t& reached);
+    void countSides(const MazeGrid& grid);
+    void walkCorridors(const MazeGrid& grid);
+    void traceSolution(const MazeGrid& grid, uint32_t start, uint32_t end);
+
+    MazeStats result;
+    std::vector<uint32_t> distance;
+    std::vector<uint32_t> queue;
+    std::vector<uint8_t> sides;   // Open-direction mask per cell, from the first pass
+};
+
+#endif // MAZE_ANALYTICS_H
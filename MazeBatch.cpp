@@ -0,0 +1,64 @@
+#include "MazeBatch.h"
+#include <algorithm>
+#include <chrono>
+
+MazeBatch::MazeBatch(int w, int h, size_t n)
+    : width(w > 0 ? w : 0), height(h > 0 ? h : 0), count(n),
+      planeWords(MazeGrid::planeWordsFor(w, h)), arena(n * 2 * planeWords, ~0ULL) {
+}
+
+/**
+ * SplitMix64-style mix of (seed, block index)
+ */
+uint32_t MazeBatch::blockSeed(unsigned int seed, size_t index) {
+    uint64_t z = (static_cast<uint64_t>(seed) << 32) ^ index;
+    z += 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return static_cast<uint32_t>(z ^ (z >> 31));
+}
+
+/**
+ * Generate all mazes, in blocks of consecutive slots per task
+ */
+void MazeBatch::generate(unsigned int seed, ThreadPool& pool, MazeAlgorithm algorithm,
+                         std::vector<uint64_t>* latencyNanos, RandomEngine engine) {
+    if (scratch.size() < static_cast<size_t>(pool.size())) {
+        scratch.resize(pool.size());
+    }
+    if (latencyNanos) {
+        latencyNanos->assign(count, 0);
+    }
+
+    const size_t tasks = (count + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    pool.parallelFor(tasks, [&](size_t task, int worker) {
+        WorkerScratch& local = scratch[worker];
+        size_t end = std::min(count, (task + 1) * BLOCK_SIZE);
+
+        // One stream per block: seeding an mt19937 costs about as much as
+        // generating a small maze, so it is done once per BLOCK_SIZE mazes
+        local.rng.setEngine(engine, blockSeed(seed, task));
+        for (size_t i = task * BLOCK_SIZE; i < end; i++) {
+            auto start = std::chrono::steady_clock::now();
+
+            uint64_t* east = arena.data() + i * 2 * planeWords;
+            local.view.attach(width, height, east, east + planeWords);
+            local.engine.generate(algorithm, local.view, local.rng);
+
+            if (latencyNanos) {
+                auto elapsed = std::chrono::steady_clock::now() - start;
+                (*latencyNanos)[i] = static_cast<uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+            }
+        }
+    });
+}
+
+/**
+ * Copy one maze out of the arena
+ */
+void MazeBatch::copyTo(size_t index, MazeGrid& grid) const {
+    grid.resize(width, height);
+    std::copy(eastPlane(index), eastPlane(index) + planeWords, grid.eastRow(0));
+    std::copy(southPlane(index), southPlane(index) + planeWords, grid.southRow(0));
+}
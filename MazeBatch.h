@@ -0,0 +1,70 @@
+#ifndef MAZE_BATCH_H
+#define MAZE_BATCH_H
+
+#include <cstdint>
+#include <vector>
+#include "MazeGenerators.h"
+#include "MazeGrid.h"
+#include "ThreadPool.h"
+
+/**
+ * Many mazes of one size generated into a single contiguous arena
+ *
+ * Maze i occupies 2 * MazeGrid::planeWordsFor(width, height) consecutive
+ * words: its east plane followed by its south plane, in MazeGrid's row
+ * format. Generation runs on a thread pool; every worker keeps one grid
+ * view, one generator engine and one RNG, so after the first maze on each
+ * worker no heap allocation happens per maze.
+ *
+ * Mazes are generated in fixed blocks of BLOCK_SIZE consecutive slots.
+ * Each block draws from its own MazeRandom stream seeded from (seed, block),
+ * mazes in order, so the batch is identical for any thread count.
+ */
+class MazeBatch {
+public:
+    MazeBatch(int w, int h, size_t count);
+
+    /**
+     * Generate every maze. If latencyNanos is given it receives the
+     * generation time of each maze (resized to size()).
+     */
+    void generate(unsigned int seed, ThreadPool& pool, MazeAlgorithm algorithm = MazeAlgorithm::DFS,
+                  std::vector<uint64_t>* latencyNanos = nullptr, RandomEngine engine = RandomEngine::MT19937);
+
+    static const size_t BLOCK_SIZE = 64;
+
+    /**
+     * Seed of the RNG stream for block `index` of a batch generated with `seed`
+     */
+    static uint32_t blockSeed(unsigned int seed, size_t index);
+
+    size_t size() const { return count; }
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+
+    const uint64_t* eastPlane(size_t index) const { return arena.data() + index * 2 * planeWords; }
+    const uint64_t* southPlane(size_t index) const { return eastPlane(index) + planeWords; }
+
+    /**
+     * Copy maze `index` into an owned grid, e.g. to solve or print it
+     */
+    void copyTo(size_t index, MazeGrid& grid) const;
+
+    size_t memoryBytes() const { return arena.capacity() * sizeof(uint64_t); }
+
+private:
+    struct WorkerScratch {
+        MazeGrid view;             // Attached to the arena slot being generated
+        MazeGeneratorEngine engine;
+        MazeRandom rng;
+    };
+
+    int width;
+    int height;
+    size_t count;
+    size_t planeWords;
+    std::vector<uint64_t> arena;
+    std::vector<WorkerScratch> scratch;  // One per pool worker
+};
+
+#endif // MAZE_BATCH_H
@@ -0,0 +1,141 @@
+#include "MazeDistanceField.h"
+#include <algorithm>
+#include <utility>
+
+namespace {
+inline unsigned openSides(const MazeGrid& grid, uint32_t cell, int width) {
+    return grid.openDirections(static_cast<int>(cell % width), static_cast<int>(cell / width));
+}
+}
+
+size_t MazeDistanceField::memoryBytes() const {
+    return (distances.capacity() + queue.capacity() + stamp.capacity()) * sizeof(uint32_t) +
+           seeds.capacity() * sizeof(uint64_t);
+}
+
+size_t MazeDistanceField::compute(const MazeGrid& grid, int x, int y) {
+    width = grid.getWidth();
+    const size_t cells = grid.cellCount();
+    distances.assign(cells, UNREACHED);
+    queue.resize(cells);
+    if (stamp.size() != cells) {
+        stamp.assign(cells, 0);
+        epoch = 0;
+    }
+    if (!grid.inBounds(x, y)) return 0;
+
+    uint32_t start = static_cast<uint32_t>(y) * static_cast<uint32_t>(width) + static_cast<uint32_t>(x);
+    size_t head = 0, tail = 0;
+    queue[tail++] = start;
+    distances[start] = 0;
+    while (head < tail) {
+        uint32_t cell = queue[head++];
+        for (unsigned open = openSides(grid, cell, width); open; open &= open - 1) {
+            uint32_t next = neighbourIndex(cell, static_cast<unsigned>(__builtin_ctz(open)), width);
+            if (distances[next] == UNREACHED) {
+                distances[next] = distances[cell] + 1;
+                queue[tail++] = next;
+            }
+        }
+    }
+    return tail;
+}
+
+void MazeDistanceField::opened(const MazeGrid& grid, int x, int y, Direction dir) {
+    uint32_t near = static_cast<uint32_t>(y) * static_cast<uint32_t>(width) + static_cast<uint32_t>(x);
+    uint32_t far = neighbourIndex(near, dir, width);
+    if (distances[near] > distances[far]) std::swap(near, far);
+    if (distances[near] == UNREACHED || distances[far] <= distances[near] + 1) return;
+
+    size_t head = 0, tail = 0;
+    distances[far] = distances[near] + 1;
+    queue[tail++] = far;
+    while (head < tail) {
+        uint32_t cell = queue[head++];
+        for (unsigned open = openSides(grid, cell, width); open; open &= open - 1) {
+            uint32_t next = neighbourIndex(cell, static_cast<unsigned>(__builtin_ctz(open)), width);
+            if (distances[next] > distances[cell] + 1) {
+                distances[next] = distances[cell] + 1;
+                queue[tail++] = next;
+            }
+        }
+    }
+    repaired += tail;
+}
+
+/**
+ * Whether the cell still has an unaffected neighbour one step closer
+ */
+bool MazeDistanceField::supported(const MazeGrid& grid, uint32_t cell) const {
+    for (unsigned open = openSides(grid, cell, width); open; open &= open - 1) {
+        uint32_t next = neighbourIndex(cell, static_cast<unsigned>(__builtin_ctz(open)), width);
+        if (distances[next] + 1 == distances[cell] && stamp[next] != epoch) return true;
+    }
+    return false;
+}
+
+void MazeDistanceField::closed(const MazeGrid& grid, int x, int y, Direction dir) {
+    uint32_t near = static_cast<uint32_t>(y) * static_cast<uint32_t>(width) + static_cast<uint32_t>(x);
+    uint32_t far = neighbourIndex(near, dir, width);
+    if (distances[near] == distances[far]) return;  // Also both unreached
+    if (distances[near] > distances[far]) std::swap(near, far);
+    if (epoch == UNREACHED) {
+        std::fill(stamp.begin(), stamp.end(), 0);
+        epoch = 0;
+    }
+    epoch++;
+    if (supported(grid, far)) return;
+
+    // Affected cells, in level order: a cell is affected once all of its
+    // neighbours one step closer are
+    size_t head = 0, tail = 0;
+    queue[tail++] = far;
+    stamp[far] = epoch;
+    while (head < tail) {
+        uint32_t cell = queue[head++];
+        for (unsigned open = openSides(grid, cell, width); open; open &= open - 1) {
+            uint32_t next = neighbourIndex(cell, static_cast<unsigned>(__builtin_ctz(open)), width);
+            if (distances[next] == distances[cell] + 1 && stamp[next] != epoch && !supported(grid, next)) {
+                stamp[next] = epoch;
+                queue[tail++] = next;
+            }
+        }
+    }
+    repaired += tail;
+
+    // Best distance of each through the unaffected cells around it
+    seeds.clear();
+    for (size_t i = 0; i < tail; i++) {
+        uint32_t cell = queue[i];
+        uint32_t best = UNREACHED;
+        for (unsigned open = openSides(grid, cell, width); open; open &= open - 1) {
+            uint32_t next = neighbourIndex(cell, static_cast<unsigned>(__builtin_ctz(open)), width);
+            if (stamp[next] != epoch && distances[next] != UNREACHED) best = std::min(best, distances[next] + 1);
+        }
+        if (best != UNREACHED) seeds.push_back(static_cast<uint64_t>(best) << 32 | cell);
+    }
+    for (size_t i = 0; i < tail; i++) distances[queue[i]] = UNREACHED;
+    std::sort(seeds.begin(), seeds.end());
+
+    // BFS among the affected cells, taking seeds as their distance comes up
+    size_t next = 0;
+    head = tail = 0;
+    while (next < seeds.size() || head < tail) {
+        uint32_t cell;
+        if (head == tail || (next < seeds.size() && (seeds[next] >> 32) <= distances[queue[head]])) {
+            cell = static_cast<uint32_t>(seeds[next]);
+            uint32_t seeded = static_cast<uint32_t>(seeds[next++] >> 32);
+            if (distances[cell] <= seeded) continue;
+            distances[cell] = seeded;
+        } else {
+            cell = queue[head++];
+        }
+        for (unsigned open = openSides(grid, cell, width); open; open &= open - 1) {
+            uint32_t after = neighbourIndex(cell, static_cast<unsigned>(__builtin_ctz(open)), width);
+            if (stamp[after] == epoch && distances[after] > distances[cell] + 1) {
+                distances[after] = distances[cell] + 1;
+                queue[tail++] = after;
+            }
+        }
+    }
+}
@@ -0,0 +1,63 @@
+#ifndef MAZE_DISTANCE_FIELD_H
+#define MAZE_DISTANCE_FIELD_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "MazeGrid.h"
+
+/**
+ * BFS distances from one cell, repaired in place as walls change
+ *
+ * compute() is a full BFS. After that, opened() and closed() - called
+ * right after each wall edit - only touch cells whose distance changes:
+ *
+ * - Opening a wall lowers distances from the nearer side: a BFS from the
+ *   farther cell that stops wherever a distance does not improve.
+ * - Closing a wall matters only if the farther cell has no other
+ *   neighbour one step closer. Then the cells that lose every such
+ *   neighbour are collected level by level, given the best distance
+ *   through an unaffected neighbour, and settled by a BFS that merges
+ *   those seeds in distance order (Ramalingam-Reps with unit weights).
+ *
+ * Distances are always exact. An edit costs about the number of cells
+ * whose distance changes (times log of it when closing), which is small
+ * for most edits in a maze with loops but a whole subtree when a wall on
+ * a tree-like stretch is cut. Cells are indices y * width + x.
+ */
+class MazeDistanceField {
+public:
+    static constexpr uint32_t UNREACHED = 0xFFFFFFFFu;
+
+    /**
+     * Distances from (x, y); returns the cells reached, 0 if out of range
+     */
+    size_t compute(const MazeGrid& grid, int x, int y);
+
+    /**
+     * The wall between (x, y) and its neighbour in dir was just removed /
+     * put back in the grid
+     */
+    void opened(const MazeGrid& grid, int x, int y, Direction dir);
+    void closed(const MazeGrid& grid, int x, int y, Direction dir);
+
+    uint32_t distance(uint32_t cell) const { return distances[cell]; }
+    const std::vector<uint32_t>& getDistances() const { return distances; }
+
+    size_t repairedCells() const { return repaired; }  // Cells updated by opened() / closed()
+
+    size_t memoryBytes() const;
+
+private:
+    bool supported(const MazeGrid& grid, uint32_t cell) const;
+
+    int width = 0;
+    size_t repaired = 0;
+    std::vector<uint32_t> distances;
+    std::vector<uint32_t> queue;
+    std::vector<uint32_t> stamp;       // Affected marks of closed(), by epoch
+    std::vector<uint64_t> seeds;       // Tentative distance << 32 | cell
+    uint32_t epoch = 0;
+};
+
+#endif // MAZE_DISTANCE_FIELD_H
@@ -0,0 +1,328 @@
+#include "MazeDynamicConnectivity.h"
+#include <algorithm>
+#include <utility>
+
+namespace {
+inline bool testBit(const std::vector<uint64_t>& plane, size_t i) {
+    return (plane[i >> 6] >> (i & 63)) & 1ULL;
+}
+}
+
+size_t MazeDynamicConnectivity::memoryBytes() const {
+    return nodes.capacity() * sizeof(Node) + (treeEast.capacity() + treeSouth.capacity()) * sizeof(uint64_t) +
+           (splayPath.capacity() + queueA.capacity() + queueB.capacity() + stamp.capacity()) * sizeof(uint32_t);
+}
+
+/**
+ * Spanning forest by BFS from every cell not yet reached. Each cell starts
+ * as its own splay tree whose path parent is its BFS parent, which is a
+ * valid link-cut tree with no preferred paths.
+ */
+void MazeDynamicConnectivity::build(const MazeGrid& grid) {
+    const size_t cells = grid.cellCount();
+    width = grid.getWidth();
+    stride = grid.getStride();
+    nodes.assign(cells, Node{{NONE, NONE}, NONE, 1, false});
+    treeEast.assign(grid.getPlaneWords(), 0);
+    treeSouth.assign(grid.getPlaneWords(), 0);
+    queueA.resize(cells);
+    queueB.resize(cells);
+    stamp.assign(cells, 0);
+    epoch = 1;
+    componentCount = 0;
+    searches = 0;
+    searchedCells = 0;
+
+    size_t treePassages = 0;
+    for (uint32_t root = 0; root < cells; root++) {
+        if (stamp[root]) continue;
+        componentCount++;
+        size_t head = 0, tail = 0;
+        queueA[tail++] = root;
+        stamp[root] = 1;
+        while (head < tail) {
+            uint32_t cell = queueA[head++];
+            int x = static_cast<int>(cell % width);
+            int y = static_cast<int>(cell / width);
+            unsigned open = grid.openDirections(x, y);
+            while (open) {
+                unsigned dir = static_cast<unsigned>(__builtin_ctz(open));
+                open &= open - 1;
+                uint32_t next = neighbourIndex(cell, dir, width);
+                if (stamp[next]) continue;
+                stamp[next] = 1;
+                nodes[next].parent = cell;
+                setTreeEdge(grid.bitIndex(x, y), static_cast<Direction>(dir), true);
+                treePassages++;
+                queueA[tail++] = next;
+            }
+        }
+    }
+    loopCount = grid.countPassages() - treePassages;
+    builtCells = cells;
+}
+
+/**
+ * Mark or unmark a forest passage given from either side
+ */
+void MazeDynamicConnectivity::setTreeEdge(size_t bit, Direction dir, bool on) {
+    std::vector<uint64_t>* plane = &treeEast;
+    switch (dir) {
+        case TOP:
+            bit -= stride;
+            plane = &treeSouth;
+            break;
+        case RIGHT:
+            break;
+        case BOTTOM:
+            plane = &treeSouth;
+            break;
+        case LEFT:
+            bit -= 1;
+            break;
+    }
+    uint64_t mask = 1ULL << (bit & 63);
+    if (on) (*plane)[bit >> 6] |= mask;
+    else (*plane)[bit >> 6] &= ~mask;
+}
+
+bool MazeDynamicConnectivity::treeEdge(size_t bit, Direction dir) const {
+    switch (dir) {
+        case TOP:
+            return testBit(treeSouth, bit - stride);
+        case RIGHT:
+            return testBit(treeEast, bit);
+        case BOTTOM:
+            return testBit(treeSouth, bit);
+        case LEFT:
+            return testBit(treeEast, bit - 1);
+    }
+    return false;
+}
+
+/**
+ * Bitmask (1 << Direction) of the forest passages of a cell
+ */
+unsigned MazeDynamicConnectivity::treeDirections(int x, int y) const {
+    size_t i = static_cast<size_t>(y) * stride + static_cast<size_t>(x);
+    unsigned tree = 0;
+    if (y > 0 && testBit(treeSouth, i - stride)) tree |= 1u << TOP;
+    if (testBit(treeEast, i)) tree |= 1u << RIGHT;
+    if (testBit(treeSouth, i)) tree |= 1u << BOTTOM;
+    if (x > 0 && testBit(treeEast, i - 1)) tree |= 1u << LEFT;
+    return tree;
+}
+
+void MazeDynamicConnectivity::update(uint32_t x) {
+    uint32_t size = 1;
+    if (nodes[x].child[0] != NONE) size += nodes[nodes[x].child[0]].size;
+    if (nodes[x].child[1] != NONE) size += nodes[nodes[x].child[1]].size;
+    nodes[x].size = size;
+}
+
+void MazeDynamicConnectivity::push(uint32_t x) {
+    Node& node = nodes[x];
+    if (!node.flip) return;
+    std::swap(node.child[0], node.child[1]);
+    if (node.child[0] != NONE) nodes[node.child[0]].flip ^= true;
+    if (node.child[1] != NONE) nodes[node.child[1]].flip ^= true;
+    node.flip = false;
+}
+
+void MazeDynamicConnectivity::rotate(uint32_t x) {
+    uint32_t p = nodes[x].parent;
+    uint32_t g = nodes[p].parent;
+    int side = nodes[p].child[1] == x;
+    if (!isSplayRoot(p)) nodes[g].child[nodes[g].child[1] == p] = x;
+    nodes[x].parent = g;
+
+    uint32_t inner = nodes[x].child[side ^ 1];
+    nodes[p].child[side] = inner;
+    if (inner != NONE) nodes[inner].parent = p;
+    nodes[x].child[side ^ 1] = p;
+    nodes[p].parent = x;
+    update(p);
+    update(x);
+}
+
+/**
+ * Bring x to the root of its splay tree, applying pending flips on the
+ * way down first
+ */
+void MazeDynamicConnectivity::splay(uint32_t x) {
+    splayPath.clear();
+    for (uint32_t y = x;; y = nodes[y].parent) {
+        splayPath.push_back(y);
+        if (isSplayRoot(y)) break;
+    }
+    for (size_t i = splayPath.size(); i-- > 0;) push(splayPath[i]);
+
+    while (!isSplayRoot(x)) {
+        uint32_t p = nodes[x].parent;
+        if (!isSplayRoot(p)) {
+            uint32_t g = nodes[p].parent;
+            bool sameSide = (nodes[p].child[0] == x) == (nodes[g].child[0] == p);
+            rotate(sameSide ? p : x);
+        }
+        rotate(x);
+    }
+}
+
+/**
+ * Make the path from x's tree root to x preferred, with x at the root of
+ * its splay tree and nothing deeper on the path
+ */
+void MazeDynamicConnectivity::access(uint32_t x) {
+    uint32_t last = NONE;
+    for (uint32_t y = x; y != NONE; last = y, y = nodes[y].parent) {
+        splay(y);
+        nodes[y].child[1] = last;
+        update(y);
+    }
+    splay(x);
+}
+
+void MazeDynamicConnectivity::makeRoot(uint32_t x) {
+    access(x);
+    nodes[x].flip ^= true;
+}
+
+uint32_t MazeDynamicConnectivity::findRoot(uint32_t x) {
+    access(x);
+    for (push(x); nodes[x].child[0] != NONE; push(x)) x = nodes[x].child[0];
+    splay(x);
+    return x;
+}
+
+void MazeDynamicConnectivity::link(uint32_t a, uint32_t b) {
+    makeRoot(a);
+    nodes[a].parent = b;
+}
+
+/**
+ * Remove the forest edge a - b: with a as the root, a is b's only
+ * predecessor on the path
+ */
+void MazeDynamicConnectivity::cut(uint32_t a, uint32_t b) {
+    makeRoot(a);
+    access(b);
+    nodes[b].child[0] = NONE;
+    nodes[a].parent = NONE;
+    update(b);
+}
+
+bool MazeDynamicConnectivity::connected(uint32_t a, uint32_t b) {
+    return a == b || findRoot(a) == findRoot(b);
+}
+
+long long MazeDynamicConnectivity::treeDistance(uint32_t a, uint32_t b) {
+    if (a == b) return 0;
+    makeRoot(a);
+    if (findRoot(b) != a) return -1;
+    access(b);
+    return static_cast<long long>(nodes[b].size) - 1;
+}
+
+bool MazeDynamicConnectivity::opened(const MazeGrid& grid, int x, int y, Direction dir) {
+    uint32_t a = static_cast<uint32_t>(y) * static_cast<uint32_t>(width) + static_cast<uint32_t>(x);
+    uint32_t b = neighbourIndex(a, dir, width);
+    if (connected(a, b)) {
+        loopCount++;
+        return false;
+    }
+    link(a, b);
+    setTreeEdge(grid.bitIndex(x, y), dir, true);
+    componentCount--;
+    return true;
+}
+
+void MazeDynamicConnectivity::closed(const MazeGrid& grid, int x, int y, Direction dir) {
+    size_t bit = grid.bitIndex(x, y);
+    if (!treeEdge(bit, dir)) {
+        loopCount--;
+        return;
+    }
+    uint32_t a = static_cast<uint32_t>(y) * static_cast<uint32_t>(width) + static_cast<uint32_t>(x);
+    uint32_t b = neighbourIndex(a, dir, width);
+    setTreeEdge(bit, dir, false);
+    cut(a, b);
+    if (loopCount > 0 && reconnect(grid, a, b)) {
+        loopCount--;  // A loop passage joined the forest
+    } else {
+        componentCount++;
+    }
+}
+
+/**
+ * After cutting a - b: walk both halves over forest passages, one cell
+ * each in turn, until one half has no cells left to visit. Any open
+ * passage leaving that (smaller) half goes to the other one, so the first
+ * found is linked in its place.
+ */
+bool MazeDynamicConnectivity::reconnect(const MazeGrid& grid, uint32_t a, uint32_t b) {
+    searches++;
+    if (epoch > 0xFFFFFFF0u) {
+        std::fill(stamp.begin(), stamp.end(), 0);
+        epoch = 1;
+    }
+    const uint32_t markA = ++epoch;
+    const uint32_t markB = ++epoch;
+
+    size_t headA = 0, tailA = 0, headB = 0, tailB = 0;
+    queueA[tailA++] = a;
+    stamp[a] = markA;
+    queueB[tailB++] = b;
+    stamp[b] = markB;
+
+    auto expand = [this](std::vector<uint32_t>& queue, size_t& head, size_t& tail, uint32_t mark) {
+        uint32_t cell = queue[head++];
+        unsigned tree = treeDirections(static_cast<int>(cell % width), static_cast<int>(cell / width));
+        while (tree) {
+            unsigned dir = static_cast<unsigned>(__builtin_ctz(tree));
+            tree &= tree - 1;
+            uint32_t next = neighbourIndex(cell, dir, width);
+            if (stamp[next] != mark) {
+                stamp[next] = mark;
+                queue[tail++] = next;
+            }
+        }
+    };
+
+    const std::vector<uint32_t>* half;
+    size_t count;
+    uint32_t mark;
+    for (;;) {
+        if (headA == tailA) {
+            half = &queueA;
+            count = tailA;
+            mark = markA;
+            break;
+        }
+        expand(queueA, headA, tailA, markA);
+        if (headB == tailB) {
+            half = &queueB;
+            count = tailB;
+            mark = markB;
+            break;
+        }
+        expand(queueB, headB, tailB, markB);
+    }
+    searchedCells += tailA + tailB;
+
+    for (size_t i = 0; i < count; i++) {
+        uint32_t cell = (*half)[i];
+        int x = static_cast<int>(cell % width);
+        int y = static_cast<int>(cell / width);
+        unsigned loops = grid.openDirections(x, y) & ~treeDirections(x, y);
+        while (loops) {
+            unsigned dir = static_cast<unsigned>(__builtin_ctz(loops));
+            loops &= loops - 1;
+            uint32_t next = neighbourIndex(cell, dir, width);
+            if (stamp[next] == mark) continue;
+            link(cell, next);
+            setTreeEdge(grid.bitIndex(x, y), static_cast<Direction>(dir), true);
+            return true;
+        }
+    }
+    return false;
+}
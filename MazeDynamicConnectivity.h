@@ -0,0 +1,127 @@
+#ifndef MAZE_DYNAMIC_CONNECTIVITY_H
+#define MAZE_DYNAMIC_CONNECTIVITY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "MazeGrid.h"
+
+/**
+ * Connectivity of a maze that is edited wall by wall
+ *
+ * A spanning forest of the open passages is kept in a link-cut tree
+ * (splay-tree paths with lazy reversal, so any cell can be made the
+ * root). Passages in the forest are marked in two bit planes laid out
+ * like the grid's wall planes; every other open passage closes a loop
+ * and is only counted.
+ *
+ * - Opening a wall links the two trees if the cells were apart, else it
+ *   adds a loop passage. O(log n) amortized.
+ * - Closing a loop passage is O(1); closing a forest passage cuts it in
+ *   O(log n) amortized. If the maze has loops, a replacement passage is
+ *   then looked for: both halves are walked over forest passages in
+ *   lockstep until the smaller one is exhausted, and that half's open
+ *   loop passages are scanned for one leading out of it. This is
+ *   O(smaller half), not polylog, but it only happens when a forest
+ *   passage is closed in a maze that has loops. Perfect mazes, which
+ *   every generator produces, never need it.
+ * - connected() and treeDistance() are O(log n) amortized. While the maze
+ *   has no loops the forest path is the only path, so treeDistance() is
+ *   the exact shortest-path length.
+ *
+ * Cells are indices y * width + x. The structure follows a grid only
+ * through opened() and closed(), called right after each wall edit;
+ * after any other change to the walls, build() again.
+ */
+class MazeDynamicConnectivity {
+public:
+    static constexpr uint32_t NONE = 0xFFFFFFFFu;
+
+    /**
+     * Index the grid's open passages: a BFS spanning forest, O(n)
+     */
+    void build(const MazeGrid& grid);
+
+    /**
+     * Forget the grid (scratch is kept); build() before the next use
+     */
+    void clear() { builtCells = 0; }
+    bool isBuilt() const { return builtCells != 0; }
+
+    /**
+     * The wall between (x, y) and its neighbour in dir was just removed /
+     * put back in the grid. The wall must have changed state. opened()
+     * returns true if the passage joined two components.
+     */
+    bool opened(const MazeGrid& grid, int x, int y, Direction dir);
+    void closed(const MazeGrid& grid, int x, int y, Direction dir);
+
+    bool connected(uint32_t a, uint32_t b);
+
+    /**
+     * Steps along the forest path between two cells, -1 if they are not
+     * connected. The shortest-path length whenever isForest().
+     */
+    long long treeDistance(uint32_t a, uint32_t b);
+
+    size_t components() const { return componentCount; }
+    size_t loopPassages() const { return loopCount; }   // Open passages outside the forest
+    bool isForest() const { return loopCount == 0; }
+
+    size_t replacementSearches() const { return searches; }  // Forest cuts that had to search
+    size_t replacementCells() const { return searchedCells; } // Cells walked by those searches
+
+    size_t memoryBytes() const;
+
+private:
+    // One link-cut tree node per cell. Splay children and the parent are
+    // cells; a parent that does not list the node as a child is the path
+    // parent of the node's splay tree.
+    struct Node {
+        uint32_t child[2];
+        uint32_t parent;
+        uint32_t size;    // Nodes in this splay subtree
+        bool flip;        // Children of this subtree still to be swapped
+    };
+
+    bool isSplayRoot(uint32_t x) const {
+        uint32_t p = nodes[x].parent;
+        return p == NONE || (nodes[p].child[0] != x && nodes[p].child[1] != x);
+    }
+    void update(uint32_t x);
+    void push(uint32_t x);
+    void rotate(uint32_t x);
+    void splay(uint32_t x);
+    void access(uint32_t x);
+    void makeRoot(uint32_t x);
+    uint32_t findRoot(uint32_t x);
+    void link(uint32_t a, uint32_t b);
+    void cut(uint32_t a, uint32_t b);
+
+    // Forest passage marks, by a cell's grid bit index and a direction
+    bool treeEdge(size_t bit, Direction dir) const;
+    void setTreeEdge(size_t bit, Direction dir, bool on);
+    unsigned treeDirections(int x, int y) const;
+    bool reconnect(const MazeGrid& grid, uint32_t a, uint32_t b);
+
+    size_t builtCells = 0;
+    int width = 0;
+    size_t stride = 0;
+    size_t componentCount = 0;
+    size_t loopCount = 0;
+    size_t searches = 0;
+    size_t searchedCells = 0;
+
+    std::vector<Node> nodes;
+    std::vector<uint64_t> treeEast;   // Same layout as the grid's wall planes
+    std::vector<uint64_t> treeSouth;
+    std::vector<uint32_t> splayPath;  // push() order for splay()
+
+    // Replacement search: one queue per half, cells stamped with the half
+    std::vector<uint32_t> queueA;
+    std::vector<uint32_t> queueB;
+    std::vector<uint32_t> stamp;
+    uint32_t epoch = 0;
+};
+
+#endif // MAZE_DYNAMIC_CONNECTIVITY_H
@@ -0,0 +1,217 @@
+#include "MazeFile.h"
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <fstream>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+const char MAGIC[8] = {'M', 'A', 'Z', 'E', 'G', 'R', 'I', 'D'};
+const uint32_t FLAG_REPLAYABLE = 1;
+const int RANDOM_ENGINE_SHIFT = 8;  // Flags bits 8-15; 0 (mt19937) in files from before the field existed
+
+const bool LITTLE_ENDIAN_HOST = __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__;
+
+void putLE(unsigned char* buffer, uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; i++) {
+        buffer[i] = static_cast<unsigned char>((value >> (8 * i)) & 0xFF);
+    }
+}
+
+uint64_t getLE(const unsigned char* buffer, int bytes) {
+    uint64_t value = 0;
+    for (int i = 0; i < bytes; i++) {
+        value |= static_cast<uint64_t>(buffer[i]) << (8 * i);
+    }
+    return value;
+}
+
+uint64_t headerChecksum(const unsigned char* header) {
+    uint64_t words[7];
+    for (int i = 0; i < 7; i++) words[i] = getLE(header + 8 * i, 8);
+    return mazeFileChecksum(words, 7);
+}
+
+/**
+ * The planes need not be adjacent in memory, so each gets its own sum
+ */
+uint64_t planesChecksum(const uint64_t* east, const uint64_t* south, size_t planeWords) {
+    uint64_t southSum = mazeFileChecksum(south, planeWords);
+    return mazeFileChecksum(east, planeWords) ^ (southSum << 1 | southSum >> 63);
+}
+}
+
+const char* mazeFileStatusName(MazeFileStatus status) {
+    switch (status) {
+        case MazeFileStatus::OK: return "ok";
+        case MazeFileStatus::OPEN_FAILED: return "cannot open file";
+        case MazeFileStatus::WRITE_FAILED: return "write failed";
+        case MazeFileStatus::BAD_HEADER: return "not a valid maze file";
+        case MazeFileStatus::UNSUPPORTED_VERSION: return "unsupported maze file version";
+        case MazeFileStatus::TRUNCATED: return "file size does not match header";
+        case MazeFileStatus::CHECKSUM_MISMATCH: return "checksum mismatch (corrupted walls)";
+    }
+    return "unknown";
+}
+
+/**
+ * Four independent multiply-xorshift lanes, folded at the end; one
+ * multiply per word without a serial dependency on a single lane
+ */
+uint64_t mazeFileChecksum(const uint64_t* words, size_t count) {
+    const uint64_t PRIME = 0x9E3779B97F4A7C15ULL;
+    uint64_t lanes[4] = {count, PRIME, ~count, PRIME >> 1};
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        for (int l = 0; l < 4; l++) {
+            uint64_t v = (lanes[l] ^ words[i + l]) * PRIME;
+            lanes[l] = v ^ (v >> 29);
+        }
+    }
+    for (; i < count; i++) {
+        uint64_t v = (lanes[0] ^ words[i]) * PRIME;
+        lanes[0] = v ^ (v >> 29);
+    }
+    uint64_t hash = 0;
+    for (uint64_t lane : lanes) {
+        hash = (hash ^ lane) * PRIME;
+        hash ^= hash >> 32;
+    }
+    return hash;
+}
+
+/**
+ * Header, then both planes written straight from the grid (byte-swapped
+ * through a small buffer on big-endian hosts)
+ */
+MazeFileStatus writeMazeFile(const std::string& path, const MazeGrid& grid, const MazeOrigin& origin) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) return MazeFileStatus::OPEN_FAILED;
+
+    const size_t planeWords = grid.getPlaneWords();
+    const uint64_t* east = grid.cellCount() ? grid.eastRow(0) : nullptr;
+    const uint64_t* south = grid.cellCount() ? grid.southRow(0) : nullptr;
+
+    unsigned char header[MAZE_FILE_HEADER_BYTES] = {};
+    std::memcpy(header, MAGIC, 8);
+    putLE(header + 8, MAZE_FILE_VERSION, 4);
+    putLE(header + 12, MAZE_FILE_HEADER_BYTES, 4);
+    putLE(header + 16, static_cast<uint32_t>(grid.getWidth()), 4);
+    putLE(header + 20, static_cast<uint32_t>(grid.getHeight()), 4);
+    putLE(header + 24, origin.seed, 4);
+    putLE(header + 28, static_cast<uint32_t>(origin.algorithm), 4);
+    putLE(header + 32, static_cast<uint32_t>(origin.tileSize), 4);
+    putLE(header + 36, (origin.replayable ? FLAG_REPLAYABLE : 0) |
+                           (static_cast<uint32_t>(origin.random) << RANDOM_ENGINE_SHIFT), 4);
+    putLE(header + 40, planeWords, 8);
+    putLE(header + 48, planesChecksum(east, south, planeWords), 8);
+    putLE(header + 56, headerChecksum(header), 8);
+    out.write(reinterpret_cast<const char*>(header), MAZE_FILE_HEADER_BYTES);
+
+    for (const uint64_t* plane : {east, south}) {
+        if (LITTLE_ENDIAN_HOST) {
+            out.write(reinterpret_cast<const char*>(plane), static_cast<std::streamsize>(planeWords * 8));
+            continue;
+        }
+        unsigned char buffer[8 * 512];
+        for (size_t w = 0; w < planeWords; w += 512) {
+            size_t n = std::min<size_t>(512, planeWords - w);
+            for (size_t i = 0; i < n; i++) putLE(buffer + 8 * i, plane[w + i], 8);
+            out.write(reinterpret_cast<const char*>(buffer), static_cast<std::streamsize>(n * 8));
+        }
+    }
+
+    out.flush();
+    return out ? MazeFileStatus::OK : MazeFileStatus::WRITE_FAILED;
+}
+
+MappedMazeFile::~MappedMazeFile() {
+    close();
+}
+
+void MappedMazeFile::close() {
+    if (data) munmap(data, length);
+    data = nullptr;
+    planes = nullptr;
+    length = planeWords = 0;
+    width = height = 0;
+    origin = MazeOrigin();
+}
+
+/**
+ * Map the file, validate the header and size, optionally verify the planes
+ */
+MazeFileStatus MappedMazeFile::open(const std::string& path, bool verifyChecksum) {
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return MazeFileStatus::OPEN_FAILED;
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        ::close(fd);
+        return MazeFileStatus::OPEN_FAILED;
+    }
+    size_t size = static_cast<size_t>(info.st_size);
+    if (size < MAZE_FILE_HEADER_BYTES) {
+        ::close(fd);
+        return MazeFileStatus::BAD_HEADER;
+    }
+
+    // Private writable mapping: copy-on-write, never written back
+    void* mapped = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) return MazeFileStatus::OPEN_FAILED;
+    data = mapped;
+    length = size;
+
+    const unsigned char* header = static_cast<const unsigned char*>(data);
+    MazeFileStatus status = MazeFileStatus::OK;
+    uint64_t w = getLE(header + 16, 4);
+    uint64_t h = getLE(header + 20, 4);
+    uint64_t words = getLE(header + 40, 8);
+    uint64_t algorithm = getLE(header + 28, 4);
+    uint64_t random = (getLE(header + 36, 4) >> RANDOM_ENGINE_SHIFT) & 0xFF;
+    if (std::memcmp(header, MAGIC, 8) != 0 || getLE(header + 56, 8) != headerChecksum(header)) {
+        status = MazeFileStatus::BAD_HEADER;
+    } else if (getLE(header + 8, 4) != MAZE_FILE_VERSION) {
+        status = MazeFileStatus::UNSUPPORTED_VERSION;
+    } else if (getLE(header + 12, 4) != MAZE_FILE_HEADER_BYTES || w > INT_MAX || h > INT_MAX ||
+               algorithm >= static_cast<uint64_t>(MAZE_ALGORITHM_COUNT) || getLE(header + 32, 4) > INT_MAX ||
+               random >= static_cast<uint64_t>(RANDOM_ENGINE_COUNT) ||
+               words != MazeGrid::planeWordsFor(static_cast<int>(w), static_cast<int>(h))) {
+        status = MazeFileStatus::BAD_HEADER;
+    } else if (size != MAZE_FILE_HEADER_BYTES + 16 * words) {
+        status = MazeFileStatus::TRUNCATED;
+    }
+    if (status != MazeFileStatus::OK) {
+        close();
+        return status;
+    }
+
+    width = static_cast<int>(w);
+    height = static_cast<int>(h);
+    planeWords = static_cast<size_t>(words);
+    planes = reinterpret_cast<uint64_t*>(static_cast<unsigned char*>(data) + MAZE_FILE_HEADER_BYTES);
+    origin.seed = static_cast<unsigned int>(getLE(header + 24, 4));
+    origin.algorithm = static_cast<MazeAlgorithm>(algorithm);
+    origin.tileSize = static_cast<int>(getLE(header + 32, 4));
+    origin.replayable = (getLE(header + 36, 4) & FLAG_REPLAYABLE) != 0;
+    origin.random = static_cast<RandomEngine>(random);
+
+    if (!LITTLE_ENDIAN_HOST) {
+        // Swap in place; the pages are private copies
+        for (size_t i = 0; i < 2 * planeWords; i++) {
+            planes[i] = getLE(reinterpret_cast<const unsigned char*>(planes + i), 8);
+        }
+    }
+
+    if (verifyChecksum && planesChecksum(eastPlane(), southPlane(), planeWords) != getLE(header + 48, 8)) {
+        close();
+        return MazeFileStatus::CHECKSUM_MISMATCH;
+    }
+    return MazeFileStatus::OK;
+}
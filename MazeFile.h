@@ -0,0 +1,100 @@
+#ifndef MAZE_FILE_H
+#define MAZE_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "MazeGenerators.h"
+#include "MazeGrid.h"
+
+/**
+ * How a maze's walls were produced, as recorded in a maze file
+ */
+struct MazeOrigin {
+    unsigned int seed = 0;
+    MazeAlgorithm algorithm = MazeAlgorithm::DFS;
+    int tileSize = 0;         // generateParallel tile size, 0 for serial generation
+    RandomEngine random = RandomEngine::MT19937;
+    bool replayable = false;  // Generating (algorithm, seed, tileSize, random) again gives the same walls
+};
+
+/**
+ * Outcome of reading or writing a maze file
+ */
+enum class MazeFileStatus {
+    OK,
+    OPEN_FAILED,
+    WRITE_FAILED,
+    BAD_HEADER,           // Wrong magic, impossible dimensions or header checksum
+    UNSUPPORTED_VERSION,
+    TRUNCATED,            // File size does not match the header
+    CHECKSUM_MISMATCH     // Wall planes were corrupted
+};
+
+const char* mazeFileStatusName(MazeFileStatus status);
+
+/**
+ * Binary maze file, version 1
+ *
+ * Layout (all integers little-endian), 64-byte header:
+ *   0  char[8]  magic "MAZEGRID"
+ *   8  uint32   version (1)
+ *  12  uint32   header size (64)
+ *  16  uint32   width
+ *  20  uint32   height
+ *  24  uint32   seed
+ *  28  uint32   algorithm (MazeAlgorithm)
+ *  32  uint32   tile size (0 = serial generation)
+ *  36  uint32   flags (bit 0: replayable from seed; bits 8-15: RandomEngine)
+ *  40  uint64   plane words P = MazeGrid::planeWordsFor(width, height)
+ *  48  uint64   plane checksum: C(east) ^ rotl(C(south), 1), C = mazeFileChecksum
+ *  56  uint64   checksum of header bytes 0..55
+ * then the east plane (P words) and the south plane (P words), exactly in
+ * MazeGrid's row format, so a mapped file can back a MazeGrid directly.
+ */
+const size_t MAZE_FILE_HEADER_BYTES = 64;
+const uint32_t MAZE_FILE_VERSION = 1;
+
+/**
+ * Word-wise checksum used for the wall planes
+ */
+uint64_t mazeFileChecksum(const uint64_t* words, size_t count);
+
+MazeFileStatus writeMazeFile(const std::string& path, const MazeGrid& grid, const MazeOrigin& origin);
+
+/**
+ * Read-only view of a maze file mapped into memory (MAP_PRIVATE)
+ *
+ * open() maps the whole file and validates the header; the wall planes
+ * are only read if verifyChecksum is set. The pages are copy-on-write, so
+ * a grid attached to them can even be modified without touching the file.
+ */
+class MappedMazeFile {
+public:
+    MappedMazeFile() = default;
+    ~MappedMazeFile();
+
+    MappedMazeFile(const MappedMazeFile&) = delete;
+    MappedMazeFile& operator=(const MappedMazeFile&) = delete;
+
+    MazeFileStatus open(const std::string& path, bool verifyChecksum = true);
+    void close();
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    const MazeOrigin& getOrigin() const { return origin; }
+    uint64_t* eastPlane() const { return planes; }
+    uint64_t* southPlane() const { return planes + planeWords; }
+    size_t mappedBytes() const { return length; }
+
+private:
+    void* data = nullptr;
+    size_t length = 0;
+    int width = 0;
+    int height = 0;
+    size_t planeWords = 0;
+    uint64_t* planes = nullptr;
+    MazeOrigin origin;
+};
+
+#endif // MAZE_FILE_H
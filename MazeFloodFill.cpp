@@ -0,0 +1,323 @@
+#include "MazeFloodFill.h"
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define MAZE_FLOOD_X86 1
+#endif
+
+namespace {
+const int FILL_SHIFTS[6] = {1, 2, 4, 8, 16, 32};
+
+/**
+ * Spread `seeds` towards higher bits along the runs of cells joined by
+ * `eastOpen` (bit x set: x and x + 1 are joined). Run ends are the clear
+ * bits of eastOpen; subtracting the seeds that are not run ends borrows
+ * from each one up to its run's end, which flips exactly those bits.
+ */
+inline uint64_t fillUp(uint64_t seeds, uint64_t eastOpen) {
+    uint64_t ends = ~eastOpen;
+    return ((ends - (seeds & eastOpen)) ^ ends) | seeds;
+}
+
+/**
+ * Spread `seeds` along the runs both ways within one word. Borrows only
+ * run upwards, so the downward half is a shift-and-mask (Kogge-Stone) fill.
+ */
+inline uint64_t fillWord(uint64_t seeds, uint64_t eastOpen) {
+    seeds = fillUp(seeds, eastOpen);
+    uint64_t left = eastOpen;
+    for (int shift : FILL_SHIFTS) {
+        seeds |= left & (seeds >> shift);
+        left &= left >> shift;
+    }
+    return seeds;
+}
+
+// Bits of word w that belong to columns [0, limit)
+uint64_t columnMask(size_t w, int limit) {
+    size_t first = w * 64;
+    if (limit <= 0 || static_cast<size_t>(limit) <= first) return 0;
+    size_t n = static_cast<size_t>(limit) - first;
+    return n >= 64 ? ~0ULL : (1ULL << n) - 1;
+}
+
+/**
+ * One row of a tile: its reached cells plus the seeds from the rows above
+ * and below (through the open south walls `upOpen` and `downOpen`; a
+ * missing row is passed as a zero mask) and from the neighbouring tiles
+ * (`leftEdge` for word 0, `rightEdge` for word 3), filled along each
+ * word's runs
+ */
+void fillRowScalar(const uint64_t* reached, const uint64_t* up, const uint64_t* upOpen, const uint64_t* down,
+                   const uint64_t* downOpen, const uint64_t* east, uint64_t leftEdge, uint64_t rightEdge,
+                   uint64_t out[4]) {
+    for (size_t i = 0; i < MazeFloodFill::BLOCK_WORDS; i++) {
+        uint64_t seeds = reached[i] | (up[i] & upOpen[i]) | (down[i] & downOpen[i]);
+        if (i == 0) seeds |= leftEdge;
+        if (i == MazeFloodFill::BLOCK_WORDS - 1) seeds |= rightEdge;
+        out[i] = fillWord(seeds, east[i]);
+    }
+}
+
+#ifdef MAZE_FLOOD_X86
+__attribute__((target("avx2"))) inline __m256i load256(const uint64_t* p) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+}
+
+/**
+ * Reverse the bits of each 64-bit lane: nibbles through a lookup table,
+ * then bytes
+ */
+__attribute__((target("avx2"))) inline __m256i reverseBits(__m256i x) {
+    const __m256i nibble = _mm256_set1_epi8(0x0F);
+    const __m256i low = _mm256_setr_epi8(0x00, 0x80, 0x40, 0xC0, 0x20, 0xA0, 0x60, 0xE0, 0x10, 0x90, 0x50, 0xD0,
+                                         0x30, 0xB0, 0x70, 0xF0, 0x00, 0x80, 0x40, 0xC0, 0x20, 0xA0, 0x60, 0xE0,
+                                         0x10, 0x90, 0x50, 0xD0, 0x30, 0xB0, 0x70, 0xF0);
+    const __m256i high = _mm256_setr_epi8(0x0, 0x8, 0x4, 0xC, 0x2, 0xA, 0x6, 0xE, 0x1, 0x9, 0x5, 0xD, 0x3, 0xB,
+                                          0x7, 0xF, 0x0, 0x8, 0x4, 0xC, 0x2, 0xA, 0x6, 0xE, 0x1, 0x9, 0x5, 0xD,
+                                          0x3, 0xB, 0x7, 0xF);
+    const __m256i bytes = _mm256_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2,
+                                           1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+    __m256i reversed = _mm256_or_si256(_mm256_shuffle_epi8(low, _mm256_and_si256(x, nibble)),
+                                       _mm256_shuffle_epi8(high, _mm256_and_si256(_mm256_srli_epi16(x, 4), nibble)));
+    return _mm256_shuffle_epi8(reversed, bytes);
+}
+
+/**
+ * fillUp() per lane
+ */
+__attribute__((target("avx2"))) inline __m256i fillUpAvx2(__m256i seeds, __m256i eastOpen) {
+    __m256i ends = _mm256_xor_si256(eastOpen, _mm256_set1_epi64x(-1));
+    __m256i borrowed = _mm256_sub_epi64(ends, _mm256_and_si256(seeds, eastOpen));
+    return _mm256_or_si256(_mm256_xor_si256(borrowed, ends), seeds);
+}
+
+/**
+ * AVX2 row fill: upwards by borrows, then downwards as an upward fill of
+ * the bit-reversed lanes (x joined to x - 1 becomes 63 - x joined to 64 - x)
+ */
+__attribute__((target("avx2"))) void fillRowAvx2(const uint64_t* reached, const uint64_t* up, const uint64_t* upOpen,
+                                                 const uint64_t* down, const uint64_t* downOpen,
+                                                 const uint64_t* east, uint64_t leftEdge, uint64_t rightEdge,
+                                                 uint64_t out[4]) {
+    __m256i edges = _mm256_setr_epi64x(static_cast<long long>(leftEdge), 0, 0, static_cast<long long>(rightEdge));
+    __m256i seeds = _mm256_or_si256(load256(reached), edges);
+    seeds = _mm256_or_si256(seeds, _mm256_and_si256(load256(up), load256(upOpen)));
+    seeds = _mm256_or_si256(seeds, _mm256_and_si256(load256(down), load256(downOpen)));
+
+    __m256i joined = load256(east);
+    __m256i joinedBelow = reverseBits(_mm256_slli_epi64(joined, 1));
+    seeds = fillUpAvx2(seeds, joined);
+    seeds = reverseBits(fillUpAvx2(reverseBits(seeds), joinedBelow));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), seeds);
+}
+
+bool cpuHasAvx2() {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+}
+
+const bool AVX2_SUPPORTED = cpuHasAvx2();
+bool avx2Enabled = AVX2_SUPPORTED;
+#else
+bool avx2Enabled = false;
+#endif
+}
+
+bool MazeFloodFill::vectorized() {
+    return avx2Enabled;
+}
+
+void MazeFloodFill::setVectorized(bool enable) {
+#ifdef MAZE_FLOOD_X86
+    avx2Enabled = enable && AVX2_SUPPORTED;
+#else
+    (void)enable;
+#endif
+}
+
+/**
+ * Open-passage planes in the padded block layout; the last column has no
+ * east passage and the last row no south passage, so fills never leave
+ * the maze
+ */
+void MazeFloodFill::prepare(const MazeGrid& grid) {
+    width = grid.getWidth();
+    height = grid.getHeight();
+    size_t rowWords = grid.getRowWords();
+    blocksPerRow = (rowWords + BLOCK_WORDS - 1) / BLOCK_WORDS;
+    stride = blocksPerRow * BLOCK_WORDS;
+    size_t words = stride * static_cast<size_t>(height);
+    size_t tiles = blocksPerRow * ((static_cast<size_t>(height) + TILE_ROWS - 1) / TILE_ROWS);
+
+    eastOpen.assign(words, 0);
+    southOpen.assign(words, 0);
+    reachedBits.assign(words, 0);
+    dirtyRows.assign(tiles, 0);
+    work.clear();
+    for (int y = 0; y < height; y++) {
+        const uint64_t* east = grid.eastRow(y);
+        const uint64_t* south = grid.southRow(y);
+        uint64_t* eastOut = eastOpen.data() + static_cast<size_t>(y) * stride;
+        uint64_t* southOut = southOpen.data() + static_cast<size_t>(y) * stride;
+        for (size_t w = 0; w < rowWords; w++) {
+            eastOut[w] = ~east[w] & columnMask(w, width - 1);
+            if (y < height - 1) southOut[w] = ~south[w] & columnMask(w, width);
+        }
+    }
+}
+
+void MazeFloodFill::push(size_t tileRow, size_t block, uint64_t rows) {
+    size_t id = tileRow * blocksPerRow + block;
+    if (!dirtyRows[id]) work.push_back(static_cast<uint32_t>(id));
+    dirtyRows[id] |= rows;
+}
+
+/**
+ * Refill row y of one tile from the rows above and below and the tiles to
+ * the left and right. Returns the directions (UP, DOWN, LEFT, RIGHT) in
+ * which a reached cell of the row has an open wall to an unreached cell.
+ */
+unsigned MazeFloodFill::updateRow(size_t y, size_t block) {
+    static const uint64_t NONE[BLOCK_WORDS] = {0, 0, 0, 0};
+    const size_t base = y * stride + block * BLOCK_WORDS;
+    const bool hasLeft = block > 0;
+    const bool hasRight = block + 1 < blocksPerRow;
+    uint64_t* reached = reachedBits.data() + base;
+    const uint64_t* east = eastOpen.data() + base;
+    const uint64_t* up = y > 0 ? reached - stride : NONE;
+    const uint64_t* upOpen = y > 0 ? southOpen.data() + base - stride : NONE;
+    const uint64_t* down = y + 1 < static_cast<size_t>(height) ? reached + stride : NONE;
+    const uint64_t* downOpen = southOpen.data() + base;  // Zero in the last row
+
+    uint64_t leftEdge = hasLeft ? (reached[-1] & east[-1]) >> 63 : 0;
+    uint64_t rightEdge = hasRight ? (reached[BLOCK_WORDS] & east[BLOCK_WORDS - 1] >> 63) << 63 : 0;
+
+    uint64_t filled[BLOCK_WORDS];
+#ifdef MAZE_FLOOD_X86
+    if (avx2Enabled) {
+        fillRowAvx2(reached, up, upOpen, down, downOpen, east, leftEdge, rightEdge, filled);
+    } else
+#endif
+    {
+        fillRowScalar(reached, up, upOpen, down, downOpen, east, leftEdge, rightEdge, filled);
+    }
+
+    // Runs that cross word boundaries inside the tile (rarely unfinished)
+    uint64_t unfinished = 0;
+    for (size_t i = 0; i + 1 < BLOCK_WORDS; i++) {
+        unfinished |= (east[i] >> 63) & ((filled[i] >> 63) ^ (filled[i + 1] & 1));
+    }
+    bool carried = unfinished != 0;
+    while (carried) {
+        carried = false;
+        for (size_t i = 0; i + 1 < BLOCK_WORDS; i++) {
+            if (!(east[i] >> 63)) continue;
+            if ((filled[i] >> 63) && !(filled[i + 1] & 1)) {
+                filled[i + 1] = fillWord(filled[i + 1] | 1, east[i + 1]);
+                carried = true;
+            }
+            if ((filled[i + 1] & 1) && !(filled[i] >> 63)) {
+                filled[i] = fillWord(filled[i] | 1ULL << 63, east[i]);
+                carried = true;
+            }
+        }
+    }
+
+    uint64_t toUp = 0;
+    uint64_t toDown = 0;
+    for (size_t i = 0; i < BLOCK_WORDS; i++) {
+        reachedCount += static_cast<size_t>(__builtin_popcountll(filled[i] & ~reached[i]));
+        reached[i] = filled[i];
+        toUp |= filled[i] & upOpen[i] & ~up[i];
+        toDown |= filled[i] & downOpen[i] & ~down[i];
+    }
+    unsigned spread = (toUp ? UP : 0) | (toDown ? DOWN : 0);
+    if (hasLeft && (filled[0] & east[-1] >> 63 & ~reached[-1] >> 63)) spread |= LEFT;
+    if (hasRight && (filled[BLOCK_WORDS - 1] >> 63 & east[BLOCK_WORDS - 1] >> 63 & ~reached[BLOCK_WORDS]) & 1) {
+        spread |= RIGHT;
+    }
+    return spread;
+}
+
+/**
+ * Refill the dirty rows of one tile until it is closed, queueing the
+ * neighbouring tiles' rows that its cells open into
+ *
+ * Rows are refilled in alternating downward and upward passes over the
+ * dirty mask. A row marks the row above or below only when one of its
+ * cells has an open wall to an unreached cell there, so a pass follows a
+ * corridor as far as it runs in its direction, and a tile revisited later
+ * only refills the rows its neighbours named.
+ */
+void MazeFloodFill::processTile(size_t tileRow, size_t block, uint64_t dirty) {
+    processed++;
+    const size_t first = tileRow * TILE_ROWS;
+    const size_t rows = std::min(TILE_ROWS, static_cast<size_t>(height) - first);
+    const uint64_t allRows = rows == 64 ? ~0ULL : (1ULL << rows) - 1;
+    const uint64_t lastRow = 1ULL << (TILE_ROWS - 1);
+
+    auto update = [&](size_t r) {
+        dirty &= ~(1ULL << r);
+        unsigned spread = updateRow(first + r, block);
+        if (spread & UP) {
+            if (r > 0) {
+                dirty |= 1ULL << (r - 1);
+            } else {
+                push(tileRow - 1, block, lastRow);
+            }
+        }
+        if (spread & DOWN) {
+            if (r + 1 < rows) {
+                dirty |= 1ULL << (r + 1);
+            } else {
+                push(tileRow + 1, block, 1);
+            }
+        }
+        if (spread & LEFT) push(tileRow, block - 1, 1ULL << r);
+        if (spread & RIGHT) push(tileRow, block + 1, 1ULL << r);
+    };
+    dirty &= allRows;
+    while (dirty) {
+        for (size_t r = 0; r < rows && (dirty >> r); r++) {
+            r += static_cast<size_t>(__builtin_ctzll(dirty >> r));
+            update(r);
+        }
+        for (uint64_t below = allRows; dirty & below;) {
+            size_t r = 63 - static_cast<size_t>(__builtin_clzll(dirty & below));
+            below = (1ULL << r) - 1;
+            update(r);
+        }
+    }
+}
+
+size_t MazeFloodFill::fill(const MazeGrid& grid, int x, int y) {
+    reachedCount = 0;
+    processed = 0;
+    prepare(grid);
+    if (!grid.inBounds(x, y)) return 0;
+
+    reachedBits[static_cast<size_t>(y) * stride + (x >> 6)] |= 1ULL << (x & 63);
+    reachedCount = 1;
+    push(static_cast<size_t>(y) / TILE_ROWS, static_cast<size_t>(x >> 6) / BLOCK_WORDS,
+         1ULL << (static_cast<size_t>(y) % TILE_ROWS));
+    while (!work.empty()) {
+        size_t id = work.back();
+        work.pop_back();
+        uint64_t dirty = dirtyRows[id];
+        dirtyRows[id] = 0;
+        processTile(id / blocksPerRow, id % blocksPerRow, dirty);
+    }
+    return reachedCount;
+}
+
+bool MazeFloodFill::isConnected(const MazeGrid& grid) {
+    return grid.cellCount() > 0 && fill(grid, 0, 0) == grid.cellCount();
+}
+
+size_t MazeFloodFill::memoryBytes() const {
+    return (eastOpen.capacity() + southOpen.capacity() + reachedBits.capacity() + dirtyRows.capacity()) *
+               sizeof(uint64_t) +
+           work.capacity() * sizeof(uint32_t);
+}
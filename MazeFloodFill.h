@@ -0,0 +1,99 @@
+#ifndef MAZE_FLOOD_FILL_H
+#define MAZE_FLOOD_FILL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "MazeGrid.h"
+
+/**
+ * Bit-parallel reachability over MazeGrid's wall planes
+ *
+ * The reachable set is a bit mask laid out like the wall planes. A row
+ * update takes 256 cells at once (four words): seeds come from the reached
+ * cells above and below through open south walls and from the words on
+ * either side, and spread along open east walls with word arithmetic -
+ * a subtraction carries each seed to the end of its run, and the same
+ * trick on bit-reversed words carries it to the start. Rows are grouped
+ * into 256 x 32 tiles with a mask of rows to refill; a row only marks a
+ * neighbouring row (or tile) when it opens into cells not reached there
+ * yet, so the work follows the fill. The row update uses AVX2 when the
+ * CPU has it (checked once at run time); the scalar code computes the
+ * same masks.
+ *
+ * The grid is only read - visited flags and walls are untouched - and all
+ * scratch is owned by the context and sized once per maze size, so
+ * repeated queries do not allocate.
+ */
+class MazeFloodFill {
+public:
+    static constexpr size_t BLOCK_WORDS = 4;  // Tile width: 256 cells
+    static constexpr size_t TILE_ROWS = 32;
+
+    /**
+     * Fill from (x, y); returns the number of reachable cells, the start
+     * included, or 0 if the start is out of range. The mask stays valid
+     * until the next fill().
+     */
+    size_t fill(const MazeGrid& grid, int x, int y);
+
+    /**
+     * True when every cell is reachable from (0, 0)
+     */
+    bool isConnected(const MazeGrid& grid);
+
+    /**
+     * Results of the last fill()
+     */
+    size_t count() const { return reachedCount; }
+    bool reached(int x, int y) const {
+        return (reachedBits[static_cast<size_t>(y) * stride + (x >> 6)] >> (x & 63)) & 1ULL;
+    }
+
+    /**
+     * Reachable mask of row y: bit x of word x / 64, as in MazeGrid::eastRow()
+     * (the row has at least getRowWords() words; padding bits are zero)
+     */
+    const uint64_t* maskRow(int y) const { return reachedBits.data() + static_cast<size_t>(y) * stride; }
+
+    /**
+     * Tiles processed by the last fill(), a tile being processed again
+     * whenever a neighbour has new cells for it
+     */
+    size_t tilesProcessed() const { return processed; }
+
+    size_t memoryBytes() const;
+
+    /**
+     * True when rows are updated with AVX2. setVectorized(false) forces
+     * the scalar code (for comparison); it cannot enable AVX2 on a CPU
+     * without it.
+     */
+    static bool vectorized();
+    static void setVectorized(bool enable);
+
+private:
+    void prepare(const MazeGrid& grid);
+    static const unsigned UP = 1;
+    static const unsigned DOWN = 2;
+    static const unsigned LEFT = 4;
+    static const unsigned RIGHT = 8;
+
+    void push(size_t tileRow, size_t block, uint64_t rows);
+    unsigned updateRow(size_t y, size_t block);
+    void processTile(size_t tileRow, size_t block, uint64_t dirty);
+
+    int width = 0;
+    int height = 0;
+    size_t stride = 0;                    // Words per row, a multiple of BLOCK_WORDS
+    size_t blocksPerRow = 0;
+    std::vector<uint64_t> eastOpen;       // Bit set: passage to the cell on the right
+    std::vector<uint64_t> southOpen;      // Bit set: passage to the cell below
+    std::vector<uint64_t> reachedBits;
+    std::vector<uint64_t> dirtyRows;      // Per tile: rows to refill; nonzero iff on the work stack
+    std::vector<uint32_t> work;           // Tile row * blocksPerRow + block
+    size_t reachedCount = 0;
+    size_t processed = 0;
+};
+
+#endif // MAZE_FLOOD_FILL_H
@@ -0,0 +1,595 @@
+#include "MazeGenerators.h"
+#include "MazeInstrumentation.h"
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+namespace {
+/**
+ * Fair coin flips, 32 per generator call
+ */
+class CoinFlipper {
+public:
+    explicit CoinFlipper(MazeRandom& generator) : rng(generator), bits(0), left(0) {}
+
+    bool flip() {
+        if (left == 0) {
+            bits = static_cast<uint32_t>(rng());
+            left = 32;
+        }
+        bool result = bits & 1u;
+        bits >>= 1;
+        left--;
+        return result;
+    }
+
+private:
+    MazeRandom& rng;
+    uint32_t bits;
+    int left;
+};
+
+/**
+ * Generators address cells with 32-bit indices
+ */
+void checkCellLimit(const MazeGrid& grid, uint64_t perCell, const char* who) {
+    if (static_cast<uint64_t>(grid.cellCount()) * perCell > std::numeric_limits<uint32_t>::max()) {
+        throw std::length_error(std::string(who) + ": maze exceeds 32-bit cell indices");
+    }
+}
+
+/**
+ * Direction mask of in-bounds neighbours of (x, y)
+ */
+inline unsigned neighborMask(const MazeGrid& grid, int x, int y) {
+    unsigned mask = 0;
+    if (y > 0) mask |= 1u << TOP;
+    if (x < grid.getWidth() - 1) mask |= 1u << RIGHT;
+    if (y < grid.getHeight() - 1) mask |= 1u << BOTTOM;
+    if (x > 0) mask |= 1u << LEFT;
+    return mask;
+}
+
+/**
+ * Uniformly pick one set bit of a non-empty direction mask
+ */
+inline Direction pickDirection(MazeRandom& rng, unsigned mask) {
+    unsigned k = boundedDraw(rng, __builtin_popcount(mask));
+    while (k--) mask &= mask - 1;
+    return static_cast<Direction>(__builtin_ctz(mask));
+}
+}
+
+/**
+ * Human-readable algorithm name
+ */
+const char* algorithmName(MazeAlgorithm algorithm) {
+    switch (algorithm) {
+        case MazeAlgorithm::DFS: return "Iterative DFS";
+        case MazeAlgorithm::RECURSIVE: return "Recursive backtracker";
+        case MazeAlgorithm::KRUSKAL: return "Kruskal";
+        case MazeAlgorithm::PRIM: return "Prim";
+        case MazeAlgorithm::WILSON: return "Wilson";
+        case MazeAlgorithm::ELLER: return "Eller";
+        case MazeAlgorithm::SIDEWINDER: return "Sidewinder";
+        case MazeAlgorithm::BINARY_TREE: return "Binary tree";
+    }
+    return "Unknown";
+}
+
+const char* algorithmKey(MazeAlgorithm algorithm) {
+    static const char* const KEYS[MAZE_ALGORITHM_COUNT] = {
+        "dfs", "recursive", "kruskal", "prim", "wilson", "eller", "sidewinder", "binarytree"
+    };
+    int index = static_cast<int>(algorithm);
+    return index >= 0 && index < MAZE_ALGORITHM_COUNT ? KEYS[index] : "unknown";
+}
+
+bool parseAlgorithm(const std::string& name, MazeAlgorithm& algorithm) {
+    for (int i = 0; i < MAZE_ALGORITHM_COUNT; i++) {
+        if (name == algorithmKey(static_cast<MazeAlgorithm>(i))) {
+            algorithm = static_cast<MazeAlgorithm>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Iterative depth-first generation over the packed grid
+ */
+void DfsGenerator::generate(MazeGrid& grid, MazeRandom& rng) {
+    grid.reset();
+
+    const int width = grid.getWidth();
+    const int height = grid.getHeight();
+    if (width <= 0 || height <= 0) return;
+
+    const size_t cells = grid.cellCount();
+    checkCellLimit(grid, 1, "DfsGenerator");
+    if (stack.size() < cells) {
+        stack.resize(cells);
+    }
+
+    const size_t stride = grid.getStride();
+    uint32_t* base = stack.data();
+    size_t top = 0;
+    CounterScope counters;
+
+    // Start from top-left corner; (x, y, b) track the cell on top of the stack
+    int x = 0, y = 0;
+    size_t b = grid.bitIndex(0, 0);
+    grid.markVisitedAt(b);
+    base[top++] = 0;
+    counters.visit();
+
+    while (true) {
+        // Unvisited neighbours as a direction bitmask
+        unsigned mask = 0;
+        if (y > 0 && !grid.isVisitedAt(b - stride)) mask |= 1u << TOP;
+        if (x < width - 1 && !grid.isVisitedAt(b + 1)) mask |= 1u << RIGHT;
+        if (y < height - 1 && !grid.isVisitedAt(b + stride)) mask |= 1u << BOTTOM;
+        if (x > 0 && !grid.isVisitedAt(b - 1)) mask |= 1u << LEFT;
+
+        if (mask) {
+            switch (pickDirection(rng, mask)) {
+                case TOP:
+                    b -= stride;
+                    y--;
+                    grid.clearSouthAt(b);
+                    break;
+                case RIGHT:
+                    grid.clearEastAt(b);
+                    b += 1;
+                    x++;
+                    break;
+                case BOTTOM:
+                    grid.clearSouthAt(b);
+                    b += stride;
+                    y++;
+                    break;
+                default: // LEFT
+                    b -= 1;
+                    x--;
+                    grid.clearEastAt(b);
+                    break;
+            }
+
+            grid.markVisitedAt(b);
+            base[top++] = static_cast<uint32_t>(static_cast<size_t>(y) * width + x);
+            counters.visit();
+            counters.depth(top);
+        } else {
+            // Backtrack - pop from stack
+            counters.backtrack();
+            if (--top == 0) break;
+            uint32_t idx = base[top - 1];
+            y = static_cast<int>(idx / width);
+            x = static_cast<int>(idx % width);
+            b = grid.bitIndex(x, y);
+        }
+    }
+}
+
+/**
+ * Recursive backtracking with the call stack made explicit
+ */
+void RecursiveGenerator::generate(MazeGrid& grid, MazeRandom& rng, int startX, int startY) {
+    grid.reset();
+    if (!grid.inBounds(startX, startY)) return;
+
+    const int width = grid.getWidth();
+    const size_t cells = grid.cellCount();
+    checkCellLimit(grid, 1, "RecursiveGenerator");
+    if (frames.size() < cells) {
+        frames.resize(cells);
+    }
+
+    Frame* base = frames.data();
+    size_t top = 0;
+    CounterScope counters;
+
+    // "Call" for (x, y): mark visited, shuffle unvisited neighbours, push frame
+    auto enter = [&](int x, int y) {
+        grid.markVisited(x, y);
+
+        Direction neighbors[4];
+        int count = 0;
+        for (int d = TOP; d <= LEFT; d++) {
+            int nx = x + DX[d];
+            int ny = y + DY[d];
+            if (grid.inBounds(nx, ny) && !grid.isVisited(nx, ny)) {
+                neighbors[count++] = static_cast<Direction>(d);
+            }
+        }
+        std::shuffle(neighbors, neighbors + count, rng);
+
+        Frame& frame = base[top++];
+        frame.cell = static_cast<uint32_t>(static_cast<size_t>(y) * width + x);
+        frame.order = 0;
+        for (int i = 0; i < count; i++) {
+            frame.order |= static_cast<uint8_t>(neighbors[i] << (2 * i));
+        }
+        frame.count = static_cast<uint8_t>(count);
+        frame.next = 0;
+        counters.visit();
+        counters.depth(top);
+    };
+
+    enter(startX, startY);
+
+    while (top > 0) {
+        Frame& frame = base[top - 1];
+        if (frame.next == frame.count) {
+            // Return from this cell
+            counters.backtrack();
+            top--;
+            continue;
+        }
+
+        Direction dir = static_cast<Direction>((frame.order >> (2 * frame.next)) & 3);
+        frame.next++;
+
+        int x = static_cast<int>(frame.cell % width);
+        int y = static_cast<int>(frame.cell / width);
+        int nx = x + DX[dir];
+        int ny = y + DY[dir];
+        if (!grid.isVisited(nx, ny)) {
+            grid.removeWall(x, y, dir);
+            enter(nx, ny);
+        }
+    }
+}
+
+/**
+ * Randomized Kruskal's algorithm
+ */
+void KruskalGenerator::generate(MazeGrid& grid, MazeRandom& rng) {
+    grid.reset();
+
+    const int width = grid.getWidth();
+    const int height = grid.getHeight();
+    if (width <= 0 || height <= 0) return;
+    checkCellLimit(grid, 2, "KruskalGenerator");
+
+    const uint32_t cells = static_cast<uint32_t>(grid.cellCount());
+    parent.resize(cells);
+    for (uint32_t i = 0; i < cells; i++) parent[i] = i;
+
+    // Every interior wall once, then Fisher-Yates shuffle
+    edges.clear();
+    edges.reserve(2 * static_cast<size_t>(cells));
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            uint32_t cell = static_cast<uint32_t>(y) * width + x;
+            if (x < width - 1) edges.push_back(cell << 1);
+            if (y < height - 1) edges.push_back((cell << 1) | 1u);
+        }
+    }
+    for (size_t i = edges.size(); i > 1; i--) {
+        std::swap(edges[i - 1], edges[boundedDraw(rng, static_cast<uint32_t>(i))]);
+    }
+
+    // Union-find with path halving
+    auto find = [this](uint32_t v) {
+        while (parent[v] != v) {
+            parent[v] = parent[parent[v]];
+            v = parent[v];
+        }
+        return v;
+    };
+
+    uint32_t joined = 0;
+    for (uint32_t edge : edges) {
+        uint32_t a = edge >> 1;
+        bool south = edge & 1u;
+        uint32_t b = south ? a + width : a + 1;
+
+        uint32_t ra = find(a);
+        uint32_t rb = find(b);
+        if (ra == rb) continue;
+        parent[ra] = rb;
+
+        int x = static_cast<int>(a % width);
+        int y = static_cast<int>(a / width);
+        grid.removeWall(x, y, south ? BOTTOM : RIGHT);
+        if (++joined == cells - 1) break;
+    }
+}
+
+/**
+ * Randomized Prim's algorithm (frontier-cell variant)
+ */
+void PrimGenerator::generate(MazeGrid& grid, MazeRandom& rng) {
+    grid.reset();
+
+    const int width = grid.getWidth();
+    const int height = grid.getHeight();
+    if (width <= 0 || height <= 0) return;
+    checkCellLimit(grid, 1, "PrimGenerator");
+
+    const uint32_t cells = static_cast<uint32_t>(grid.cellCount());
+    frontier.clear();
+    inFrontier.assign((static_cast<size_t>(cells) + 63) / 64, 0);
+
+    // Add the unvisited, not yet queued neighbours of (x, y) to the frontier
+    auto expand = [&](int x, int y) {
+        for (int d = TOP; d <= LEFT; d++) {
+            int nx = x + DX[d];
+            int ny = y + DY[d];
+            if (!grid.inBounds(nx, ny) || grid.isVisited(nx, ny)) continue;
+            uint32_t cell = static_cast<uint32_t>(ny) * width + nx;
+            uint64_t bit = 1ULL << (cell & 63);
+            if (inFrontier[cell >> 6] & bit) continue;
+            inFrontier[cell >> 6] |= bit;
+            frontier.push_back(cell);
+        }
+    };
+
+    uint32_t start = boundedDraw(rng, cells);
+    int sx = static_cast<int>(start % width);
+    int sy = static_cast<int>(start / width);
+    grid.markVisited(sx, sy);
+    expand(sx, sy);
+
+    while (!frontier.empty()) {
+        // Remove a random frontier cell (swap with last)
+        uint32_t i = boundedDraw(rng, static_cast<uint32_t>(frontier.size()));
+        uint32_t cell = frontier[i];
+        frontier[i] = frontier.back();
+        frontier.pop_back();
+
+        int x = static_cast<int>(cell % width);
+        int y = static_cast<int>(cell / width);
+
+        // Attach it to a random neighbour that is already in the maze
+        unsigned inMaze = 0;
+        for (int d = TOP; d <= LEFT; d++) {
+            int nx = x + DX[d];
+            int ny = y + DY[d];
+            if (grid.inBounds(nx, ny) && grid.isVisited(nx, ny)) inMaze |= 1u << d;
+        }
+        grid.removeWall(x, y, pickDirection(rng, inMaze));
+        grid.markVisited(x, y);
+        expand(x, y);
+    }
+}
+
+/**
+ * Wilson's algorithm
+ */
+void WilsonGenerator::generate(MazeGrid& grid, MazeRandom& rng) {
+    grid.reset();
+
+    const int width = grid.getWidth();
+    const int height = grid.getHeight();
+    if (width <= 0 || height <= 0) return;
+    checkCellLimit(grid, 1, "WilsonGenerator");
+
+    const uint32_t cells = static_cast<uint32_t>(grid.cellCount());
+    exitDirection.resize(cells);
+
+    CounterScope counters;
+
+    // Seed the maze with one random cell
+    uint32_t root = boundedDraw(rng, cells);
+    grid.markVisited(static_cast<int>(root % width), static_cast<int>(root / width));
+
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            if (grid.isVisited(x, y)) continue;
+
+            // Random walk until the maze is hit; revisiting a cell simply
+            // overwrites its exit direction, which erases the loop
+            int cx = x, cy = y;
+            while (!grid.isVisited(cx, cy)) {
+                Direction dir = pickDirection(rng, neighborMask(grid, cx, cy));
+                exitDirection[static_cast<size_t>(cy) * width + cx] = static_cast<uint8_t>(dir);
+                cx += DX[dir];
+                cy += DY[dir];
+                counters.visit();
+            }
+
+            // Carve the loop-erased path into the maze
+            cx = x;
+            cy = y;
+            while (!grid.isVisited(cx, cy)) {
+                Direction dir = static_cast<Direction>(exitDirection[static_cast<size_t>(cy) * width + cx]);
+                grid.markVisited(cx, cy);
+                grid.removeWall(cx, cy, dir);
+                cx += DX[dir];
+                cy += DY[dir];
+            }
+        }
+    }
+}
+
+/**
+ * Start a new Eller maze: every column in its own set
+ */
+void EllerRowGenerator::begin(int w) {
+    width = w > 0 ? w : 0;
+    size_t n = static_cast<size_t>(width);
+    labels.resize(n);
+    parent.resize(n);
+    remap.resize(n);
+    pick.resize(n);
+    seen.resize(n);
+    down.resize(n);
+    hasDown.resize(n);
+    for (size_t i = 0; i < n; i++) labels[i] = static_cast<uint32_t>(i);
+}
+
+uint32_t EllerRowGenerator::find(uint32_t label) {
+    while (parent[label] != label) {
+        parent[label] = parent[parent[label]];
+        label = parent[label];
+    }
+    return label;
+}
+
+/**
+ * One row of Eller's algorithm
+ */
+void EllerRowGenerator::nextRow(MazeRandom& rng, bool lastRow, uint64_t* eastRow, uint64_t* southRow) {
+    const size_t words = (static_cast<size_t>(width) + 63) / 64;
+    std::fill(eastRow, eastRow + words, ~0ULL);
+    std::fill(southRow, southRow + words, ~0ULL);
+    if (width == 0) return;
+
+    CoinFlipper coin(rng);
+
+    // Randomly join adjacent cells of different sets (the last row joins all)
+    for (int i = 0; i < width; i++) parent[i] = static_cast<uint32_t>(i);
+    for (int x = 0; x + 1 < width; x++) {
+        uint32_t a = find(labels[x]);
+        uint32_t b = find(labels[x + 1]);
+        if (a != b && (lastRow || coin.flip())) {
+            parent[b] = a;
+            eastRow[x >> 6] &= ~(1ULL << (x & 63));
+        }
+    }
+    if (lastRow) return;
+
+    // Every set opens at least one south wall: random columns go down, and
+    // a set with none gets a member reservoir-sampled among its columns
+    for (int i = 0; i < width; i++) {
+        seen[i] = 0;
+        hasDown[i] = 0;
+    }
+    for (int x = 0; x < width; x++) {
+        uint32_t set = find(labels[x]);
+        labels[x] = set;
+        down[x] = coin.flip();
+        if (down[x]) {
+            hasDown[set] = 1;
+        } else if (!hasDown[set] && boundedDraw(rng, ++seen[set]) == 0) {
+            // Only sets with no opening so far need a fallback member
+            pick[set] = static_cast<uint32_t>(x);
+        }
+    }
+    for (int x = 0; x < width; x++) {
+        uint32_t set = labels[x];
+        if (!hasDown[set]) {
+            down[pick[set]] = 1;
+            hasDown[set] = 1;
+        }
+    }
+
+    // Columns that went down keep their set; the rest start new ones.
+    // Labels are compacted so they stay below width.
+    const uint32_t unset = std::numeric_limits<uint32_t>::max();
+    for (int i = 0; i < width; i++) remap[i] = unset;
+    uint32_t next = 0;
+    for (int x = 0; x < width; x++) {
+        if (down[x]) {
+            southRow[x >> 6] &= ~(1ULL << (x & 63));
+            uint32_t set = labels[x];
+            if (remap[set] == unset) remap[set] = next++;
+            labels[x] = remap[set];
+        } else {
+            labels[x] = next++;
+        }
+    }
+}
+
+/**
+ * Eller's algorithm, writing rows straight into the grid planes
+ */
+void EllerGenerator::generate(MazeGrid& grid, MazeRandom& rng) {
+    grid.reset();
+
+    const int height = grid.getHeight();
+    rows.begin(grid.getWidth());
+    for (int y = 0; y < height; y++) {
+        rows.nextRow(rng, y == height - 1, grid.eastRow(y), grid.southRow(y));
+    }
+}
+
+/**
+ * Sidewinder (runs carve north, the top row is one corridor)
+ */
+void generateSidewinder(MazeGrid& grid, MazeRandom& rng) {
+    grid.reset();
+
+    const int width = grid.getWidth();
+    const int height = grid.getHeight();
+    CoinFlipper coin(rng);
+
+    for (int x = 0; x + 1 < width; x++) grid.removeWall(x, 0, RIGHT);
+
+    for (int y = 1; y < height; y++) {
+        int runStart = 0;
+        for (int x = 0; x < width; x++) {
+            if (x == width - 1 || coin.flip()) {
+                // Close the run: one random member opens north
+                int member = runStart + static_cast<int>(boundedDraw(rng, x - runStart + 1));
+                grid.removeWall(member, y, TOP);
+                runStart = x + 1;
+            } else {
+                grid.removeWall(x, y, RIGHT);
+            }
+        }
+    }
+}
+
+/**
+ * Binary tree (north/west bias)
+ */
+void generateBinaryTree(MazeGrid& grid, MazeRandom& rng) {
+    grid.reset();
+
+    const int width = grid.getWidth();
+    const int height = grid.getHeight();
+    CoinFlipper coin(rng);
+
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            if (y > 0 && (x == 0 || coin.flip())) {
+                grid.removeWall(x, y, TOP);
+            } else if (x > 0) {
+                grid.removeWall(x, y, LEFT);
+            }
+        }
+    }
+}
+
+/**
+ * Dispatch to the selected generator
+ */
+void MazeGeneratorEngine::generate(MazeAlgorithm algorithm, MazeGrid& grid, MazeRandom& rng) {
+    // DFS, recursive and Wilson count their own visits; the rest add every cell once
+    CounterScope counters;
+    switch (algorithm) {
+        case MazeAlgorithm::DFS:
+            dfs.generate(grid, rng);
+            break;
+        case MazeAlgorithm::RECURSIVE:
+            recursive.generate(grid, rng);
+            break;
+        case MazeAlgorithm::KRUSKAL:
+            kruskal.generate(grid, rng);
+            counters.visit(grid.cellCount());
+            break;
+        case MazeAlgorithm::PRIM:
+            prim.generate(grid, rng);
+            counters.visit(grid.cellCount());
+            break;
+        case MazeAlgorithm::WILSON:
+            wilson.generate(grid, rng);
+            break;
+        case MazeAlgorithm::ELLER:
+            eller.generate(grid, rng);
+            counters.visit(grid.cellCount());
+            break;
+        case MazeAlgorithm::SIDEWINDER:
+            generateSidewinder(grid, rng);
+            counters.visit(grid.cellCount());
+            break;
+        case MazeAlgorithm::BINARY_TREE:
+            generateBinaryTree(grid, rng);
+            counters.visit(grid.cellCount());
+            break;
+    }
+}
@@ -0,0 +1,242 @@
+#ifndef MAZE_GENERATORS_H
+#define MAZE_GENERATORS_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "MazeGrid.h"
+#include "MazeRandom.h"
+
+/**
+ * Maze generation algorithms selectable through Maze::generate()
+ */
+enum class MazeAlgorithm {
+    DFS,          // Iterative depth-first search (recursive backtracker)
+    RECURSIVE,    // Recursive backtracker, explicit frame stack
+    KRUSKAL,      // Randomized Kruskal with union-find
+    PRIM,         // Randomized Prim over a frontier list
+    WILSON,       // Loop-erased random walks (uniform spanning tree)
+    ELLER,        // Row by row, O(width) state
+    SIDEWINDER,   // Row by row, O(1) state
+    BINARY_TREE   // Stateless, one decision per cell
+};
+
+const int MAZE_ALGORITHM_COUNT = 8;
+
+/**
+ * Human-readable algorithm name
+ */
+const char* algorithmName(MazeAlgorithm algorithm);
+
+/**
+ * Command-line name of an algorithm, as accepted by parseAlgorithm()
+ */
+const char* algorithmKey(MazeAlgorithm algorithm);
+
+/**
+ * Parse a command-line algorithm name ("dfs", "recursive", "kruskal",
+ * "prim", "wilson", "eller", "sidewinder", "binarytree"); false otherwise
+ */
+bool parseAlgorithm(const std::string& name, MazeAlgorithm& algorithm);
+
+/**
+ * Allocation-free iterative depth-first search (recursive backtracker)
+ *
+ * The backtracking stack is a flat array of cell indices (y * width + x)
+ * sized once to width * height and reused by later calls, so generation
+ * performs no heap allocation after the first maze of a given size.
+ *
+ * Reference sequence (output is bit-identical for a given seed):
+ *   1. Reset the grid, mark (0, 0) visited and push it.
+ *   2. For the cell on top of the stack, collect its unvisited neighbours
+ *      in the order TOP, RIGHT, BOTTOM, LEFT.
+ *   3. If there are k > 0 candidates, draw one 32-bit value r from the
+ *      MazeRandom and pick candidate number (r * k) >> 32; carve the wall,
+ *      mark the neighbour visited and push it.
+ *   4. Otherwise pop the stack. Steps that pop consume no random numbers.
+ *   5. Stop when the stack is empty.
+ */
+class DfsGenerator {
+public:
+    void generate(MazeGrid& grid, MazeRandom& rng);
+
+    /**
+     * Bytes reserved for the backtracking stack
+     */
+    size_t memoryBytes() const { return stack.capacity() * sizeof(uint32_t); }
+
+private:
+    std::vector<uint32_t> stack;  // Cell indices, sized to width * height
+};
+
+/**
+ * Recursive backtracker driven by an explicit continuation stack
+ *
+ * Produces exactly the visit order of the classic recursive formulation
+ * (on entry a cell shuffles its unvisited neighbours with std::shuffle,
+ * then descends into each one that is still unvisited when its turn
+ * comes), but every "call" is an 8-byte frame in a reusable array sized
+ * to width * height. Native stack use is constant, there is no static
+ * state, and each cell is entered once, so generation is O(n).
+ */
+class RecursiveGenerator {
+public:
+    /**
+     * Generate starting from (startX, startY); an out-of-range start leaves
+     * the grid reset with every wall standing
+     */
+    void generate(MazeGrid& grid, MazeRandom& rng, int startX = 0, int startY = 0);
+
+    size_t memoryBytes() const { return frames.capacity() * sizeof(Frame); }
+
+private:
+    struct Frame {
+        uint32_t cell;   // Cell index (y * width + x)
+        uint8_t order;   // Shuffled directions, two bits each
+        uint8_t count;   // Number of directions in order
+        uint8_t next;    // Next direction to try
+    };
+
+    std::vector<Frame> frames;
+};
+
+/**
+ * Randomized Kruskal: shuffle every interior wall, then open each wall
+ * whose two cells are still in different union-find sets
+ */
+class KruskalGenerator {
+public:
+    void generate(MazeGrid& grid, MazeRandom& rng);
+    size_t memoryBytes() const {
+        return (parent.capacity() + edges.capacity()) * sizeof(uint32_t);
+    }
+
+private:
+    std::vector<uint32_t> parent;  // Union-find forest over cell indices
+    std::vector<uint32_t> edges;   // cell * 2 + (0 = east wall, 1 = south wall)
+};
+
+/**
+ * Randomized Prim: grow the maze from a random cell by repeatedly attaching
+ * a random frontier cell to one of its in-maze neighbours
+ */
+class PrimGenerator {
+public:
+    void generate(MazeGrid& grid, MazeRandom& rng);
+    size_t memoryBytes() const {
+        return frontier.capacity() * sizeof(uint32_t) + inFrontier.capacity() * sizeof(uint64_t);
+    }
+
+private:
+    std::vector<uint32_t> frontier;    // Cells adjacent to the maze
+    std::vector<uint64_t> inFrontier;  // Bitset over cell indices
+};
+
+/**
+ * Wilson's algorithm: loop-erased random walks from each cell not yet in
+ * the maze until the walk hits the maze. Generates a uniformly random
+ * spanning tree; slower than the others on large grids.
+ */
+class WilsonGenerator {
+public:
+    void generate(MazeGrid& grid, MazeRandom& rng);
+    size_t memoryBytes() const { return exitDirection.capacity(); }
+
+private:
+    std::vector<uint8_t> exitDirection;  // Last direction taken out of each cell
+};
+
+/**
+ * One row of Eller's algorithm at a time
+ *
+ * Only per-column set labels for the current row are kept (O(width)), so
+ * the same engine serves both in-memory generation and streaming output.
+ * Each call fills one row of packed wall words in MazeGrid's row format
+ * (bit x set = wall present).
+ */
+class EllerRowGenerator {
+public:
+    /**
+     * Start a new maze of the given width
+     */
+    void begin(int w);
+
+    /**
+     * Produce the next row; the last row joins every remaining set and
+     * keeps all of its south walls
+     */
+    void nextRow(MazeRandom& rng, bool lastRow, uint64_t* eastRow, uint64_t* southRow);
+
+    size_t memoryBytes() const {
+        return (labels.capacity() + parent.capacity() + remap.capacity() + pick.capacity() + seen.capacity()) *
+                   sizeof(uint32_t) +
+               down.capacity() + hasDown.capacity();
+    }
+
+private:
+    uint32_t find(uint32_t label);
+
+    int width = 0;
+    std::vector<uint32_t> labels;   // Set label of each column, always < width
+    std::vector<uint32_t> parent;   // Union-find over labels within a row
+    std::vector<uint32_t> remap;    // Canonical label -> compact label for the next row
+    std::vector<uint32_t> pick;     // Reservoir-sampled column per set
+    std::vector<uint32_t> seen;     // Members of each set seen so far
+    std::vector<uint8_t> down;      // Column opens its south wall
+    std::vector<uint8_t> hasDown;   // Set already has a south opening
+};
+
+/**
+ * Eller's algorithm over a whole MazeGrid
+ */
+class EllerGenerator {
+public:
+    void generate(MazeGrid& grid, MazeRandom& rng);
+    size_t memoryBytes() const { return rows.memoryBytes(); }
+
+private:
+    EllerRowGenerator rows;
+};
+
+/**
+ * Sidewinder: each row is split into random runs joined east-west, and
+ * every run opens one random cell to the row above
+ */
+void generateSidewinder(MazeGrid& grid, MazeRandom& rng);
+
+/**
+ * Binary tree: every cell opens either its north or its west wall
+ */
+void generateBinaryTree(MazeGrid& grid, MazeRandom& rng);
+
+/**
+ * Generator strategy engine
+ *
+ * Owns one instance of every generator so scratch buffers are allocated
+ * lazily and reused between mazes; dispatches on MazeAlgorithm.
+ */
+class MazeGeneratorEngine {
+public:
+    void generate(MazeAlgorithm algorithm, MazeGrid& grid, MazeRandom& rng);
+    void generateRecursive(MazeGrid& grid, MazeRandom& rng, int startX, int startY) {
+        recursive.generate(grid, rng, startX, startY);
+    }
+
+    /**
+     * Scratch bytes currently reserved across all generators
+     */
+    size_t memoryBytes() const {
+        return dfs.memoryBytes() + recursive.memoryBytes() + kruskal.memoryBytes() +
+               prim.memoryBytes() + wilson.memoryBytes() + eller.memoryBytes();
+    }
+
+private:
+    DfsGenerator dfs;
+    RecursiveGenerator recursive;
+    KruskalGenerator kruskal;
+    PrimGenerator prim;
+    WilsonGenerator wilson;
+    EllerGenerator eller;
+};
+
+#endif // MAZE_GENERATORS_H
@@ -0,0 +1,382 @@
+#ifndef MAZE_GRID_H
+#define MAZE_GRID_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/**
+ * Cell structure representing each position in the maze
+ *
+ * Cells are no longer stored directly; MazeGrid materializes them on demand
+ * from its wall bit planes so existing code reading grid[y][x] keeps working.
+ */
+struct Cell {
+    bool visited;           // Has this cell been visited during generation?
+    bool walls[4];         // Walls: 0=top, 1=right, 2=bottom, 3=left
+    int x, y;              // Coordinates
+
+    Cell() : visited(false), x(0), y(0) {
+        // Initialize all walls as present
+        for (int i = 0; i < 4; i++) {
+            walls[i] = true;
+        }
+    }
+
+    Cell(int x_pos, int y_pos) : visited(false), x(x_pos), y(y_pos) {
+        // Initialize all walls as present
+        for (int i = 0; i < 4; i++) {
+            walls[i] = true;
+        }
+    }
+};
+
+/**
+ * Direction enumeration for easier navigation
+ */
+enum Direction {
+    TOP = 0,
+    RIGHT = 1,
+    BOTTOM = 2,
+    LEFT = 3
+};
+
+// Neighbour offsets indexed by Direction
+inline constexpr int DX[4] = {0, 1, 0, -1};
+inline constexpr int DY[4] = {-1, 0, 1, 0};
+
+/**
+ * Row-major index of the neighbour of cell in direction dir, which must be
+ * inside the grid
+ */
+inline uint32_t neighbourIndex(uint32_t cell, unsigned dir, int width) {
+    return static_cast<uint32_t>(static_cast<long long>(cell) + DY[dir] * static_cast<long long>(width) + DX[dir]);
+}
+
+/**
+ * Compact wall storage for a maze
+ *
+ * Every interior wall is shared by two cells, so only the east (RIGHT) and
+ * south (BOTTOM) wall of each cell is stored; the north and west walls are
+ * read from the neighbouring cell or the border. Each wall kind lives in its
+ * own bit plane, and a third plane holds the visited flags used by the
+ * generators. Rows are padded to whole 64-bit words so that a row can be
+ * processed a word at a time. A set bit means "wall present" / "visited".
+ *
+ * The wall planes are normally owned (one allocation holding both), but a
+ * grid can also be attached to planes living elsewhere, such as a batch
+ * arena; copies of an attached grid own their planes.
+ */
+class MazeGrid {
+public:
+    /**
+     * Read-only view of one row, yielding Cell values
+     */
+    class RowView {
+    public:
+        RowView(const MazeGrid& g, int row) : grid(&g), y(row) {}
+        Cell operator[](int x) const { return grid->cellAt(x, y); }
+
+    private:
+        const MazeGrid* grid;
+        int y;
+    };
+
+    MazeGrid() : width(0), height(0), rowWords(0), planeWords(0), eastWalls(nullptr), southWalls(nullptr) {}
+    MazeGrid(int w, int h) : MazeGrid() { resize(w, h); }
+
+    MazeGrid(const MazeGrid& other) : MazeGrid() { *this = other; }
+    MazeGrid(MazeGrid&& other) noexcept : MazeGrid() { *this = std::move(other); }
+
+    MazeGrid& operator=(const MazeGrid& other) {
+        if (this == &other) return *this;
+        setDimensions(other.width, other.height);
+        storage.resize(2 * planeWords);
+        bindOwned();
+        std::copy(other.eastWalls, other.eastWalls + planeWords, eastWalls);
+        std::copy(other.southWalls, other.southWalls + planeWords, southWalls);
+        visitedBits = other.visitedBits;
+        return *this;
+    }
+
+    MazeGrid& operator=(MazeGrid&& other) noexcept {
+        if (this == &other) return *this;
+        bool owned = other.eastWalls == other.storage.data();
+        setDimensions(other.width, other.height);
+        storage = std::move(other.storage);
+        visitedBits = std::move(other.visitedBits);
+        if (owned) {
+            bindOwned();
+        } else {
+            eastWalls = other.eastWalls;
+            southWalls = other.southWalls;
+        }
+        other.setDimensions(0, 0);
+        other.eastWalls = other.southWalls = nullptr;
+        return *this;
+    }
+
+    /**
+     * Change the dimensions and restore every wall (owned planes). The
+     * buffers keep their capacity, so shrinking or returning to an
+     * earlier size does not allocate.
+     */
+    void resize(int w, int h) {
+        setDimensions(w, h);
+        storage.assign(2 * planeWords, ~0ULL);
+        bindOwned();
+        visitedBits.assign(planeWords, 0);
+    }
+
+    /**
+     * Use externally owned wall planes of planeWordsFor(w, h) words each.
+     * Walls are left as they are; the visited plane stays owned and is
+     * cleared. No allocation happens if the visited plane is big enough.
+     */
+    void attach(int w, int h, uint64_t* eastPlane, uint64_t* southPlane) {
+        setDimensions(w, h);
+        eastWalls = eastPlane;
+        southWalls = southPlane;
+        visitedBits.assign(planeWords, 0);
+    }
+
+    /**
+     * Words needed for one wall plane of a w x h grid
+     */
+    static size_t planeWordsFor(int w, int h) {
+        return (static_cast<size_t>(w > 0 ? w : 0) + 63) / 64 * static_cast<size_t>(h > 0 ? h : 0);
+    }
+
+    /**
+     * Restore every wall and clear all visited flags
+     */
+    void reset() {
+        std::fill(eastWalls, eastWalls + planeWords, ~0ULL);
+        std::fill(southWalls, southWalls + planeWords, ~0ULL);
+        clearVisited();
+    }
+
+    void clearVisited() {
+        std::fill(visitedBits.begin(), visitedBits.end(), 0);
+    }
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    size_t cellCount() const { return static_cast<size_t>(width) * height; }
+    size_t getRowWords() const { return rowWords; }
+    size_t getPlaneWords() const { return planeWords; }
+    size_t getStride() const { return rowWords * 64; } // Bit distance between rows
+
+    bool inBounds(int x, int y) const {
+        return x >= 0 && x < width && y >= 0 && y < height;
+    }
+
+    bool hasEastWall(int x, int y) const { return test(eastWalls, bit(x, y)); }
+    bool hasSouthWall(int x, int y) const { return test(southWalls, bit(x, y)); }
+
+    /**
+     * Wall query in any direction; walls on the outer border are always present
+     */
+    bool hasWall(int x, int y, Direction dir) const {
+        switch (dir) {
+            case TOP:
+                return y == 0 || hasSouthWall(x, y - 1);
+            case RIGHT:
+                return x == width - 1 || hasEastWall(x, y);
+            case BOTTOM:
+                return y == height - 1 || hasSouthWall(x, y);
+            case LEFT:
+                return x == 0 || hasEastWall(x - 1, y);
+        }
+        return true;
+    }
+
+    /**
+     * Bitmask (1 << Direction) of the directions without a wall
+     */
+    unsigned openDirections(int x, int y) const {
+        size_t i = bit(x, y);
+        unsigned open = 0;
+        if (y > 0 && !test(southWalls, i - getStride())) open |= 1u << TOP;
+        if (x < width - 1 && !test(eastWalls, i)) open |= 1u << RIGHT;
+        if (y < height - 1 && !test(southWalls, i)) open |= 1u << BOTTOM;
+        if (x > 0 && !test(eastWalls, i - 1)) open |= 1u << LEFT;
+        return open;
+    }
+
+    /**
+     * Open the wall between (x, y) and its neighbour in the given direction.
+     * Border walls are never removed.
+     */
+    void removeWall(int x, int y, Direction dir) {
+        switch (dir) {
+            case TOP:
+                if (y > 0) clear(southWalls, bit(x, y - 1));
+                break;
+            case RIGHT:
+                if (x < width - 1) clear(eastWalls, bit(x, y));
+                break;
+            case BOTTOM:
+                if (y < height - 1) clear(southWalls, bit(x, y));
+                break;
+            case LEFT:
+                if (x > 0) clear(eastWalls, bit(x - 1, y));
+                break;
+        }
+    }
+
+    /**
+     * Put back the wall between (x, y) and its neighbour in the given
+     * direction (the inverse of removeWall)
+     */
+    void addWall(int x, int y, Direction dir) {
+        switch (dir) {
+            case TOP:
+                if (y > 0) set(southWalls, bit(x, y - 1));
+                break;
+            case RIGHT:
+                if (x < width - 1) set(eastWalls, bit(x, y));
+                break;
+            case BOTTOM:
+                if (y < height - 1) set(southWalls, bit(x, y));
+                break;
+            case LEFT:
+                if (x > 0) set(eastWalls, bit(x - 1, y));
+                break;
+        }
+    }
+
+    bool isVisited(int x, int y) const { return test(visitedBits.data(), bit(x, y)); }
+    void markVisited(int x, int y) { set(visitedBits.data(), bit(x, y)); }
+
+    /**
+     * Bit-index accessors for hot loops. bitIndex(x, y) + 1 is the east
+     * neighbour and bitIndex(x, y) + getStride() the south neighbour.
+     */
+    size_t bitIndex(int x, int y) const { return bit(x, y); }
+    bool isVisitedAt(size_t i) const { return test(visitedBits.data(), i); }
+    void markVisitedAt(size_t i) { set(visitedBits.data(), i); }
+    void clearEastAt(size_t i) { clear(eastWalls, i); }
+    void clearSouthAt(size_t i) { clear(southWalls, i); }
+
+    /**
+     * Raw access to the packed words of one row
+     */
+    const uint64_t* eastRow(int y) const { return eastWalls + y * rowWords; }
+    const uint64_t* southRow(int y) const { return southWalls + y * rowWords; }
+    uint64_t* eastRow(int y) { return eastWalls + y * rowWords; }
+    uint64_t* southRow(int y) { return southWalls + y * rowWords; }
+
+    /**
+     * Number of open interior walls (passages). A perfect maze - connected
+     * and without loops - has exactly cellCount() - 1.
+     */
+    size_t countPassages() const {
+        if (width == 0 || height == 0) return 0;
+        size_t walls = 0;
+        for (int y = 0; y < height; y++) {
+            const uint64_t* east = eastRow(y);
+            const uint64_t* south = southRow(y);
+            for (size_t w = 0; w < rowWords; w++) {
+                // Mask off padding, plus the border walls of the last column/row
+                uint64_t valid = columnMask(w, width);
+                uint64_t eastValid = columnMask(w, width - 1);
+                walls += __builtin_popcountll(east[w] & eastValid);
+                if (y < height - 1) walls += __builtin_popcountll(south[w] & valid);
+            }
+        }
+        size_t interior = static_cast<size_t>(width - 1) * height + static_cast<size_t>(height - 1) * width;
+        return interior - walls;
+    }
+
+    /**
+     * Bytes held by the wall and visited planes
+     */
+    size_t memoryBytes() const {
+        return (storage.capacity() + visitedBits.capacity()) * sizeof(uint64_t);
+    }
+
+    /**
+     * Build a full Cell (all four walls) for compatibility with older callers
+     */
+    Cell cellAt(int x, int y) const {
+        Cell cell(x, y);
+        cell.visited = isVisited(x, y);
+        for (int d = 0; d < 4; d++) {
+            cell.walls[d] = hasWall(x, y, static_cast<Direction>(d));
+        }
+        return cell;
+    }
+
+    RowView operator[](int y) const { return RowView(*this, y); }
+
+    /**
+     * FNV-1a hash of the wall planes (padding bits ignored), for comparing
+     * mazes produced by different code paths
+     */
+    uint64_t fingerprint() const {
+        uint64_t hash = 0xcbf29ce484222325ULL;
+        auto mixWord = [&hash](uint64_t word) {
+            for (int i = 0; i < 8; i++) {
+                hash ^= (word >> (8 * i)) & 0xFF;
+                hash *= 0x100000001b3ULL;
+            }
+        };
+        for (int y = 0; y < height; y++) {
+            for (size_t w = 0; w < rowWords; w++) {
+                uint64_t valid = columnMask(w, width);
+                mixWord(eastRow(y)[w] & valid);
+                mixWord(southRow(y)[w] & valid);
+            }
+        }
+        return hash;
+    }
+
+private:
+    // Bits of word w that belong to columns [0, limit)
+    static uint64_t columnMask(size_t w, int limit) {
+        size_t first = w * 64;
+        if (static_cast<size_t>(limit) <= first) return 0;
+        size_t n = static_cast<size_t>(limit) - first;
+        return n >= 64 ? ~0ULL : (1ULL << n) - 1;
+    }
+
+    void setDimensions(int w, int h) {
+        width = w > 0 ? w : 0;
+        height = h > 0 ? h : 0;
+        rowWords = (static_cast<size_t>(width) + 63) / 64;
+        planeWords = rowWords * static_cast<size_t>(height);
+    }
+
+    void bindOwned() {
+        eastWalls = storage.data();
+        southWalls = eastWalls + planeWords;
+    }
+
+    size_t bit(int x, int y) const {
+        return static_cast<size_t>(y) * rowWords * 64 + static_cast<size_t>(x);
+    }
+
+    static bool test(const uint64_t* plane, size_t i) {
+        return (plane[i >> 6] >> (i & 63)) & 1ULL;
+    }
+    static void set(uint64_t* plane, size_t i) {
+        plane[i >> 6] |= 1ULL << (i & 63);
+    }
+    static void clear(uint64_t* plane, size_t i) {
+        plane[i >> 6] &= ~(1ULL << (i & 63));
+    }
+
+    int width;
+    int height;
+    size_t rowWords;                  // 64-bit words per row
+    size_t planeWords;                // 64-bit words per plane
+    uint64_t* eastWalls;              // Bit set: wall to the right of the cell
+    uint64_t* southWalls;             // Bit set: wall below the cell
+    std::vector<uint64_t> storage;    // Owned east plane followed by south plane
+    std::vector<uint64_t> visitedBits;
+};
+
+#endif // MAZE_GRID_H
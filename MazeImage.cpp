@@ -0,0 +1,203 @@
+#include "MazeImage.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+/**
+ * Move bit i of v to bit 2i
+ */
+inline uint64_t spreadBits(uint32_t v) {
+    uint64_t x = v;
+    x = (x | (x << 16)) & 0x0000FFFF0000FFFFULL;
+    x = (x | (x << 8)) & 0x00FF00FF00FF00FFULL;
+    x = (x | (x << 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    x = (x | (x << 2)) & 0x3333333333333333ULL;
+    x = (x | (x << 1)) & 0x5555555555555555ULL;
+    return x;
+}
+
+inline bool testBit(const std::vector<uint64_t>& bits, size_t i) {
+    return (bits[i >> 6] >> (i & 63)) & 1ULL;
+}
+
+/**
+ * Set `count` pixels from `start` in an MSB-first packed line
+ */
+void setPixels(char* line, uint64_t start, uint64_t count) {
+    unsigned char* bytes = reinterpret_cast<unsigned char*>(line);
+    while (count > 0 && (start & 7)) {
+        bytes[start >> 3] |= static_cast<unsigned char>(0x80u >> (start & 7));
+        start++;
+        count--;
+    }
+    if (count >= 8) {
+        std::memset(bytes + (start >> 3), 0xFF, count >> 3);
+        start += count & ~7ULL;
+        count &= 7;
+    }
+    while (count > 0) {
+        bytes[start >> 3] |= static_cast<unsigned char>(0x80u >> (start & 7));
+        start++;
+        count--;
+    }
+}
+
+const char WALL_GRAY = 0;
+const char PATH_GRAY = static_cast<char>(128);
+const char FLOOR_GRAY = static_cast<char>(255);
+}
+
+bool parseRasterFormat(const std::string& name, RasterFormat& format) {
+    if (name == "pbm") {
+        format = RasterFormat::PBM;
+    } else if (name == "pgm") {
+        format = RasterFormat::PGM;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+RasterSink::RasterSink(std::ostream& os, const RasterOptions& rasterOptions, const std::vector<uint32_t>* solution)
+    : BufferedSink(os), options(rasterOptions), path(solution) {
+    options.cellPixels = std::max(options.cellPixels, 1);
+    options.wallPixels = std::max(options.wallPixels, 1);
+}
+
+uint64_t RasterSink::imageWidth(int width, const RasterOptions& options) {
+    return static_cast<uint64_t>(width + 1) * options.wallPixels + static_cast<uint64_t>(width) * options.cellPixels;
+}
+
+uint64_t RasterSink::imageHeight(int height, const RasterOptions& options) {
+    return imageWidth(height, options);
+}
+
+/**
+ * Header, path units sorted by unit row, then the top border
+ */
+void RasterSink::begin(int w, int h, unsigned int) {
+    width = w;
+    height = h;
+    rowsSeen = 0;
+    pixelRows = 0;
+
+    uint64_t pixelsWide = imageWidth(width, options);
+    lineBytes = options.format == RasterFormat::PBM ? static_cast<size_t>((pixelsWide + 7) / 8)
+                                                    : static_cast<size_t>(pixelsWide);
+    line.assign(lineBytes, 0);
+    unitWalls.assign((static_cast<size_t>(width) * 2 + 1) / 64 + 2, 0);
+
+    std::string header = options.format == RasterFormat::PBM ? "P4\n" : "P5\n";
+    header += std::to_string(pixelsWide) + " " + std::to_string(imageHeight(height, options)) + "\n";
+    if (options.format == RasterFormat::PGM) header += "255\n";
+    append(header.data(), header.size());
+
+    // Every path cell and every gap between consecutive path cells
+    pathUnits.clear();
+    pathCursor = 0;
+    if (path) {
+        const uint64_t cells = static_cast<uint64_t>(width) * height;
+        for (size_t i = 0; i < path->size(); i++) {
+            uint32_t cell = (*path)[i];
+            if (cell >= cells) continue;
+            uint64_t x = cell % width, y = cell / width;
+            pathUnits.push_back((2 * y + 1) << 32 | (2 * x + 1));
+            if (i > 0 && (*path)[i - 1] < cells) {
+                uint64_t px = (*path)[i - 1] % width, py = (*path)[i - 1] / width;
+                pathUnits.push_back((y + py + 1) << 32 | (x + px + 1));
+            }
+        }
+        std::sort(pathUnits.begin(), pathUnits.end());
+        pathUnits.erase(std::unique(pathUnits.begin(), pathUnits.end()), pathUnits.end());
+    }
+
+    std::fill(unitWalls.begin(), unitWalls.end(), ~0ULL);
+    emitUnitRow(0);
+}
+
+/**
+ * Cell line (walls on even units from the east words), then the line of
+ * south walls (odd units) unless this is the last row
+ */
+void RasterSink::row(const uint64_t* eastRow, const uint64_t* southRow) {
+    const size_t chunks = (static_cast<size_t>(width) + 31) / 32;
+
+    // Cell line: unit 0 is the left border, unit 2x + 2 the east wall of x
+    std::fill(unitWalls.begin(), unitWalls.end(), 0);
+    for (size_t j = 0; j < chunks; j++) {
+        uint64_t spread = spreadBits(static_cast<uint32_t>(eastRow[j >> 1] >> (32 * (j & 1))));
+        unitWalls[j] |= spread << 2;
+        unitWalls[j + 1] |= spread >> 62;
+    }
+    unitWalls[0] |= 1;
+    unitWalls[width >> 5] |= 1ULL << ((2 * static_cast<size_t>(width)) & 63);  // Right border
+    emitUnitRow(static_cast<uint32_t>(2 * rowsSeen + 1));
+
+    rowsSeen++;
+    if (rowsSeen < height) {
+        // Separator: unit 2x + 1 is the south wall of x, even units are corners
+        std::fill(unitWalls.begin(), unitWalls.end(), 0x5555555555555555ULL);
+        for (size_t j = 0; j < chunks; j++) {
+            uint64_t spread = spreadBits(static_cast<uint32_t>(southRow[j >> 1] >> (32 * (j & 1))));
+            unitWalls[j] |= spread << 1;
+            unitWalls[j + 1] |= spread >> 63;
+        }
+        emitUnitRow(static_cast<uint32_t>(2 * rowsSeen));
+    }
+}
+
+/**
+ * Bottom border
+ */
+void RasterSink::end() {
+    std::fill(unitWalls.begin(), unitWalls.end(), ~0ULL);
+    emitUnitRow(static_cast<uint32_t>(2 * height));
+    flush();
+}
+
+/**
+ * Write one unit row as wallPixels or cellPixels identical pixel lines
+ * (PBM path dithering alternates between two lines)
+ */
+void RasterSink::emitUnitRow(uint32_t unitY) {
+    rowPath.clear();
+    while (pathCursor < pathUnits.size() && (pathUnits[pathCursor] >> 32) == unitY) {
+        rowPath.push_back(static_cast<uint32_t>(pathUnits[pathCursor++]));
+    }
+
+    int repeat = (unitY & 1) ? options.cellPixels : options.wallPixels;
+    bool dithered = options.format == RasterFormat::PBM && !rowPath.empty();
+    if (!dithered) renderLine(0);
+    for (int r = 0; r < repeat; r++) {
+        if (dithered) renderLine(static_cast<int>(pixelRows & 1));
+        append(line.data(), lineBytes);
+        pixelRows++;
+    }
+}
+
+/**
+ * Expand the unit row into one pixel line
+ */
+void RasterSink::renderLine(int phase) {
+    const uint32_t units = static_cast<uint32_t>(width) * 2 + 1;
+    const bool pbm = options.format == RasterFormat::PBM;
+    if (pbm) std::fill(line.begin(), line.end(), 0);
+
+    size_t nextPath = 0;
+    uint64_t px = 0;
+    for (uint32_t u = 0; u < units; u++) {
+        uint64_t run = (u & 1) ? options.cellPixels : options.wallPixels;
+        bool wall = testBit(unitWalls, u);
+        bool onPath = nextPath < rowPath.size() && rowPath[nextPath] == u;
+        if (onPath) nextPath++;
+
+        if (!pbm) {
+            std::memset(&line[px], wall ? WALL_GRAY : (onPath ? PATH_GRAY : FLOOR_GRAY), run);
+        } else if (wall) {
+            setPixels(line.data(), px, run);
+        } else if (onPath) {
+            for (uint64_t i = (px + phase) & 1 ? 0 : 1; i < run; i += 2) setPixels(line.data(), px + i, 1);
+        }
+        px += run;
+    }
+}
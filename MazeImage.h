@@ -0,0 +1,76 @@
+#ifndef MAZE_IMAGE_H
+#define MAZE_IMAGE_H
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "MazeStream.h"
+
+/**
+ * Binary Netpbm raster formats
+ */
+enum class RasterFormat {
+    PBM,  // P4, 1 bit per pixel (walls black); a path is drawn as a 50% dither
+    PGM   // P5, 8 bits per pixel: walls 0, path 128, floor 255
+};
+
+/**
+ * Parse "pbm" or "pgm"; returns false for anything else
+ */
+bool parseRasterFormat(const std::string& name, RasterFormat& format);
+
+struct RasterOptions {
+    RasterFormat format = RasterFormat::PGM;
+    int cellPixels = 4;  // Side of the open area of a cell
+    int wallPixels = 1;  // Wall thickness
+};
+
+/**
+ * Raster image of a maze, written in one pass over the rows
+ *
+ * Same layout as the ASCII renderer: (2w + 1) x (2h + 1) units where even
+ * units are walls or corners (wallPixels wide) and odd units are cells or
+ * the gaps between them (cellPixels wide). Each unit row is first built
+ * as a bit-packed wall mask straight from the row's wall words, then
+ * expanded into one pixel line that is written as many times as the unit
+ * is tall. Memory is one unit row, one pixel line and the path (if any),
+ * whatever the height - so it also works as a sink for streaming
+ * generation.
+ *
+ * The optional path is a list of cell indices (y * width + x) with
+ * consecutive cells adjacent, e.g. from MazeSolver::solve.
+ */
+class RasterSink : public BufferedSink {
+public:
+    RasterSink(std::ostream& os, const RasterOptions& options, const std::vector<uint32_t>* path = nullptr);
+
+    void begin(int width, int height, unsigned int seed) override;
+    void row(const uint64_t* eastRow, const uint64_t* southRow) override;
+    void end() override;
+
+    /**
+     * Image size in pixels for a width x height maze
+     */
+    static uint64_t imageWidth(int width, const RasterOptions& options);
+    static uint64_t imageHeight(int height, const RasterOptions& options);
+
+private:
+    void emitUnitRow(uint32_t unitY);
+    void renderLine(int phase);
+
+    RasterOptions options;
+    const std::vector<uint32_t>* path;
+    int width = 0;
+    int height = 0;
+    int rowsSeen = 0;
+    uint64_t pixelRows = 0;            // Pixel lines written so far
+    size_t lineBytes = 0;
+    std::vector<uint64_t> unitWalls;   // Wall bit per unit of the current unit row
+    std::vector<uint64_t> pathUnits;   // Sorted (unitY << 32 | unitX) of path units
+    size_t pathCursor = 0;
+    std::vector<uint32_t> rowPath;     // Path unit columns of the current unit row
+    std::vector<char> line;            // One pixel line
+};
+
+#endif // MAZE_IMAGE_H
@@ -0,0 +1,212 @@
+#include "MazeInstrumentation.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#if defined(MAZE_INSTRUMENT) && defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define MAZE_PERF_EVENTS 1
+#endif
+
+#ifdef MAZE_INSTRUMENT
+namespace {
+std::atomic<uint64_t> cellsVisited{0};
+std::atomic<uint64_t> backtracks{0};
+std::atomic<uint64_t> maxStackDepth{0};
+std::atomic<uint64_t> allocations{0};
+std::atomic<uint64_t> bytesAllocated{0};
+std::atomic<uint64_t> nodesExpanded{0};
+
+void* countedAllocation(std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    bytesAllocated.fetch_add(size, std::memory_order_relaxed);
+    if (size == 0) size = 1;
+    void* block = std::malloc(size);
+    if (!block) throw std::bad_alloc();
+    return block;
+}
+
+// Over-aligned types (Maze, through MazeRandom's alignas(32) buffers)
+void* countedAllocation(std::size_t size, std::align_val_t alignment) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    bytesAllocated.fetch_add(size, std::memory_order_relaxed);
+    // aligned_alloc wants a whole number of alignment units
+    std::size_t align = static_cast<std::size_t>(alignment);
+    std::size_t rounded = (size + align - 1) / align * align;
+    void* block = std::aligned_alloc(align, rounded ? rounded : align);
+    if (!block) throw std::bad_alloc();
+    return block;
+}
+}
+
+/**
+ * Count every allocation in the process, aligned ones included; the
+ * nothrow forms of the library call these
+ */
+void* operator new(std::size_t size) { return countedAllocation(size); }
+void* operator new[](std::size_t size) { return countedAllocation(size); }
+void* operator new(std::size_t size, std::align_val_t alignment) { return countedAllocation(size, alignment); }
+void* operator new[](std::size_t size, std::align_val_t alignment) { return countedAllocation(size, alignment); }
+void operator delete(void* block) noexcept { std::free(block); }
+void operator delete[](void* block) noexcept { std::free(block); }
+void operator delete(void* block, std::size_t) noexcept { std::free(block); }
+void operator delete[](void* block, std::size_t) noexcept { std::free(block); }
+void operator delete(void* block, std::align_val_t) noexcept { std::free(block); }
+void operator delete[](void* block, std::align_val_t) noexcept { std::free(block); }
+void operator delete(void* block, std::size_t, std::align_val_t) noexcept { std::free(block); }
+void operator delete[](void* block, std::size_t, std::align_val_t) noexcept { std::free(block); }
+
+CounterScope::~CounterScope() {
+    if (visited) cellsVisited.fetch_add(visited, std::memory_order_relaxed);
+    if (backtracks) ::backtracks.fetch_add(backtracks, std::memory_order_relaxed);
+    if (expanded) nodesExpanded.fetch_add(expanded, std::memory_order_relaxed);
+    uint64_t seen = maxStackDepth.load(std::memory_order_relaxed);
+    while (maxDepth > seen && !maxStackDepth.compare_exchange_weak(seen, maxDepth, std::memory_order_relaxed)) {
+    }
+}
+
+MazeCounters mazeCounters() {
+    MazeCounters counters;
+    counters.cellsVisited = cellsVisited.load(std::memory_order_relaxed);
+    counters.backtracks = backtracks.load(std::memory_order_relaxed);
+    counters.maxStackDepth = maxStackDepth.load(std::memory_order_relaxed);
+    counters.allocations = allocations.load(std::memory_order_relaxed);
+    counters.bytesAllocated = bytesAllocated.load(std::memory_order_relaxed);
+    counters.nodesExpanded = nodesExpanded.load(std::memory_order_relaxed);
+    return counters;
+}
+
+void resetMazeCounters() {
+    for (std::atomic<uint64_t>* counter : {&cellsVisited, &backtracks, &maxStackDepth, &allocations,
+                                           &bytesAllocated, &nodesExpanded}) {
+        counter->store(0, std::memory_order_relaxed);
+    }
+}
+#else
+MazeCounters mazeCounters() { return MazeCounters(); }
+void resetMazeCounters() {}
+#endif
+
+/**
+ * Open the hardware counters once; they run for the profiler's lifetime
+ * and phases take differences
+ */
+PhaseProfiler::PhaseProfiler() {
+#ifdef MAZE_PERF_EVENTS
+    const uint64_t events[4] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES,
+                                PERF_COUNT_HW_BRANCH_MISSES};
+    for (int i = 0; i < 4; i++) {
+        perf_event_attr attr{};
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = events[i];
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        perfFds[i] = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, PERF_FLAG_FD_CLOEXEC));
+        if (perfFds[i] < 0) {
+            // All or nothing, so a report never mixes real and missing counts
+            for (int j = 0; j <= i; j++) {
+                if (perfFds[j] >= 0) ::close(perfFds[j]);
+                perfFds[j] = -1;
+            }
+            break;
+        }
+    }
+#endif
+}
+
+PhaseProfiler::~PhaseProfiler() {
+#ifdef MAZE_PERF_EVENTS
+    for (int fd : perfFds) {
+        if (fd >= 0) ::close(fd);
+    }
+#endif
+}
+
+bool PhaseProfiler::hardwareAvailable() const {
+    return perfFds[0] >= 0;
+}
+
+void PhaseProfiler::readHardware(uint64_t values[4]) const {
+    for (int i = 0; i < 4; i++) {
+        values[i] = 0;
+#ifdef MAZE_PERF_EVENTS
+        if (perfFds[i] >= 0 && ::read(perfFds[i], &values[i], sizeof(values[i])) != sizeof(values[i])) {
+            values[i] = 0;
+        }
+#endif
+    }
+}
+
+void PhaseProfiler::begin(const std::string& name) {
+    end();
+    current = Phase();
+    current.name = name;
+    open = true;
+#ifdef MAZE_INSTRUMENT
+    maxStackDepth.store(0, std::memory_order_relaxed);
+#endif
+    before = mazeCounters();
+    if (hardwareAvailable()) readHardware(hardwareBefore);
+    started = std::chrono::steady_clock::now();
+}
+
+void PhaseProfiler::end() {
+    if (!open) return;
+    auto finished = std::chrono::steady_clock::now();
+    open = false;
+    current.milliseconds = std::chrono::duration<double, std::milli>(finished - started).count();
+
+    if (hardwareAvailable()) {
+        uint64_t after[4];
+        readHardware(after);
+        current.hardware.available = true;
+        current.hardware.cycles = after[0] - hardwareBefore[0];
+        current.hardware.instructions = after[1] - hardwareBefore[1];
+        current.hardware.cacheMisses = after[2] - hardwareBefore[2];
+        current.hardware.branchMisses = after[3] - hardwareBefore[3];
+    }
+
+    MazeCounters after = mazeCounters();
+    current.counters.cellsVisited = after.cellsVisited - before.cellsVisited;
+    current.counters.backtracks = after.backtracks - before.backtracks;
+    current.counters.maxStackDepth = after.maxStackDepth;
+    current.counters.allocations = after.allocations - before.allocations;
+    current.counters.bytesAllocated = after.bytesAllocated - before.bytesAllocated;
+    current.counters.nodesExpanded = after.nodesExpanded - before.nodesExpanded;
+    done.push_back(current);
+}
+
+const PhaseProfiler::Phase* PhaseProfiler::find(const std::string& name) const {
+    for (const Phase& phase : done) {
+        if (phase.name == name) return &phase;
+    }
+    return nullptr;
+}
+
+void PhaseProfiler::writeJson(std::ostream& out) const {
+    std::ios::fmtflags flags = out.flags();
+    out << "[";
+    for (size_t i = 0; i < done.size(); i++) {
+        const Phase& phase = done[i];
+        const MazeCounters& c = phase.counters;
+        out << (i ? "," : "") << "{\"name\":\"" << phase.name << "\",\"ms\":" << std::fixed << phase.milliseconds;
+        out.flags(flags);
+        if (MAZE_INSTRUMENTED) {
+            out << ",\"cells_visited\":" << c.cellsVisited << ",\"backtracks\":" << c.backtracks
+                << ",\"max_stack_depth\":" << c.maxStackDepth << ",\"allocations\":" << c.allocations
+                << ",\"bytes_allocated\":" << c.bytesAllocated << ",\"nodes_expanded\":" << c.nodesExpanded;
+        }
+        if (phase.hardware.available) {
+            const HardwareCounters& h = phase.hardware;
+            out << ",\"cycles\":" << h.cycles << ",\"instructions\":" << h.instructions
+                << ",\"cache_misses\":" << h.cacheMisses << ",\"branch_misses\":" << h.branchMisses;
+        }
+        out << "}";
+    }
+    out << "]";
+    out.flags(flags);
+}
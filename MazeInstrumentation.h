@@ -0,0 +1,137 @@
+#ifndef MAZE_INSTRUMENTATION_H
+#define MAZE_INSTRUMENTATION_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * Engine instrumentation, compiled in only with -DMAZE_INSTRUMENT
+ * (`make instrument`)
+ *
+ * Without the macro CounterScope is an empty class whose methods inline
+ * to nothing, no counter storage exists and operator new is the
+ * library's, so the hot loops are unchanged. PhaseProfiler still times
+ * phases either way; its counter fields then stay zero.
+ */
+#ifdef MAZE_INSTRUMENT
+const bool MAZE_INSTRUMENTED = true;
+#else
+const bool MAZE_INSTRUMENTED = false;
+#endif
+
+/**
+ * Process-wide totals since the last resetMazeCounters()
+ */
+struct MazeCounters {
+    uint64_t cellsVisited = 0;     // Cells added by generators (Wilson: every random-walk step)
+    uint64_t backtracks = 0;       // Stack pops in the DFS and recursive generators
+    uint64_t maxStackDepth = 0;    // Deepest generator stack (a maximum, not a sum)
+    uint64_t allocations = 0;      // operator new calls (aligned too), whole process
+    uint64_t bytesAllocated = 0;
+    uint64_t nodesExpanded = 0;    // MazeSolver, summed over queries
+};
+
+MazeCounters mazeCounters();
+void resetMazeCounters();
+
+/**
+ * Per-call counter accumulator for hot loops
+ *
+ * Counts stay in the object (registers, in practice) and are added to the
+ * process totals once, by the destructor, so threads only touch the
+ * shared atomics when a generation or query finishes.
+ */
+#ifdef MAZE_INSTRUMENT
+class CounterScope {
+public:
+    CounterScope() = default;
+    CounterScope(const CounterScope&) = delete;
+    CounterScope& operator=(const CounterScope&) = delete;
+    ~CounterScope();
+
+    void visit(uint64_t count = 1) { visited += count; }
+    void backtrack() { backtracks++; }
+    void depth(size_t size) { if (size > maxDepth) maxDepth = size; }
+    void expand(uint64_t count) { expanded += count; }
+
+private:
+    uint64_t visited = 0;
+    uint64_t backtracks = 0;
+    uint64_t maxDepth = 0;
+    uint64_t expanded = 0;
+};
+#else
+class CounterScope {
+public:
+    void visit(uint64_t = 1) {}
+    void backtrack() {}
+    void depth(size_t) {}
+    void expand(uint64_t) {}
+};
+#endif
+
+/**
+ * Hardware counters of the calling thread (user space only), read through
+ * Linux perf_event_open. `available` is false when the build is not
+ * instrumented, the platform is not Linux, or the kernel refused the
+ * events (perf_event_paranoid, containers, VMs without a PMU).
+ */
+struct HardwareCounters {
+    bool available = false;
+    uint64_t cycles = 0;
+    uint64_t instructions = 0;
+    uint64_t cacheMisses = 0;
+    uint64_t branchMisses = 0;
+};
+
+/**
+ * Named phases with wall time, counter deltas and hardware counters
+ *
+ * begin() ends any open phase. maxStackDepth is reset at every begin(),
+ * so each phase reports its own maximum. Hardware counters only cover
+ * the thread that calls begin()/end(), not pool workers.
+ */
+class PhaseProfiler {
+public:
+    struct Phase {
+        std::string name;
+        double milliseconds = 0;
+        MazeCounters counters;
+        HardwareCounters hardware;
+    };
+
+    PhaseProfiler();
+    ~PhaseProfiler();
+
+    PhaseProfiler(const PhaseProfiler&) = delete;
+    PhaseProfiler& operator=(const PhaseProfiler&) = delete;
+
+    void begin(const std::string& name);
+    void end();
+
+    const std::vector<Phase>& phases() const { return done; }
+    const Phase* find(const std::string& name) const;
+    bool hardwareAvailable() const;
+
+    /**
+     * JSON array of the finished phases
+     */
+    void writeJson(std::ostream& out) const;
+
+private:
+    void readHardware(uint64_t values[4]) const;
+
+    std::vector<Phase> done;
+    bool open = false;
+    Phase current;
+    std::chrono::steady_clock::time_point started;
+    MazeCounters before;
+    uint64_t hardwareBefore[4] = {0, 0, 0, 0};
+    int perfFds[4] = {-1, -1, -1, -1};  // cycles, instructions, cache misses, branch misses
+};
+
+#endif // MAZE_INSTRUMENTATION_H
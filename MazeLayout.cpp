@@ -0,0 +1,96 @@
+#include "MazeLayout.h"
+#include <utility>
+
+namespace {
+#ifdef MAZE_LAYOUT_X86
+bool cpuHasBmi2() {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("bmi2");
+}
+
+const bool BMI2_SUPPORTED = cpuHasBmi2();
+bool bmi2Enabled = BMI2_SUPPORTED;
+#else
+bool bmi2Enabled = false;
+#endif
+
+/**
+ * Both directions of the Hilbert curve over one tile
+ */
+struct HilbertTables {
+    uint16_t toCurve[TiledIndex::TILE_CELLS];
+    uint16_t fromCurve[TiledIndex::TILE_CELLS];
+
+    HilbertTables() {
+        for (uint32_t d = 0; d < TiledIndex::TILE_CELLS; d++) {
+            // Classic d -> (x, y): two bits of d per level, rotating the quadrant
+            int x = 0, y = 0;
+            uint32_t t = d;
+            for (int s = 1; s < TiledIndex::TILE; s *= 2) {
+                int rx = 1 & static_cast<int>(t / 2);
+                int ry = 1 & static_cast<int>(t ^ static_cast<uint32_t>(rx));
+                if (ry == 0) {
+                    if (rx == 1) {
+                        x = s - 1 - x;
+                        y = s - 1 - y;
+                    }
+                    std::swap(x, y);
+                }
+                x += s * rx;
+                y += s * ry;
+                t /= 4;
+            }
+            uint16_t packed = static_cast<uint16_t>((y << TiledIndex::TILE_BITS) | x);
+            fromCurve[d] = packed;
+            toCurve[packed] = static_cast<uint16_t>(d);
+        }
+    }
+};
+
+const HilbertTables& hilbertTables() {
+    static const HilbertTables tables;
+    return tables;
+}
+}
+
+const char* cellLayoutName(CellLayout layout) {
+    switch (layout) {
+        case CellLayout::ROW_MAJOR: return "row-major";
+        case CellLayout::MORTON: return "morton";
+        case CellLayout::HILBERT: return "hilbert";
+    }
+    return "unknown";
+}
+
+bool parseCellLayout(const std::string& name, CellLayout& layout) {
+    if (name == "row" || name == "row-major") layout = CellLayout::ROW_MAJOR;
+    else if (name == "morton" || name == "z") layout = CellLayout::MORTON;
+    else if (name == "hilbert") layout = CellLayout::HILBERT;
+    else return false;
+    return true;
+}
+
+bool layoutUsesBmi2() {
+    return bmi2Enabled;
+}
+
+void setLayoutBmi2(bool enable) {
+#ifdef MAZE_LAYOUT_X86
+    bmi2Enabled = enable && BMI2_SUPPORTED;
+#else
+    (void)enable;
+#endif
+}
+
+TiledIndex::TiledIndex(int width, int height)
+    : tilesPerRow(static_cast<uint32_t>((width + TILE - 1) >> TILE_BITS)),
+      tileRows(static_cast<uint32_t>((height + TILE - 1) >> TILE_BITS)) {
+    if (tilesPerRow == 0) tilesPerRow = 1;
+    reciprocal = ((1ULL << 32) + tilesPerRow - 1) / tilesPerRow;
+}
+
+HilbertIndex::HilbertIndex(int width, int height) : TiledIndex(width, height) {
+    const HilbertTables& tables = hilbertTables();
+    toCurve = tables.toCurve;
+    fromCurve = tables.fromCurve;
+}
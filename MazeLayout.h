@@ -0,0 +1,209 @@
+#ifndef MAZE_LAYOUT_H
+#define MAZE_LAYOUT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "MazeGrid.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define MAZE_LAYOUT_X86 1
+#endif
+
+/**
+ * Memory order of the solver's per-cell scratch (distances, parents and
+ * visited stamps)
+ *
+ * Row-major scratch puts a cell's north and south neighbours a whole row
+ * away, so every vertical step of a BFS or DFS on a wide maze touches a
+ * new cache line, and often a new page. The tiled layouts keep 64 x 64
+ * cells (16 KB of 32-bit entries) together and order them along a
+ * space-filling curve, so most vertical neighbours share a line with the
+ * cell. Tiles are in row-major order; the index space is padded to whole
+ * tiles.
+ *
+ * The wall planes are not affected: they stay row-major bit planes (two
+ * bits per cell, so a row of an 8000-wide maze is 1 KB), which the
+ * row-parallel code - flood fill, streaming, rendering, files - depends
+ * on. Paths and other results are row-major cell indices whatever the
+ * layout.
+ *
+ * Generators and renderers stay row-major and do not read CellLayout.
+ * A generator's visited set is one bit per cell, next to the wall planes,
+ * so a 4000 x 4000 maze's set is 2 MB and a vertical step rarely leaves
+ * the cache. Renderers read the rows in order, which row-major already
+ * serves best.
+ */
+enum class CellLayout {
+    ROW_MAJOR,  // y * width + x
+    MORTON,     // Z-order inside each tile
+    HILBERT     // Hilbert curve inside each tile
+};
+
+const int CELL_LAYOUT_COUNT = 3;
+
+const char* cellLayoutName(CellLayout layout);
+bool parseCellLayout(const std::string& name, CellLayout& layout);  // "row", "morton", "hilbert"
+
+/**
+ * True when Morton indices are computed with BMI2 pdep/pext.
+ * setLayoutBmi2(false) forces the scalar bit-spreading code (for
+ * comparison); it cannot enable BMI2 on a CPU without it.
+ */
+bool layoutUsesBmi2();
+void setLayoutBmi2(bool enable);
+
+/**
+ * Indexing used by the traversal kernels, which are templates over it:
+ * index() and coords() convert between (x, y) and the scratch index,
+ * neighbour() steps from a cell whose coordinates are known, size() is
+ * the index space to allocate.
+ */
+class RowMajorIndex {
+public:
+    RowMajorIndex(int width, int height) : width(width), cells(static_cast<size_t>(width) * height) {}
+
+    size_t size() const { return cells; }
+    uint32_t index(int x, int y) const {
+        return static_cast<uint32_t>(y) * static_cast<uint32_t>(width) + static_cast<uint32_t>(x);
+    }
+    void coords(uint32_t i, int& x, int& y) const {
+        x = static_cast<int>(i % static_cast<uint32_t>(width));
+        y = static_cast<int>(i / static_cast<uint32_t>(width));
+    }
+    uint32_t neighbour(uint32_t i, int, int, Direction dir) const {
+        switch (dir) {
+            case TOP: return i - static_cast<uint32_t>(width);
+            case RIGHT: return i + 1;
+            case BOTTOM: return i + static_cast<uint32_t>(width);
+            default: return i - 1;
+        }
+    }
+
+private:
+    int width;
+    size_t cells;
+};
+
+/**
+ * Tile arithmetic shared by the curve layouts. The tile row of an index
+ * is found with a multiply by a 32-bit reciprocal instead of a division
+ * (exact because tile counts stay far below 2^32 / tiles per row).
+ */
+class TiledIndex {
+public:
+    static constexpr int TILE_BITS = 6;
+    static constexpr int TILE = 1 << TILE_BITS;
+    static constexpr uint32_t TILE_CELLS = 1u << (2 * TILE_BITS);
+
+    TiledIndex(int width, int height);
+
+    size_t size() const { return static_cast<size_t>(tilesPerRow) * tileRows * TILE_CELLS; }
+
+protected:
+    uint32_t tileBase(int x, int y) const {
+        return (static_cast<uint32_t>(y >> TILE_BITS) * tilesPerRow + static_cast<uint32_t>(x >> TILE_BITS))
+               << (2 * TILE_BITS);
+    }
+    void tileOrigin(uint32_t i, int& x, int& y) const {
+        uint32_t tile = i >> (2 * TILE_BITS);
+        uint32_t row = static_cast<uint32_t>((static_cast<uint64_t>(tile) * reciprocal) >> 32);
+        x = static_cast<int>((tile - row * tilesPerRow) << TILE_BITS);
+        y = static_cast<int>(row << TILE_BITS);
+    }
+
+    uint32_t tilesPerRow;
+    uint32_t tileRows;
+    uint64_t reciprocal;  // ceil(2^32 / tilesPerRow)
+};
+
+/**
+ * Interleave the 6-bit in-tile x (even bits) and y (odd bits)
+ */
+struct MortonScalar {
+    static uint32_t encode(uint32_t x, uint32_t y) { return spread(x) | (spread(y) << 1); }
+    static void decode(uint32_t m, uint32_t& x, uint32_t& y) {
+        x = compact(m);
+        y = compact(m >> 1);
+    }
+
+private:
+    static uint32_t spread(uint32_t v) {
+        v = (v | (v << 4)) & 0x0F0Fu;
+        v = (v | (v << 2)) & 0x3333u;
+        return (v | (v << 1)) & 0x5555u;
+    }
+    static uint32_t compact(uint32_t v) {
+        v &= 0x5555u;
+        v = (v | (v >> 1)) & 0x3333u;
+        v = (v | (v >> 2)) & 0x0F0Fu;
+        return (v | (v >> 4)) & 0x00FFu;
+    }
+};
+
+#ifdef MAZE_LAYOUT_X86
+/**
+ * The same with BMI2. Only inlined into kernels compiled for BMI2 (see
+ * MazeSolver); anywhere else these are plain calls.
+ */
+struct MortonBmi2 {
+    __attribute__((target("bmi2"))) static uint32_t encode(uint32_t x, uint32_t y) {
+        return _pdep_u32(x, 0x555u) | _pdep_u32(y, 0xAAAu);
+    }
+    __attribute__((target("bmi2"))) static void decode(uint32_t m, uint32_t& x, uint32_t& y) {
+        x = _pext_u32(m, 0x555u);
+        y = _pext_u32(m, 0xAAAu);
+    }
+};
+#endif
+
+template <class Codec>
+class MortonIndex : public TiledIndex {
+public:
+    using TiledIndex::TiledIndex;
+
+    uint32_t index(int x, int y) const {
+        return tileBase(x, y) | Codec::encode(static_cast<uint32_t>(x) & (TILE - 1),
+                                              static_cast<uint32_t>(y) & (TILE - 1));
+    }
+    void coords(uint32_t i, int& x, int& y) const {
+        tileOrigin(i, x, y);
+        uint32_t cx, cy;
+        Codec::decode(i & (TILE_CELLS - 1), cx, cy);
+        x += static_cast<int>(cx);
+        y += static_cast<int>(cy);
+    }
+    uint32_t neighbour(uint32_t, int x, int y, Direction dir) const {
+        return index(x + DX[dir], y + DY[dir]);
+    }
+};
+
+/**
+ * Hilbert order inside a tile through two 4096-entry tables (8 KB each),
+ * built once per process
+ */
+class HilbertIndex : public TiledIndex {
+public:
+    HilbertIndex(int width, int height);
+
+    uint32_t index(int x, int y) const {
+        return tileBase(x, y) | toCurve[((static_cast<uint32_t>(y) & (TILE - 1)) << TILE_BITS) |
+                                        (static_cast<uint32_t>(x) & (TILE - 1))];
+    }
+    void coords(uint32_t i, int& x, int& y) const {
+        tileOrigin(i, x, y);
+        uint32_t packed = fromCurve[i & (TILE_CELLS - 1)];
+        x += static_cast<int>(packed & (TILE - 1));
+        y += static_cast<int>(packed >> TILE_BITS);
+    }
+    uint32_t neighbour(uint32_t, int x, int y, Direction dir) const {
+        return index(x + DX[dir], y + DY[dir]);
+    }
+
+private:
+    const uint16_t* toCurve;    // (y << 6 | x) -> curve position
+    const uint16_t* fromCurve;  // Curve position -> (y << 6 | x)
+};
+
+#endif // MAZE_LAYOUT_H
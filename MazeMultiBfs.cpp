@@ -0,0 +1,337 @@
+#include "MazeMultiBfs.h"
+#include <algorithm>
+
+namespace {
+// Tree index lookups per pool task
+const size_t TREE_CHUNK = 4096;
+}
+
+size_t MazeMultiBfs::memoryBytes() const {
+    size_t bytes = (order.capacity() + starts.capacity() + firstQuery.capacity() + targetHead.capacity()
+                    + targetColumns.capacity()) * sizeof(uint32_t) + exits.capacity() + tree.memoryBytes();
+    for (const Lanes& lanes : workers) {
+        bytes += (lanes.seen.capacity() + lanes.wanted.capacity()) * sizeof(uint64_t)
+               + (lanes.active.capacity() + lanes.arriving.capacity()) * sizeof(Wave)
+               + (lanes.distance.capacity() + lanes.queue.capacity() + lanes.slots.capacity()) * sizeof(uint32_t);
+    }
+    return bytes;
+}
+
+/**
+ * Read the open directions of every cell and make room for a scratch set
+ * per worker; the sets themselves are sized by ready() on first use
+ */
+void MazeMultiBfs::prepare(const MazeGrid& grid, ThreadPool& pool) {
+    cells = grid.cellCount();
+    width = grid.getWidth();
+    exits.resize(cells);
+    for (int y = 0; y < grid.getHeight(); y++) {
+        for (int x = 0; x < width; x++) {
+            exits[static_cast<size_t>(y) * width + x] = static_cast<uint8_t>(grid.openDirections(x, y));
+        }
+    }
+    if (workers.size() < static_cast<size_t>(pool.size())) workers.resize(pool.size());
+    for (Lanes& lanes : workers) lanes.expansions = 0;
+    batchCount = 0;
+    expansionCount = 0;
+    treeUsed = false;
+}
+
+/**
+ * A worker's scratch for the current grid: the kernel's buffers, the
+ * distance array when results are not written to a field row, and the
+ * end markers of pair queries. All of them are left cleared by search().
+ */
+MazeMultiBfs::Lanes& MazeMultiBfs::ready(int worker, bool distances, bool ends) {
+    Lanes& lanes = workers[worker];
+    if (kernel == BatchKernel::BIT_PARALLEL) {
+        if (lanes.seen.size() != cells) lanes.seen.assign(cells, 0);
+    } else {
+        if (lanes.queue.size() != cells) lanes.queue.resize(cells);
+        if (distances && lanes.distance.size() != cells) lanes.distance.assign(cells, UNREACHED);
+    }
+    if (ends && lanes.wanted.size() != cells) lanes.wanted.assign(cells, 0);
+    return lanes;
+}
+
+void MazeMultiBfs::finish() {
+    for (const Lanes& lanes : workers) expansionCount += lanes.expansions;
+}
+
+/**
+ * Run one batch of sources with the current kernel: up to LANES sources
+ * bit-parallel, or one per-source BFS (count is 1). Out-of-range sources
+ * reach nothing. visit(cell, lanes, level) is called as lanes - bit k for
+ * sources[k] - first reach a cell, at most once per lane and cell;
+ * returning false ends the search. A per-source BFS keeps its distances
+ * in `row` when given (all UNREACHED on entry), else in the worker's own
+ * array.
+ */
+template <typename Visit>
+void MazeMultiBfs::search(const uint32_t* sources, size_t count, Lanes& lanes, uint32_t* row, Visit&& visit) {
+    if (kernel == BatchKernel::BIT_PARALLEL) {
+        searchLanes(sources, count, lanes, visit);
+        return;
+    }
+    uint32_t* distance = row ? row : lanes.distance.data();
+    const size_t reached = searchOne(sources[0], distance, lanes, visit);
+    if (!row) {
+        for (size_t i = 0; i < reached; i++) distance[lanes.queue[i]] = UNREACHED;
+    }
+}
+
+/**
+ * Plain BFS from one source over the shared direction table, marking
+ * cells in `distance`. Returns the number of cells queued, which are
+ * lanes.queue[0, n).
+ */
+template <typename Visit>
+size_t MazeMultiBfs::searchOne(uint32_t source, uint32_t* distance, Lanes& lanes, Visit&& visit) {
+    if (source >= cells) return 0;
+    const long long offset[4] = {-static_cast<long long>(width), 1, static_cast<long long>(width), -1};
+    uint32_t* queue = lanes.queue.data();
+    size_t head = 0, tail = 0;
+    queue[tail++] = source;
+    distance[source] = 0;
+    bool going = visit(source, 1ULL, 0u);
+    while (going && head < tail) {
+        const uint32_t cell = queue[head++];
+        const uint32_t level = distance[cell] + 1;
+        unsigned open = exits[cell];
+        while (open) {
+            unsigned dir = static_cast<unsigned>(__builtin_ctz(open));
+            open &= open - 1;
+            uint32_t to = static_cast<uint32_t>(cell + offset[dir]);
+            if (distance[to] != UNREACHED) continue;
+            distance[to] = level;
+            queue[tail++] = to;
+            if (!visit(to, 1ULL, level)) {
+                going = false;
+                break;
+            }
+        }
+        lanes.expansions++;
+    }
+    return tail;
+}
+
+/**
+ * Bit-parallel BFS from sources[0, count), lane k for sources[k]
+ */
+template <typename Visit>
+void MazeMultiBfs::searchLanes(const uint32_t* sources, size_t count, Lanes& lanes, Visit&& visit) {
+    const long long offset[4] = {-static_cast<long long>(width), 1, static_cast<long long>(width), -1};
+    std::vector<uint64_t>& seen = lanes.seen;
+    std::vector<Wave>& active = lanes.active;
+    std::vector<Wave>& arriving = lanes.arriving;
+
+    active.clear();
+    bool going = true;
+    for (size_t k = 0; k < count && going; k++) {
+        uint32_t cell = sources[k];
+        if (cell >= cells) continue;
+        seen[cell] |= 1ULL << k;
+        active.push_back({cell, 1ULL << k});
+        going = visit(cell, 1ULL << k, 0u);
+    }
+
+    // Cells are marked as they are found, so lanes reaching a cell from
+    // two sides in one level are expanded separately but never twice
+    uint32_t level = 0;
+    while (going && !active.empty()) {
+        arriving.clear();
+        level++;
+        for (size_t i = 0; i < active.size() && going; i++) {
+            const Wave wave = active[i];
+            unsigned open = exits[wave.cell];
+            while (open) {
+                unsigned dir = static_cast<unsigned>(__builtin_ctz(open));
+                open &= open - 1;
+                uint32_t to = static_cast<uint32_t>(wave.cell + offset[dir]);
+                uint64_t fresh = wave.bits & ~seen[to];
+                if (!fresh) continue;
+                seen[to] |= fresh;
+                arriving.push_back({to, fresh});
+                if (!visit(to, fresh, level)) {
+                    going = false;
+                    break;
+                }
+            }
+            lanes.expansions++;
+        }
+        active.swap(arriving);
+    }
+    std::fill(seen.begin(), seen.end(), 0);
+}
+
+bool MazeMultiBfs::distanceFields(const MazeGrid& grid, const std::vector<uint32_t>& sources,
+                                  std::vector<uint32_t>& fields, ThreadPool& pool) {
+    if (grid.cellCount() == 0) {
+        fields.clear();
+        return false;
+    }
+    prepare(grid, pool);
+    const size_t count = sources.size();
+    const size_t lanesPerBatch = batchWidth();
+    const bool direct = kernel == BatchKernel::PER_SOURCE;
+    fields.resize(count * cells);
+    batchCount = (count + lanesPerBatch - 1) / lanesPerBatch;
+    pool.parallelFor(batchCount, [&](size_t batch, int worker) {
+        const size_t first = batch * lanesPerBatch;
+        const size_t lanesUsed = std::min(lanesPerBatch, count - first);
+        uint32_t* rows = fields.data() + first * cells;
+        std::fill(rows, rows + lanesUsed * cells, UNREACHED);
+        search(sources.data() + first, lanesUsed, ready(worker, false, false), rows,
+               [&](uint32_t cell, uint64_t bits, uint32_t level) {
+            if (direct) return true;  // The BFS writes the row itself
+            while (bits) {
+                rows[static_cast<size_t>(__builtin_ctzll(bits)) * cells + cell] = level;
+                bits &= bits - 1;
+            }
+            return true;
+        });
+    });
+    finish();
+    return true;
+}
+
+bool MazeMultiBfs::distanceMatrix(const MazeGrid& grid, const std::vector<uint32_t>& sources,
+                                  const std::vector<uint32_t>& targets, std::vector<uint32_t>& matrix,
+                                  ThreadPool& pool) {
+    if (grid.cellCount() == 0) {
+        matrix.clear();
+        return false;
+    }
+    prepare(grid, pool);
+    const size_t columns = targets.size();
+    matrix.assign(sources.size() * columns, UNREACHED);
+
+    // Columns of each target cell (a cell may be listed more than once)
+    targetHead.assign(cells + 1, 0);
+    size_t validColumns = 0;
+    for (uint32_t target : targets) {
+        if (target >= cells) continue;
+        targetHead[target + 1]++;
+        validColumns++;
+    }
+    for (size_t c = 0; c < cells; c++) targetHead[c + 1] += targetHead[c];
+    targetColumns.resize(validColumns);
+    for (size_t j = 0; j < columns; j++) {
+        if (targets[j] < cells) targetColumns[targetHead[targets[j]]++] = static_cast<uint32_t>(j);
+    }
+    for (size_t c = cells; c > 0; c--) targetHead[c] = targetHead[c - 1];
+    targetHead[0] = 0;
+    if (validColumns == 0) return true;
+
+    const size_t count = sources.size();
+    const size_t lanesPerBatch = batchWidth();
+    batchCount = (count + lanesPerBatch - 1) / lanesPerBatch;
+    pool.parallelFor(batchCount, [&](size_t batch, int worker) {
+        const size_t first = batch * lanesPerBatch;
+        const size_t lanesUsed = std::min(lanesPerBatch, count - first);
+        uint32_t* rows = matrix.data() + first * columns;
+        size_t remaining = 0;
+        for (size_t k = 0; k < lanesUsed; k++) {
+            if (sources[first + k] < cells) remaining += validColumns;
+        }
+        search(sources.data() + first, lanesUsed, ready(worker, true, false), nullptr,
+               [&](uint32_t cell, uint64_t bits, uint32_t level) {
+            const uint32_t begin = targetHead[cell], end = targetHead[cell + 1];
+            if (begin == end) return true;
+            while (bits) {
+                uint32_t* row = rows + static_cast<size_t>(__builtin_ctzll(bits)) * columns;
+                bits &= bits - 1;
+                for (uint32_t i = begin; i < end; i++) row[targetColumns[i]] = level;
+                remaining -= end - begin;
+            }
+            return remaining > 0;
+        });
+    });
+    finish();
+    return true;
+}
+
+bool MazeMultiBfs::pairLengths(const MazeGrid& grid, const std::vector<Query>& queries,
+                               std::vector<uint32_t>& lengths, ThreadPool& pool) {
+    if (grid.cellCount() == 0) {
+        lengths.clear();
+        return false;
+    }
+    prepare(grid, pool);
+    lengths.assign(queries.size(), UNREACHED);
+
+    if (useTree && tree.build(grid)) {
+        treeUsed = true;
+        pool.parallelFor((queries.size() + TREE_CHUNK - 1) / TREE_CHUNK, [&](size_t chunk, int) {
+            const size_t end = std::min(queries.size(), (chunk + 1) * TREE_CHUNK);
+            for (size_t i = chunk * TREE_CHUNK; i < end; i++) {
+                const Query& query = queries[i];
+                if (query.start < cells && query.end < cells) lengths[i] = tree.distance(query.start, query.end);
+            }
+        });
+        return true;
+    }
+    tree.clear();
+
+    // Queries by (start, end); each distinct start is searched once
+    order.clear();
+    for (size_t i = 0; i < queries.size(); i++) {
+        if (queries[i].start < cells && queries[i].end < cells) order.push_back(static_cast<uint32_t>(i));
+    }
+    std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+        if (queries[a].start != queries[b].start) return queries[a].start < queries[b].start;
+        if (queries[a].end != queries[b].end) return queries[a].end < queries[b].end;
+        return a < b;
+    });
+    starts.clear();
+    firstQuery.clear();
+    for (size_t i = 0; i < order.size(); i++) {
+        if (i == 0 || queries[order[i]].start != starts.back()) {
+            starts.push_back(queries[order[i]].start);
+            firstQuery.push_back(static_cast<uint32_t>(i));
+        }
+    }
+    firstQuery.push_back(static_cast<uint32_t>(order.size()));
+
+    const size_t lanesPerBatch = batchWidth();
+    batchCount = (starts.size() + lanesPerBatch - 1) / lanesPerBatch;
+    pool.parallelFor(batchCount, [&](size_t batch, int worker) {
+        Lanes& lanes = ready(worker, true, true);
+        const size_t first = batch * lanesPerBatch;
+        const size_t lanesUsed = std::min(lanesPerBatch, starts.size() - first);
+
+        // Lanes waiting at each end cell; one count per distinct (lane, end)
+        size_t remaining = 0;
+        lanes.slots.clear();
+        for (size_t k = 0; k < lanesUsed; k++) {
+            for (uint32_t i = firstQuery[first + k]; i < firstQuery[first + k + 1]; i++) {
+                uint32_t end = queries[order[i]].end;
+                if (lanes.wanted[end] & (1ULL << k)) continue;
+                lanes.wanted[end] |= 1ULL << k;
+                lanes.slots.push_back(end);
+                remaining++;
+            }
+        }
+        search(starts.data() + first, lanesUsed, lanes, nullptr, [&](uint32_t cell, uint64_t bits, uint32_t level) {
+            uint64_t hits = bits & lanes.wanted[cell];
+            if (!hits) return true;
+            lanes.wanted[cell] &= ~hits;
+            while (hits) {
+                const size_t k = static_cast<size_t>(__builtin_ctzll(hits));
+                hits &= hits - 1;
+                // This lane's queries ending here are a run of the sorted order
+                const uint32_t* begin = order.data() + firstQuery[first + k];
+                const uint32_t* end = order.data() + firstQuery[first + k + 1];
+                const uint32_t* at = std::lower_bound(begin, end, cell, [&](uint32_t q, uint32_t c) {
+                    return queries[q].end < c;
+                });
+                for (; at != end && queries[*at].end == cell; ++at) lengths[*at] = level;
+                remaining--;
+            }
+            return remaining > 0;
+        });
+        for (uint32_t end : lanes.slots) lanes.wanted[end] = 0;
+    });
+    finish();
+    return true;
+}
@@ -0,0 +1,147 @@
+#ifndef MAZE_MULTI_BFS_H
+#define MAZE_MULTI_BFS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "MazeGrid.h"
+#include "MazeTreeIndex.h"
+#include "ThreadPool.h"
+
+/**
+ * How a batch of sources is searched
+ */
+enum class BatchKernel {
+    PER_SOURCE,     // One BFS per source, writing distance fields in place
+    BIT_PARALLEL    // LANES sources per BFS, one bit each in a per-cell mask
+};
+
+/**
+ * Batched distance queries over one maze: many distance fields, a source
+ * by target matrix, or many (start, end) pairs
+ *
+ * The open directions of every cell are read from the grid once per call
+ * into a byte table shared by all searches, so a search follows a cell's
+ * exits without touching the wall planes or dividing by the width.
+ * Searches run as tasks on a ThreadPool, each worker with its own
+ * scratch; results do not depend on the thread count or the kernel.
+ *
+ * PER_SOURCE runs a plain BFS per source. For fields it uses the output
+ * row itself as the visited set, so nothing is copied or cleared; other
+ * queries use a per-worker distance array, cleared afterwards from the
+ * queue. BIT_PARALLEL (multi-source BFS) carries a 64-bit mask of sources
+ * per cell and moves all of them with one AND-NOT and one OR per wall.
+ * That only saves work where sources reach a cell at the same distance
+ * through the same neighbour, which in mazes is rare: their diameter is
+ * large and random sources are almost never equidistant, so expansions()
+ * stays close to one BFS per source and the scattered mask and row writes
+ * make it slower. It is kept for comparison; see runMultiSourceBenchmark.
+ *
+ * Pair queries are grouped by start cell, so each distinct start is
+ * searched once, and a search stops as soon as all of its pairs are
+ * answered. On a perfect maze pairs are answered with a MazeTreeIndex
+ * instead - one O(n) build, then O(1) per pair - unless
+ * setTreeIndex(false).
+ *
+ * Cells are indices y * width + x. All scratch is kept between calls.
+ */
+class MazeMultiBfs {
+public:
+    static constexpr uint32_t UNREACHED = 0xFFFFFFFFu;
+    static constexpr size_t LANES = 64;
+
+    struct Query {
+        uint32_t start;
+        uint32_t end;
+    };
+
+    /**
+     * Distance from every source to every cell: fields[i * cells + c] for
+     * sources[i], UNREACHED where there is no path (and for whole rows of
+     * out-of-range sources). Returns false, leaving fields empty, if the
+     * grid is empty.
+     */
+    bool distanceFields(const MazeGrid& grid, const std::vector<uint32_t>& sources, std::vector<uint32_t>& fields,
+                        ThreadPool& pool);
+
+    /**
+     * Distances from every source to every target only:
+     * matrix[i * targets.size() + j]. A search stops once its sources
+     * have reached every target.
+     */
+    bool distanceMatrix(const MazeGrid& grid, const std::vector<uint32_t>& sources,
+                        const std::vector<uint32_t>& targets, std::vector<uint32_t>& matrix, ThreadPool& pool);
+
+    /**
+     * Shortest-path length of every pair: lengths[i] for queries[i],
+     * UNREACHED if there is no path or a cell is out of range
+     */
+    bool pairLengths(const MazeGrid& grid, const std::vector<Query>& queries, std::vector<uint32_t>& lengths,
+                     ThreadPool& pool);
+
+    void setKernel(BatchKernel batchKernel) { kernel = batchKernel; }
+    BatchKernel getKernel() const { return kernel; }
+
+    // Answer pairs on perfect mazes from a MazeTreeIndex (default on)
+    void setTreeIndex(bool enable) { useTree = enable; }
+    bool getTreeIndex() const { return useTree; }
+
+    /**
+     * Counters of the last call: searches run (one per LANES sources
+     * when bit-parallel), frontier cells expanded (a cell carrying several
+     * sources is expanded once for all that arrived together, so one BFS
+     * per source expands sources x reachable cells) and whether pairs went
+     * through the tree index
+     */
+    size_t batches() const { return batchCount; }
+    size_t expansions() const { return expansionCount; }
+    bool usedTreeIndex() const { return treeUsed; }
+
+    size_t memoryBytes() const;
+
+private:
+    struct Wave {
+        uint32_t cell;
+        uint64_t bits;                      // Lanes that reached the cell at this level
+    };
+
+    struct Lanes {
+        std::vector<uint64_t> seen;         // Sources that have reached each cell
+        std::vector<Wave> active;           // Frontier of the current level
+        std::vector<Wave> arriving;         // Frontier of the next level
+        std::vector<uint32_t> distance;     // Per-source BFS when not writing a field row
+        std::vector<uint32_t> queue;
+        std::vector<uint64_t> wanted;       // Lanes still waiting for each cell
+        std::vector<uint32_t> slots;        // End cells of the current pair batch
+        size_t expansions = 0;
+    };
+
+    template <typename Visit>
+    void search(const uint32_t* sources, size_t count, Lanes& lanes, uint32_t* row, Visit&& visit);
+    template <typename Visit>
+    size_t searchOne(uint32_t source, uint32_t* distance, Lanes& lanes, Visit&& visit);
+    template <typename Visit>
+    void searchLanes(const uint32_t* sources, size_t count, Lanes& lanes, Visit&& visit);
+    size_t batchWidth() const { return kernel == BatchKernel::BIT_PARALLEL ? LANES : 1; }
+    void prepare(const MazeGrid& grid, ThreadPool& pool);
+    Lanes& ready(int worker, bool distances, bool ends);
+    void finish();
+
+    size_t cells = 0;
+    int width = 0;
+    std::vector<uint8_t> exits;             // Open directions of each cell
+    std::vector<Lanes> workers;
+    std::vector<uint32_t> order;            // Pair queries sorted by start
+    std::vector<uint32_t> starts;           // Distinct starts, in order
+    std::vector<uint32_t> firstQuery;       // starts[k] owns order[firstQuery[k], firstQuery[k + 1])
+    std::vector<uint32_t> targetHead;       // Matrix targets: CSR from cell to target columns
+    std::vector<uint32_t> targetColumns;
+    MazeTreeIndex tree;
+    BatchKernel kernel = BatchKernel::PER_SOURCE;
+    bool useTree = true;
+    bool treeUsed = false;
+    size_t batchCount = 0;
+    size_t expansionCount = 0;
+};
+
+#endif // MAZE_MULTI_BFS_H
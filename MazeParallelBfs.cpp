@@ -0,0 +1,232 @@
+#include "MazeParallelBfs.h"
+#include "MazeInstrumentation.h"
+#include <algorithm>
+
+size_t MazeParallelBfs::memoryBytes() const {
+    size_t bytes = words * (sizeof(std::atomic<uint64_t>) + sizeof(uint64_t))
+                 + (distance.capacity() + frontier.capacity()) * sizeof(uint32_t);
+    for (const std::vector<uint32_t>& list : next) bytes += list.capacity() * sizeof(uint32_t);
+    return bytes;
+}
+
+/**
+ * Size the buffers for the grid and the pool; a new maze size drops them
+ */
+void MazeParallelBfs::prepare(const MazeGrid& grid, ThreadPool& pool) {
+    if (grid.cellCount() != cells) {
+        cells = grid.cellCount();
+        words = (cells + 63) / 64;
+        visited.reset(new std::atomic<uint64_t>[words]);
+        claimed.assign(words, 0);
+        distance.assign(cells, UNREACHED);
+        frontier = std::vector<uint32_t>();
+        next.clear();
+    }
+    if (next.size() < static_cast<size_t>(pool.size())) next.resize(pool.size());
+    for (size_t w = 0; w < words; w++) visited[w].store(0, std::memory_order_relaxed);
+}
+
+/**
+ * Expand frontier[begin, end): claim every unvisited open neighbour at
+ * distance level + 1. `shared` when other workers expand the same level,
+ * so claims must be atomic.
+ */
+void MazeParallelBfs::topDown(const MazeGrid& grid, size_t begin, size_t end, uint32_t level,
+                              std::vector<uint32_t>& out, bool shared) {
+    const int width = grid.getWidth();
+    for (size_t i = begin; i < end; i++) {
+        uint32_t cell = frontier[i];
+        unsigned open = grid.openDirections(static_cast<int>(cell % width), static_cast<int>(cell / width));
+        while (open) {
+            Direction dir = static_cast<Direction>(__builtin_ctz(open));
+            open &= open - 1;
+            uint32_t to = neighbourIndex(cell, dir, width);
+            std::atomic<uint64_t>& word = visited[to >> 6];
+            uint64_t bit = 1ULL << (to & 63);
+            uint64_t old = word.load(std::memory_order_relaxed);
+            if (old & bit) continue;
+            if (shared) {
+                if (word.fetch_or(bit, std::memory_order_relaxed) & bit) continue;
+            } else {
+                word.store(old | bit, std::memory_order_relaxed);
+            }
+            distance[to] = level + 1;
+            out.push_back(to);
+        }
+    }
+}
+
+/**
+ * Bitmap words [firstWord, lastWord): every unvisited cell with an open
+ * neighbour at distance `level` joins the next level. New cells go to
+ * `claimed` rather than the bitmap, which stays read-only for the level.
+ */
+void MazeParallelBfs::bottomUp(const MazeGrid& grid, size_t firstWord, size_t lastWord, uint32_t level,
+                               std::vector<uint32_t>& out) {
+    const int width = grid.getWidth();
+    for (size_t w = firstWord; w < lastWord; w++) {
+        uint64_t unvisited = ~visited[w].load(std::memory_order_relaxed);
+        if (w == words - 1 && (cells & 63)) unvisited &= (1ULL << (cells & 63)) - 1;
+        uint64_t found = 0;
+        while (unvisited) {
+            int b = __builtin_ctzll(unvisited);
+            unvisited &= unvisited - 1;
+            uint32_t cell = static_cast<uint32_t>(w * 64 + b);
+            unsigned open = grid.openDirections(static_cast<int>(cell % width), static_cast<int>(cell / width));
+            while (open) {
+                Direction dir = static_cast<Direction>(__builtin_ctz(open));
+                open &= open - 1;
+                uint32_t from = neighbourIndex(cell, dir, width);
+                if (isVisited(from) && distance[from] == level) {
+                    found |= 1ULL << b;
+                    distance[cell] = level + 1;
+                    out.push_back(cell);
+                    break;
+                }
+            }
+        }
+        claimed[w] = found;
+    }
+}
+
+/**
+ * Level-by-level BFS from `start` until the frontier empties or `end`
+ * (UNREACHED for none) is reached. Returns the number of cells reached.
+ */
+uint32_t MazeParallelBfs::search(const MazeGrid& grid, uint32_t start, uint32_t end, ThreadPool& pool) {
+    prepare(grid, pool);
+    levelCount = bottomUpCount = parallelCount = 0;
+    const int threads = pool.size();
+
+    visited[start >> 6].store(1ULL << (start & 63), std::memory_order_relaxed);
+    distance[start] = 0;
+    frontier.clear();
+    frontier.push_back(start);
+    size_t reached = 1;
+    bool bottomUpMode = false;
+
+    for (uint32_t level = 0; !frontier.empty() && !(end != UNREACHED && isVisited(end)); level++) {
+        const size_t size = frontier.size();
+        if (direction == BfsDirection::AUTO) {
+            if (!bottomUpMode && size * ALPHA > cells - reached && size * BETA >= cells) {
+                bottomUpMode = true;
+            } else if (bottomUpMode && size * BETA < cells) {
+                bottomUpMode = false;
+            }
+        } else {
+            bottomUpMode = direction == BfsDirection::BOTTOM_UP;
+        }
+        for (std::vector<uint32_t>& list : next) list.clear();
+
+        if (bottomUpMode) {
+            // Every level scans the whole bitmap, so split by words rather than frontier size
+            size_t tasks = threads > 1 && cells >= PARALLEL_MIN ? std::min(words, static_cast<size_t>(threads) * 4) : 1;
+            auto range = [&](size_t task, size_t& first, size_t& last) {
+                first = words * task / tasks;
+                last = words * (task + 1) / tasks;
+            };
+            auto merge = [&](size_t first, size_t last) {
+                for (size_t w = first; w < last; w++) {
+                    if (claimed[w]) visited[w].fetch_or(claimed[w], std::memory_order_relaxed);
+                }
+            };
+            if (tasks == 1) {
+                bottomUp(grid, 0, words, level, next[0]);
+                merge(0, words);
+            } else {
+                pool.parallelFor(tasks, [&](size_t task, int worker) {
+                    size_t first, last;
+                    range(task, first, last);
+                    bottomUp(grid, first, last, level, next[worker]);
+                });
+                pool.parallelFor(tasks, [&](size_t task, int) {
+                    size_t first, last;
+                    range(task, first, last);
+                    merge(first, last);
+                });
+                parallelCount++;
+            }
+            bottomUpCount++;
+        } else if (threads > 1 && size >= PARALLEL_MIN) {
+            size_t chunk = std::max(PARALLEL_MIN / 4, size / (static_cast<size_t>(threads) * 4));
+            size_t tasks = (size + chunk - 1) / chunk;
+            pool.parallelFor(tasks, [&](size_t task, int worker) {
+                topDown(grid, task * chunk, std::min(size, (task + 1) * chunk), level, next[worker], true);
+            });
+            parallelCount++;
+        } else {
+            topDown(grid, 0, size, level, next[0], false);
+        }
+
+        frontier.clear();
+        for (const std::vector<uint32_t>& list : next) frontier.insert(frontier.end(), list.begin(), list.end());
+        reached += frontier.size();
+        levelCount++;
+    }
+
+    CounterScope counters;
+    counters.expand(reached);
+    return static_cast<uint32_t>(reached);
+}
+
+size_t MazeParallelBfs::distanceField(const MazeGrid& grid, int x, int y, ThreadPool& pool) {
+    if (!grid.inBounds(x, y)) {
+        distance.assign(grid.cellCount(), UNREACHED);
+        return 0;
+    }
+    uint32_t start = static_cast<uint32_t>(y) * static_cast<uint32_t>(grid.getWidth()) + static_cast<uint32_t>(x);
+    size_t reached = search(grid, start, UNREACHED, pool);
+
+    // Only cells the search never reached hold stale distances
+    if (reached < cells) {
+        for (size_t w = 0; w < words; w++) {
+            uint64_t missing = ~visited[w].load(std::memory_order_relaxed);
+            if (w == words - 1 && (cells & 63)) missing &= (1ULL << (cells & 63)) - 1;
+            while (missing) {
+                distance[w * 64 + __builtin_ctzll(missing)] = UNREACHED;
+                missing &= missing - 1;
+            }
+        }
+    }
+    return reached;
+}
+
+long long MazeParallelBfs::shortestPathLength(const MazeGrid& grid, int startX, int startY, int endX, int endY,
+                                              ThreadPool& pool) {
+    if (!grid.inBounds(startX, startY) || !grid.inBounds(endX, endY)) return -1;
+    const uint32_t width = static_cast<uint32_t>(grid.getWidth());
+    uint32_t start = static_cast<uint32_t>(startY) * width + static_cast<uint32_t>(startX);
+    uint32_t end = static_cast<uint32_t>(endY) * width + static_cast<uint32_t>(endX);
+    search(grid, start, end, pool);
+    return isVisited(end) ? static_cast<long long>(distance[end]) : -1;
+}
+
+/**
+ * Search, then walk back from the end through neighbours one step closer
+ * to the start
+ */
+bool MazeParallelBfs::solve(const MazeGrid& grid, int startX, int startY, int endX, int endY, ThreadPool& pool,
+                            std::vector<uint32_t>& path) {
+    path.clear();
+    long long length = shortestPathLength(grid, startX, startY, endX, endY, pool);
+    if (length < 0) return false;
+
+    const int width = grid.getWidth();
+    uint32_t cell = static_cast<uint32_t>(endY) * static_cast<uint32_t>(width) + static_cast<uint32_t>(endX);
+    path.resize(static_cast<size_t>(length) + 1);
+    path[static_cast<size_t>(length)] = cell;
+    for (uint32_t d = static_cast<uint32_t>(length); d > 0; d--) {
+        unsigned open = grid.openDirections(static_cast<int>(cell % width), static_cast<int>(cell / width));
+        while (open) {
+            Direction dir = static_cast<Direction>(__builtin_ctz(open));
+            open &= open - 1;
+            uint32_t from = neighbourIndex(cell, dir, width);
+            if (isVisited(from) && distance[from] == d - 1) {
+                cell = from;
+                break;
+            }
+        }
+        path[d - 1] = cell;
+    }
+    return true;
+}
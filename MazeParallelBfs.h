@@ -0,0 +1,114 @@
+#ifndef MAZE_PARALLEL_BFS_H
+#define MAZE_PARALLEL_BFS_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "MazeGrid.h"
+#include "ThreadPool.h"
+
+/**
+ * How each BFS level is expanded
+ */
+enum class BfsDirection {
+    AUTO,       // Direction-optimizing: switch between the two below per level
+    TOP_DOWN,   // Frontier cells claim their unvisited neighbours
+    BOTTOM_UP   // Unvisited cells look for a neighbour on the frontier
+};
+
+/**
+ * Multi-threaded level-synchronous breadth-first search
+ *
+ * Each level is split into chunks run on a ThreadPool. Top-down levels
+ * claim cells with an atomic fetch_or on a visited bitmap (one bit per
+ * cell, index y * width + x) and append them to the worker's own next
+ * frontier; the per-worker lists are joined between levels. Bottom-up
+ * levels give each task a range of bitmap words: every unvisited cell in
+ * it checks its open neighbours for one at the current distance, so no
+ * atomics are needed. AUTO follows Beamer's rule with node counts (maze
+ * cells all have degree 1-4): go bottom-up once the frontier is larger
+ * than unvisited / ALPHA and at least cells / BETA, back when it falls
+ * below cells / BETA. Levels narrower than PARALLEL_MIN cells run on the
+ * calling thread, since most maze levels are a handful of cells and a
+ * pool round trip per level would dominate.
+ *
+ * Distances are written only for reached cells, so a query clears the
+ * bitmap (one bit per cell) but not the distance array. All scratch is
+ * owned by the context and kept between queries. Lengths match
+ * MazeSolver's BFS for any thread count.
+ */
+class MazeParallelBfs {
+public:
+    static constexpr uint32_t UNREACHED = 0xFFFFFFFFu;
+    static constexpr size_t PARALLEL_MIN = 4096;
+    static constexpr int ALPHA = 14;
+    static constexpr int BETA = 24;
+
+    /**
+     * Distance from (x, y) to every cell. Returns the number of cells
+     * reached, the start included, or 0 if the start is out of range.
+     * distances() then holds one entry per cell, UNREACHED where there is
+     * no path.
+     */
+    size_t distanceField(const MazeGrid& grid, int x, int y, ThreadPool& pool);
+
+    /**
+     * Length in steps of the shortest path, or -1 if there is none. Stops
+     * after the level that reaches the end.
+     */
+    long long shortestPathLength(const MazeGrid& grid, int startX, int startY, int endX, int endY,
+                                 ThreadPool& pool);
+
+    /**
+     * Like shortestPathLength(), returning the cells of a shortest path,
+     * start first (emptied when there is none)
+     */
+    bool solve(const MazeGrid& grid, int startX, int startY, int endX, int endY, ThreadPool& pool,
+               std::vector<uint32_t>& path);
+
+    /**
+     * Field of the last distanceField(); entries of other queries are only
+     * meaningful for cells they reached
+     */
+    const std::vector<uint32_t>& distances() const { return distance; }
+
+    void setDirection(BfsDirection policy) { direction = policy; }
+    BfsDirection getDirection() const { return direction; }
+
+    /**
+     * Levels expanded by the last query, and how many of them went
+     * bottom-up or were split across the pool
+     */
+    size_t levels() const { return levelCount; }
+    size_t bottomUpLevels() const { return bottomUpCount; }
+    size_t parallelLevels() const { return parallelCount; }
+
+    size_t memoryBytes() const;
+
+private:
+    void prepare(const MazeGrid& grid, ThreadPool& pool);
+    uint32_t search(const MazeGrid& grid, uint32_t start, uint32_t end, ThreadPool& pool);
+    void topDown(const MazeGrid& grid, size_t begin, size_t end, uint32_t level, std::vector<uint32_t>& out,
+                 bool shared);
+    void bottomUp(const MazeGrid& grid, size_t firstWord, size_t lastWord, uint32_t level,
+                  std::vector<uint32_t>& out);
+    bool isVisited(uint32_t cell) const {
+        return (visited[cell >> 6].load(std::memory_order_relaxed) >> (cell & 63)) & 1ULL;
+    }
+
+    BfsDirection direction = BfsDirection::AUTO;
+    size_t cells = 0;
+    size_t words = 0;
+    std::unique_ptr<std::atomic<uint64_t>[]> visited;
+    std::vector<uint64_t> claimed;                 // Bottom-up: cells reached this level, merged afterwards
+    std::vector<uint32_t> distance;
+    std::vector<uint32_t> frontier;
+    std::vector<std::vector<uint32_t>> next;       // Per-worker next frontier
+    size_t levelCount = 0;
+    size_t bottomUpCount = 0;
+    size_t parallelCount = 0;
+};
+
+#endif // MAZE_PARALLEL_BFS_H
@@ -0,0 +1,98 @@
+#include "MazePool.h"
+
+MazePool::MazePool(size_t maxIdle) : maxIdle(maxIdle) {
+    idleMazes.reserve(maxIdle);  // Returning a maze never allocates
+}
+
+MazePool::Lease::Lease(Lease&& other) noexcept : pool(other.pool), maze(std::move(other.maze)) {
+    other.pool = nullptr;
+}
+
+MazePool::Lease& MazePool::Lease::operator=(Lease&& other) noexcept {
+    if (this != &other) {
+        release();
+        pool = other.pool;
+        maze = std::move(other.maze);
+        other.pool = nullptr;
+    }
+    return *this;
+}
+
+void MazePool::Lease::release() {
+    if (maze && pool) pool->giveBack(std::move(maze));
+    maze.reset();
+    pool = nullptr;
+}
+
+/**
+ * Take an idle maze of the same size if there is one, else the most
+ * recently returned one, else construct; then reset it outside the lock
+ */
+MazePool::Lease MazePool::lease(int w, int h, unsigned int seed, RandomEngine engine) {
+    std::unique_ptr<Maze> maze;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!idleMazes.empty()) {
+            size_t pick = idleMazes.size() - 1;
+            for (size_t i = idleMazes.size(); i-- > 0;) {
+                if (idleMazes[i]->getWidth() == w && idleMazes[i]->getHeight() == h) {
+                    pick = i;
+                    break;
+                }
+            }
+            maze = std::move(idleMazes[pick]);
+            idleMazes[pick] = std::move(idleMazes.back());
+            idleMazes.pop_back();
+            reusedCount++;
+        } else {
+            createdCount++;
+        }
+    }
+
+    // The last lessee may have changed the engine or the layout; the
+    // engine goes first so that reset() seeds the requested one
+    const bool fresh = !maze;
+    if (fresh) maze.reset(new Maze(w, h, seed));
+    maze->setCellLayout(CellLayout::ROW_MAJOR);
+    if (maze->getRandomEngine() != engine) maze->setRandomEngine(engine);
+    if (!fresh || engine != RandomEngine::MT19937) maze->reset(w, h, seed);
+    return Lease(this, std::move(maze));
+}
+
+/**
+ * Keep the maze if there is room; otherwise it is freed after the lock
+ * is dropped
+ */
+void MazePool::giveBack(std::unique_ptr<Maze> maze) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (idleMazes.size() < maxIdle) idleMazes.push_back(std::move(maze));
+}
+
+void MazePool::reserve(size_t count, int w, int h) {
+    if (count > maxIdle) count = maxIdle;
+    std::lock_guard<std::mutex> lock(mutex);
+    while (idleMazes.size() < count) {
+        idleMazes.emplace_back(new Maze(w, h, 0));
+        createdCount++;
+    }
+}
+
+void MazePool::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    idleMazes.clear();
+}
+
+size_t MazePool::idle() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return idleMazes.size();
+}
+
+size_t MazePool::created() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return createdCount;
+}
+
+size_t MazePool::reused() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return reusedCount;
+}
@@ -0,0 +1,93 @@
+#ifndef MAZE_POOL_H
+#define MAZE_POOL_H
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "Maze.h"
+
+/**
+ * Pool of reusable Maze objects
+ *
+ * lease() hands out an idle maze reset to the requested size, seed and
+ * random engine (Maze::reset: walls up with a fill of the bit planes,
+ * resized in place, reseeded; the cell layout back to row-major),
+ * preferring one that already has that size so nothing is reallocated.
+ * The maze goes back to the pool when its Lease is released or destroyed,
+ * with its wall planes and generator, solver and analytics scratch
+ * intact. At most maxIdle mazes are kept; extras are freed.
+ *
+ * lease() and release are thread-safe. The pool must outlive its leases.
+ */
+class MazePool {
+public:
+    /**
+     * Exclusive use of one pooled maze; move-only
+     */
+    class Lease {
+    public:
+        Lease() = default;
+        Lease(Lease&& other) noexcept;
+        Lease& operator=(Lease&& other) noexcept;
+        ~Lease() { release(); }
+
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+
+        Maze& operator*() const { return *maze; }
+        Maze* operator->() const { return maze.get(); }
+        Maze* get() const { return maze.get(); }
+        explicit operator bool() const { return maze != nullptr; }
+
+        /**
+         * Return the maze to the pool now; the lease becomes empty
+         */
+        void release();
+
+    private:
+        friend class MazePool;
+        Lease(MazePool* owner, std::unique_ptr<Maze> leased) : pool(owner), maze(std::move(leased)) {}
+
+        MazePool* pool = nullptr;
+        std::unique_ptr<Maze> maze;
+    };
+
+    explicit MazePool(size_t maxIdle = 64);
+
+    MazePool(const MazePool&) = delete;
+    MazePool& operator=(const MazePool&) = delete;
+
+    /**
+     * A maze of w x h, every wall up, its random stream seeded with `seed`
+     * on `engine`, and the row-major cell layout: the same maze per seed
+     * as a new Maze, whatever earlier lessees changed. Only scratch
+     * capacity carries over.
+     */
+    Lease lease(int w, int h, unsigned int seed, RandomEngine engine = RandomEngine::MT19937);
+
+    /**
+     * Create idle mazes of w x h until `count` are idle (capped at maxIdle)
+     */
+    void reserve(size_t count, int w, int h);
+
+    /**
+     * Free every idle maze
+     */
+    void clear();
+
+    size_t idle() const;
+    size_t created() const;   // Mazes constructed by lease() or reserve()
+    size_t reused() const;    // Leases served from an idle maze
+
+private:
+    void giveBack(std::unique_ptr<Maze> maze);
+
+    mutable std::mutex mutex;
+    std::vector<std::unique_ptr<Maze>> idleMazes;
+    size_t maxIdle;
+    size_t createdCount = 0;
+    size_t reusedCount = 0;
+};
+
+#endif // MAZE_POOL_H
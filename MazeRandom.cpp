@@ -0,0 +1,276 @@
+#include "MazeRandom.h"
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define MAZE_RANDOM_X86 1
+#endif
+
+namespace {
+const uint64_t GOLDEN_GAMMA = 0x9E3779B97F4A7C15ULL;
+const uint64_t PCG_MULTIPLIER = 6364136223846793005ULL;
+
+inline uint64_t rotl(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+/**
+ * `steps` rounds of four interleaved xoshiro256++ streams; each round
+ * writes 4 outputs as 8 words (low half first)
+ */
+void xoshiroScalar(uint64_t s[4][4], uint32_t* out, size_t steps) {
+    for (size_t step = 0; step < steps; step++) {
+        for (int lane = 0; lane < 4; lane++) {
+            uint64_t result = rotl(s[0][lane] + s[3][lane], 23) + s[0][lane];
+            uint64_t t = s[1][lane] << 17;
+            s[2][lane] ^= s[0][lane];
+            s[3][lane] ^= s[1][lane];
+            s[1][lane] ^= s[2][lane];
+            s[0][lane] ^= s[3][lane];
+            s[2][lane] ^= t;
+            s[3][lane] = rotl(s[3][lane], 45);
+            out[8 * step + 2 * lane] = static_cast<uint32_t>(result);
+            out[8 * step + 2 * lane + 1] = static_cast<uint32_t>(result >> 32);
+        }
+    }
+}
+
+/**
+ * SplitMix outputs index .. index + count/2 - 1 as 32-bit halves
+ */
+void splitMixScalar(uint64_t seed, uint64_t index, uint32_t* out, size_t count) {
+    for (size_t i = 0; i < count / 2; i++) {
+        uint64_t value = splitMixAt(seed, index + i);
+        out[2 * i] = static_cast<uint32_t>(value);
+        out[2 * i + 1] = static_cast<uint32_t>(value >> 32);
+    }
+}
+
+#ifdef MAZE_RANDOM_X86
+__attribute__((target("avx2"))) inline __m256i rotl256(__m256i x, int k) {
+    return _mm256_or_si256(_mm256_slli_epi64(x, k), _mm256_srli_epi64(x, 64 - k));
+}
+
+/**
+ * Low 64 bits of a 64x64 product per lane (AVX2 only multiplies 32x32)
+ */
+__attribute__((target("avx2"))) inline __m256i mul64(__m256i a, __m256i b) {
+    __m256i low = _mm256_mul_epu32(a, b);
+    __m256i cross = _mm256_add_epi64(_mm256_mul_epu32(_mm256_srli_epi64(a, 32), b),
+                                     _mm256_mul_epu32(a, _mm256_srli_epi64(b, 32)));
+    return _mm256_add_epi64(low, _mm256_slli_epi64(cross, 32));
+}
+
+__attribute__((target("avx2"))) void xoshiroAvx2(uint64_t s[4][4], uint32_t* out, size_t steps) {
+    __m256i s0 = _mm256_load_si256(reinterpret_cast<const __m256i*>(s[0]));
+    __m256i s1 = _mm256_load_si256(reinterpret_cast<const __m256i*>(s[1]));
+    __m256i s2 = _mm256_load_si256(reinterpret_cast<const __m256i*>(s[2]));
+    __m256i s3 = _mm256_load_si256(reinterpret_cast<const __m256i*>(s[3]));
+    for (size_t step = 0; step < steps; step++) {
+        __m256i result = _mm256_add_epi64(rotl256(_mm256_add_epi64(s0, s3), 23), s0);
+        __m256i t = _mm256_slli_epi64(s1, 17);
+        s2 = _mm256_xor_si256(s2, s0);
+        s3 = _mm256_xor_si256(s3, s1);
+        s1 = _mm256_xor_si256(s1, s2);
+        s0 = _mm256_xor_si256(s0, s3);
+        s2 = _mm256_xor_si256(s2, t);
+        s3 = rotl256(s3, 45);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 8 * step), result);
+    }
+    _mm256_store_si256(reinterpret_cast<__m256i*>(s[0]), s0);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(s[1]), s1);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(s[2]), s2);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(s[3]), s3);
+}
+
+__attribute__((target("avx2"))) void splitMixAvx2(uint64_t seed, uint64_t index, uint32_t* out, size_t count) {
+    const __m256i m1 = _mm256_set1_epi64x(static_cast<long long>(0xBF58476D1CE4E5B9ULL));
+    const __m256i m2 = _mm256_set1_epi64x(static_cast<long long>(0x94D049BB133111EBULL));
+    const __m256i stride = _mm256_set1_epi64x(static_cast<long long>(4 * GOLDEN_GAMMA));
+    uint64_t base = seed + (index + 1) * GOLDEN_GAMMA;
+    __m256i z0 = _mm256_setr_epi64x(static_cast<long long>(base), static_cast<long long>(base + GOLDEN_GAMMA),
+                                    static_cast<long long>(base + 2 * GOLDEN_GAMMA),
+                                    static_cast<long long>(base + 3 * GOLDEN_GAMMA));
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i z = z0;
+        z = mul64(_mm256_xor_si256(z, _mm256_srli_epi64(z, 30)), m1);
+        z = mul64(_mm256_xor_si256(z, _mm256_srli_epi64(z, 27)), m2);
+        z = _mm256_xor_si256(z, _mm256_srli_epi64(z, 31));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), z);
+        z0 = _mm256_add_epi64(z0, stride);
+    }
+    splitMixScalar(seed, index + i / 2, out + i, count - i);
+}
+
+bool cpuHasAvx2() {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+}
+
+const bool AVX2_SUPPORTED = cpuHasAvx2();
+bool avx2Enabled = AVX2_SUPPORTED;
+#else
+bool avx2Enabled = false;
+#endif
+
+void xoshiroFill(uint64_t s[4][4], uint32_t* out, size_t steps) {
+#ifdef MAZE_RANDOM_X86
+    if (avx2Enabled) return xoshiroAvx2(s, out, steps);
+#endif
+    xoshiroScalar(s, out, steps);
+}
+
+void splitMixFill(uint64_t seed, uint64_t index, uint32_t* out, size_t count) {
+#ifdef MAZE_RANDOM_X86
+    if (avx2Enabled) return splitMixAvx2(seed, index, out, count);
+#endif
+    splitMixScalar(seed, index, out, count);
+}
+}
+
+const char* randomEngineName(RandomEngine engine) {
+    switch (engine) {
+        case RandomEngine::MT19937: return "mt19937";
+        case RandomEngine::XOSHIRO: return "xoshiro256++ x4";
+        case RandomEngine::PCG32: return "PCG32";
+        case RandomEngine::SPLITMIX: return "SplitMix64 (counter)";
+    }
+    return "Unknown";
+}
+
+const char* randomEngineKey(RandomEngine engine) {
+    static const char* const KEYS[RANDOM_ENGINE_COUNT] = {"mt19937", "xoshiro", "pcg32", "splitmix"};
+    int index = static_cast<int>(engine);
+    return index >= 0 && index < RANDOM_ENGINE_COUNT ? KEYS[index] : "unknown";
+}
+
+bool parseRandomEngine(const std::string& name, RandomEngine& engine) {
+    for (int i = 0; i < RANDOM_ENGINE_COUNT; i++) {
+        if (name == randomEngineKey(static_cast<RandomEngine>(i))) {
+            engine = static_cast<RandomEngine>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool MazeRandom::vectorized() {
+    return avx2Enabled;
+}
+
+void MazeRandom::setVectorized(bool enable) {
+#ifdef MAZE_RANDOM_X86
+    avx2Enabled = enable && AVX2_SUPPORTED;
+#else
+    (void)enable;
+#endif
+}
+
+MazeRandom::MazeRandom(uint64_t seed, RandomEngine engine) : engine(engine) {
+    this->seed(seed);
+}
+
+void MazeRandom::setEngine(RandomEngine newEngine, uint64_t newSeed) {
+    engine = newEngine;
+    seed(newSeed);
+}
+
+/**
+ * Seed the current engine; the other engines' state is left alone
+ */
+void MazeRandom::seed(uint64_t value) {
+    next = BATCH;
+    switch (engine) {
+        case RandomEngine::MT19937:
+            // Applied by the first refill: seeding mt19937 fills 624 words,
+            // and a maze is often reseeded again before it draws anything
+            mtSeed = static_cast<uint32_t>(value);
+            mtPending = true;
+            break;
+        case RandomEngine::XOSHIRO:
+            // 16 state words from SplitMix, as the xoshiro authors recommend
+            for (int word = 0; word < 4; word++) {
+                for (int lane = 0; lane < 4; lane++) {
+                    xoshiro[word][lane] = splitMixAt(value, static_cast<uint64_t>(4 * lane + word));
+                }
+            }
+            break;
+        case RandomEngine::PCG32:
+            // pcg32_srandom(initstate, initseq) with the reference stream constant
+            pcgIncrement = (0xDA3E39CB94B95BDBULL << 1) | 1u;
+            pcgState = pcgIncrement;
+            pcgState += splitMixAt(value, 0);
+            pcgState = pcgState * PCG_MULTIPLIER + pcgIncrement;
+            break;
+        case RandomEngine::SPLITMIX:
+            splitSeed = value;
+            splitIndex = 0;
+            break;
+    }
+}
+
+/**
+ * Produce the next BATCH values
+ */
+void MazeRandom::refill() {
+    switch (engine) {
+        case RandomEngine::MT19937:
+            if (mtPending) {
+                mt.seed(mtSeed);
+                mtPending = false;
+            }
+            for (size_t i = 0; i < BATCH; i++) buffer[i] = static_cast<uint32_t>(mt());
+            break;
+        case RandomEngine::XOSHIRO:
+            xoshiroFill(xoshiro, buffer, BATCH / 8);
+            break;
+        case RandomEngine::PCG32:
+            for (size_t i = 0; i < BATCH; i++) {
+                uint64_t old = pcgState;
+                pcgState = old * PCG_MULTIPLIER + pcgIncrement;
+                uint32_t xorShifted = static_cast<uint32_t>(((old >> 18) ^ old) >> 27);
+                uint32_t rot = static_cast<uint32_t>(old >> 59);
+                buffer[i] = (xorShifted >> rot) | (xorShifted << ((32 - rot) & 31));
+            }
+            break;
+        case RandomEngine::SPLITMIX:
+            splitMixFill(splitSeed, splitIndex, buffer, BATCH);
+            splitIndex += BATCH / 2;
+            break;
+    }
+    next = 0;
+}
+
+/**
+ * Bulk draws: whatever is left in the buffer, then whole batches straight
+ * into `out`
+ */
+void MazeRandom::fill(uint32_t* out, size_t count) {
+    while (count > 0 && next < BATCH) {
+        *out++ = buffer[next++];
+        count--;
+    }
+    size_t whole = count / BATCH * BATCH;
+    if (whole > 0) {
+        switch (engine) {
+            case RandomEngine::XOSHIRO:
+                xoshiroFill(xoshiro, out, whole / 8);
+                break;
+            case RandomEngine::SPLITMIX:
+                splitMixFill(splitSeed, splitIndex, out, whole);
+                splitIndex += whole / 2;
+                break;
+            default:
+                for (size_t i = 0; i < whole; i += BATCH) {
+                    refill();
+                    std::copy(buffer, buffer + BATCH, out + i);
+                    next = BATCH;
+                }
+                break;
+        }
+        out += whole;
+        count -= whole;
+    }
+    for (size_t i = 0; i < count; i++) out[i] = (*this)();
+}
@@ -0,0 +1,123 @@
+#ifndef MAZE_RANDOM_H
+#define MAZE_RANDOM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+
+/**
+ * Random number engines selectable for generation
+ */
+enum class RandomEngine {
+    MT19937,     // std::mt19937, the reference engine (default)
+    XOSHIRO,     // xoshiro256++, four interleaved streams
+    PCG32,       // PCG-XSH-RR 64/32, one stream
+    SPLITMIX     // Counter-based SplitMix64: value i depends only on (seed, i)
+};
+
+const int RANDOM_ENGINE_COUNT = 4;
+
+/**
+ * Human-readable engine name
+ */
+const char* randomEngineName(RandomEngine engine);
+
+/**
+ * Command-line engine name ("mt19937", "xoshiro", "pcg32", "splitmix"),
+ * as accepted by parseRandomEngine()
+ */
+const char* randomEngineKey(RandomEngine engine);
+bool parseRandomEngine(const std::string& name, RandomEngine& engine);
+
+/**
+ * SplitMix64 output number `index` of the stream for `seed`. Stateless,
+ * so any cell, tile or thread can draw its own value in any order.
+ * constexpr, so compile-time generation can use the same stream.
+ */
+constexpr uint64_t splitMixAt(uint64_t seed, uint64_t index) {
+    uint64_t z = seed + (index + 1) * 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/**
+ * Buffered 32-bit random source used by all generators
+ *
+ * Draws come out of a block of BATCH values that the selected engine
+ * refills in one call, so the per-draw cost is a load and a compare
+ * whatever the engine. xoshiro256++ and SplitMix refill with AVX2 when
+ * the CPU has it (checked once at run time) and with scalar code that
+ * gives the same values otherwise.
+ *
+ * With MT19937 the values are exactly those of std::mt19937 seeded with
+ * the low 32 bits of the seed, so mazes match earlier releases. Satisfies
+ * UniformRandomBitGenerator, so it also works with std::shuffle.
+ */
+class MazeRandom {
+public:
+    using result_type = uint32_t;
+    static const size_t BATCH = 256;
+
+    explicit MazeRandom(uint64_t seed = std::mt19937::default_seed, RandomEngine engine = RandomEngine::MT19937);
+
+    /**
+     * Restart the current engine's stream for `seed`
+     */
+    void seed(uint64_t seed);
+
+    /**
+     * Switch engines; the stream restarts from `seed`
+     */
+    void setEngine(RandomEngine engine, uint64_t seed);
+    RandomEngine getEngine() const { return engine; }
+
+    result_type operator()() {
+        if (next == BATCH) refill();
+        return buffer[next++];
+    }
+
+    /**
+     * The next `count` values of the stream, in bulk
+     */
+    void fill(uint32_t* out, size_t count);
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return 0xFFFFFFFFu; }
+
+    /**
+     * True when refills use AVX2 kernels. setVectorized(false) forces the
+     * scalar kernels (for comparison); it cannot enable AVX2 on a CPU
+     * without it.
+     */
+    static bool vectorized();
+    static void setVectorized(bool enable);
+
+private:
+    void refill();
+
+    alignas(32) uint32_t buffer[BATCH];
+    size_t next = BATCH;
+    RandomEngine engine;
+
+    std::mt19937 mt;
+    uint32_t mtSeed = 0;
+    bool mtPending = false;              // mt not yet seeded with mtSeed
+    alignas(32) uint64_t xoshiro[4][4];  // [state word][stream], for 4-wide SIMD
+    uint64_t pcgState = 0;
+    uint64_t pcgIncrement = 0;
+    uint64_t splitSeed = 0;
+    uint64_t splitIndex = 0;             // Next SplitMix output to produce
+};
+
+/**
+ * Pick a value in [0, count) from one 32-bit draw (multiply-shift, no
+ * distribution object and no rejection loop)
+ */
+inline uint32_t boundedDraw(MazeRandom& rng, uint32_t count) {
+    uint64_t r = rng();
+    return static_cast<uint32_t>((r * count) >> 32);
+}
+
+#endif // MAZE_RANDOM_H
@@ -0,0 +1,414 @@
+#include "MazeSolver.h"
+#include "MazeInstrumentation.h"
+#include <algorithm>
+#include <cstdlib>
+
+namespace {
+inline Direction opposite(Direction dir) {
+    return static_cast<Direction>((dir + 2) & 3);
+}
+
+#ifdef MAZE_LAYOUT_X86
+/**
+ * Morton with BMI2: everything reached from here is inlined and compiled
+ * for BMI2, so pdep/pext sit in the kernels' inner loops
+ */
+template <class Fn>
+__attribute__((target("bmi2"), flatten)) void runMortonBmi2(int width, int height, Fn& fn) {
+    fn(MortonIndex<MortonBmi2>(width, height));
+}
+#endif
+
+/**
+ * Call fn with the indexer of the given layout
+ */
+template <class Fn>
+void withIndex(CellLayout layout, const MazeGrid& grid, Fn& fn) {
+    const int width = grid.getWidth();
+    const int height = grid.getHeight();
+    switch (layout) {
+        case CellLayout::MORTON:
+#ifdef MAZE_LAYOUT_X86
+            if (layoutUsesBmi2()) {
+                runMortonBmi2(width, height, fn);
+                break;
+            }
+#endif
+            fn(MortonIndex<MortonScalar>(width, height));
+            break;
+        case CellLayout::HILBERT:
+            fn(HilbertIndex(width, height));
+            break;
+        case CellLayout::ROW_MAJOR:
+            fn(RowMajorIndex(width, height));
+            break;
+    }
+}
+}
+
+const char* solverModeName(SolverMode mode) {
+    switch (mode) {
+        case SolverMode::BFS: return "BFS";
+        case SolverMode::BIDIRECTIONAL: return "Bidirectional BFS";
+        case SolverMode::ASTAR: return "A*";
+        case SolverMode::DEAD_END_FILL: return "Dead-end filling";
+    }
+    return "Unknown";
+}
+
+uint32_t manhattanDistance(int x, int y, int endX, int endY) {
+    return static_cast<uint32_t>(std::abs(x - endX) + std::abs(y - endY));
+}
+
+size_t MazeSolver::memoryBytes() const {
+    size_t bytes = heap.capacity() * sizeof(HeapEntry) + degree.capacity();
+    for (const Side* side : {&forward, &backward}) {
+        bytes += (side->stamp.capacity() + side->distance.capacity() + side->queue.capacity()) * sizeof(uint32_t)
+               + side->parent.capacity();
+    }
+    return bytes;
+}
+
+/**
+ * Start a new epoch; a new maze size drops all buffers
+ */
+void MazeSolver::newQuery(size_t cells) {
+    if (cells != cellCount) {
+        forward = Side();
+        backward = Side();
+        heap.clear();
+        degree.clear();
+        cellCount = cells;
+        epoch = 0;
+    }
+    if (++epoch == 0) {
+        // Stamps wrapped around: one real clear every 2^32 queries
+        std::fill(forward.stamp.begin(), forward.stamp.end(), 0);
+        std::fill(backward.stamp.begin(), backward.stamp.end(), 0);
+        epoch = 1;
+    }
+    expanded = 0;
+    usedBackward = false;
+}
+
+void MazeSolver::ensure(Side& side, size_t cells) {
+    if (side.stamp.size() != cells) {
+        side.stamp.assign(cells, 0);
+        side.distance.resize(cells);
+        side.parent.resize(cells);
+        side.queue.resize(cells);
+    }
+}
+
+template <class Index>
+bool MazeSolver::search(const MazeGrid& grid, const Index& index, uint32_t start, uint32_t end, SolverMode mode) {
+    newQuery(index.size());
+    bool found = false;
+    switch (mode) {
+        case SolverMode::BIDIRECTIONAL: found = searchBidirectional(grid, index, start, end); break;
+        case SolverMode::ASTAR: found = searchAStar(grid, index, start, end); break;
+        case SolverMode::DEAD_END_FILL: found = searchDeadEndFill(grid, index, start, end); break;
+        case SolverMode::BFS: found = searchBfs(grid, index, start, end); break;
+    }
+    CounterScope counters;
+    counters.expand(expanded);
+    return found;
+}
+
+/**
+ * Plain BFS. With skipFilled, cells stamped in `backward` count as walls.
+ */
+template <class Index>
+bool MazeSolver::searchBfs(const MazeGrid& grid, const Index& index, uint32_t start, uint32_t end, bool skipFilled) {
+    ensure(forward, cellCount);
+    const uint32_t* filled = skipFilled ? backward.stamp.data() : nullptr;
+
+    size_t head = 0, tail = 0;
+    forward.queue[tail++] = start;
+    forward.stamp[start] = epoch;
+    forward.distance[start] = 0;
+
+    while (head < tail) {
+        uint32_t cell = forward.queue[head++];
+        expanded++;
+        if (cell == end) {
+            meetFrom = meetTo = end;
+            return true;
+        }
+
+        int x, y;
+        index.coords(cell, x, y);
+        unsigned open = grid.openDirections(x, y);
+        while (open) {
+            Direction dir = static_cast<Direction>(__builtin_ctz(open));
+            open &= open - 1;
+            uint32_t next = index.neighbour(cell, x, y, dir);
+            if (forward.stamp[next] != epoch && !(filled && filled[next] == epoch)) {
+                forward.stamp[next] = epoch;
+                forward.distance[next] = forward.distance[cell] + 1;
+                forward.parent[next] = static_cast<uint8_t>(dir);
+                forward.queue[tail++] = next;
+            }
+        }
+    }
+    return false;
+}
+
+/**
+ * Level-synchronous BFS from both ends, always growing the smaller
+ * frontier by one whole level. The first level that touches the other
+ * side is finished before stopping, so the best meeting edge is found.
+ */
+template <class Index>
+bool MazeSolver::searchBidirectional(const MazeGrid& grid, const Index& index, uint32_t start, uint32_t end) {
+    ensure(forward, cellCount);
+    ensure(backward, cellCount);
+
+    forward.queue[0] = start;
+    forward.stamp[start] = epoch;
+    forward.distance[start] = 0;
+    backward.queue[0] = end;
+    backward.stamp[end] = epoch;
+    backward.distance[end] = 0;
+    if (start == end) {
+        meetFrom = meetTo = start;
+        return true;
+    }
+
+    size_t head[2] = {0, 0};
+    size_t tail[2] = {1, 1};
+    Side* sides[2] = {&forward, &backward};
+    uint64_t best = UINT64_MAX;
+
+    while (head[0] < tail[0] && head[1] < tail[1]) {
+        int s = (tail[0] - head[0] <= tail[1] - head[1]) ? 0 : 1;
+        Side& own = *sides[s];
+        const Side& other = *sides[1 - s];
+        size_t levelEnd = tail[s];
+
+        while (head[s] < levelEnd) {
+            uint32_t cell = own.queue[head[s]++];
+            expanded++;
+            int x, y;
+            index.coords(cell, x, y);
+            unsigned open = grid.openDirections(x, y);
+            while (open) {
+                Direction dir = static_cast<Direction>(__builtin_ctz(open));
+                open &= open - 1;
+                uint32_t next = index.neighbour(cell, x, y, dir);
+                if (other.stamp[next] == epoch) {
+                    uint64_t length = static_cast<uint64_t>(own.distance[cell]) + 1 + other.distance[next];
+                    if (length < best) {
+                        best = length;
+                        // Stored as forward cell -> backward cell
+                        meetFrom = s == 0 ? cell : next;
+                        meetTo = s == 0 ? next : cell;
+                    }
+                }
+                if (own.stamp[next] != epoch) {
+                    own.stamp[next] = epoch;
+                    own.distance[next] = own.distance[cell] + 1;
+                    own.parent[next] = static_cast<uint8_t>(dir);
+                    own.queue[tail[s]++] = next;
+                }
+            }
+        }
+
+        if (best != UINT64_MAX) {
+            usedBackward = true;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * A* over a flat binary heap with lazy deletion; among equal f the
+ * deeper entry goes first, which keeps the search on the corridor
+ */
+template <class Index>
+bool MazeSolver::searchAStar(const MazeGrid& grid, const Index& index, uint32_t start, uint32_t end) {
+    int startX, startY, endX, endY;
+    index.coords(start, startX, startY);
+    index.coords(end, endX, endY);
+    ensure(forward, cellCount);
+    if (heap.capacity() < cellCount) heap.reserve(cellCount);
+    heap.clear();
+
+    auto lowerPriority = [](const HeapEntry& a, const HeapEntry& b) {
+        return a.f > b.f || (a.f == b.f && a.g < b.g);
+    };
+
+    forward.stamp[start] = epoch;
+    forward.distance[start] = 0;
+    heap.push_back({heuristic(startX, startY, endX, endY), 0, start});
+
+    while (!heap.empty()) {
+        std::pop_heap(heap.begin(), heap.end(), lowerPriority);
+        HeapEntry top = heap.back();
+        heap.pop_back();
+        if (top.g != forward.distance[top.cell]) continue;  // Superseded entry
+
+        expanded++;
+        if (top.cell == end) {
+            meetFrom = meetTo = end;
+            return true;
+        }
+
+        int x, y;
+        index.coords(top.cell, x, y);
+        unsigned open = grid.openDirections(x, y);
+        while (open) {
+            Direction dir = static_cast<Direction>(__builtin_ctz(open));
+            open &= open - 1;
+            uint32_t next = index.neighbour(top.cell, x, y, dir);
+            uint32_t g = top.g + 1;
+            if (forward.stamp[next] != epoch || g < forward.distance[next]) {
+                forward.stamp[next] = epoch;
+                forward.distance[next] = g;
+                forward.parent[next] = static_cast<uint8_t>(dir);
+                heap.push_back({g + heuristic(x + DX[dir], y + DY[dir], endX, endY), g, next});
+                std::push_heap(heap.begin(), heap.end(), lowerPriority);
+            }
+        }
+    }
+    return false;
+}
+
+/**
+ * Repeatedly wall off cells with at most one opening (other than the
+ * endpoints). In a perfect maze only the solution path survives; the BFS
+ * that follows walks just the surviving cells. `backward.stamp` marks
+ * filled cells and `backward.queue` is the worklist.
+ */
+template <class Index>
+bool MazeSolver::searchDeadEndFill(const MazeGrid& grid, const Index& index, uint32_t start, uint32_t end) {
+    const int width = grid.getWidth();
+    const int height = grid.getHeight();
+    ensure(backward, cellCount);
+    degree.resize(cellCount);
+
+    size_t head = 0, tail = 0;
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            uint32_t cell = index.index(x, y);
+            uint8_t open = static_cast<uint8_t>(__builtin_popcount(grid.openDirections(x, y)));
+            degree[cell] = open;
+            if (open <= 1 && cell != start && cell != end) {
+                backward.stamp[cell] = epoch;
+                backward.queue[tail++] = cell;
+            }
+        }
+    }
+
+    while (head < tail) {
+        uint32_t dead = backward.queue[head++];
+        expanded++;
+        int x, y;
+        index.coords(dead, x, y);
+        unsigned open = grid.openDirections(x, y);
+        while (open) {
+            Direction dir = static_cast<Direction>(__builtin_ctz(open));
+            open &= open - 1;
+            uint32_t next = index.neighbour(dead, x, y, dir);
+            if (backward.stamp[next] == epoch) continue;
+            if (--degree[next] == 1 && next != start && next != end) {
+                backward.stamp[next] = epoch;
+                backward.queue[tail++] = next;
+            }
+        }
+    }
+
+    return searchBfs(grid, index, start, end, true);
+}
+
+/**
+ * Append the cells from `from` back to the origin of `side`, as row-major
+ * cell indices
+ */
+template <class Index>
+void MazeSolver::walkBack(const Index& index, int width, const Side& side, uint32_t from, uint32_t to,
+                          std::vector<uint32_t>& path) {
+    const uint32_t w = static_cast<uint32_t>(width);
+    uint32_t cell = from;
+    int x, y;
+    index.coords(cell, x, y);
+    path.push_back(static_cast<uint32_t>(y) * w + static_cast<uint32_t>(x));
+    while (cell != to) {
+        cell = index.neighbour(cell, x, y, opposite(static_cast<Direction>(side.parent[cell])));
+        index.coords(cell, x, y);
+        path.push_back(static_cast<uint32_t>(y) * w + static_cast<uint32_t>(x));
+    }
+}
+
+/**
+ * Shortest path as a list of cells
+ */
+bool MazeSolver::solve(const MazeGrid& grid, int startX, int startY, int endX, int endY,
+                       std::vector<uint32_t>& path, SolverMode mode) {
+    path.clear();
+    if (!grid.inBounds(startX, startY) || !grid.inBounds(endX, endY)) return false;
+
+    bool found = false;
+    auto run = [&](const auto& index) {
+        uint32_t start = index.index(startX, startY);
+        uint32_t end = index.index(endX, endY);
+        if (!search(grid, index, start, end, mode)) return;
+        found = true;
+
+        // Start ... meetFrom is stored backwards; meetTo ... end is in order
+        walkBack(index, grid.getWidth(), forward, meetFrom, start, path);
+        std::reverse(path.begin(), path.end());
+        if (usedBackward) walkBack(index, grid.getWidth(), backward, meetTo, end, path);
+    };
+    withIndex(layout, grid, run);
+    return found;
+}
+
+/**
+ * Path length only (no path materialized)
+ */
+long long MazeSolver::shortestPathLength(const MazeGrid& grid, int startX, int startY, int endX, int endY,
+                                         SolverMode mode) {
+    if (!grid.inBounds(startX, startY) || !grid.inBounds(endX, endY)) return -1;
+
+    long long length = -1;
+    auto run = [&](const auto& index) {
+        if (!search(grid, index, index.index(startX, startY), index.index(endX, endY), mode)) return;
+        length = forward.distance[meetFrom];
+        if (usedBackward) length += 1 + backward.distance[meetTo];
+    };
+    withIndex(layout, grid, run);
+    return length;
+}
+
+/**
+ * BFS flood fill: a search for a cell that does not exist visits every
+ * reachable cell exactly once
+ */
+size_t MazeSolver::reachableCells(const MazeGrid& grid, int x, int y) {
+    if (!grid.inBounds(x, y)) return 0;
+
+    auto run = [&](const auto& index) {
+        newQuery(index.size());
+        searchBfs(grid, index, index.index(x, y), UINT32_MAX);
+    };
+    withIndex(layout, grid, run);
+    CounterScope counters;
+    counters.expand(expanded);
+    return expanded;
+}
+
+/**
+ * Cell path to Direction codes
+ */
+void MazeSolver::pathToDirections(const std::vector<uint32_t>& path, int width, std::vector<uint8_t>& moves) {
+    moves.clear();
+    for (size_t i = 1; i < path.size(); i++) {
+        long long delta = static_cast<long long>(path[i]) - path[i - 1];
+        if (delta == -width) moves.push_back(TOP);
+        else if (delta == 1) moves.push_back(RIGHT);
+        else if (delta == width) moves.push_back(BOTTOM);
+        else moves.push_back(LEFT);
+    }
+}
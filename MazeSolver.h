@@ -0,0 +1,140 @@
+#ifndef MAZE_SOLVER_H
+#define MAZE_SOLVER_H
+
+#include <cstdint>
+#include <vector>
+#include "MazeGrid.h"
+#include "MazeLayout.h"
+
+/**
+ * Point-to-point search strategies. All return a shortest path.
+ */
+enum class SolverMode {
+    BFS,            // Single-ended breadth-first search
+    BIDIRECTIONAL,  // BFS from both ends, smaller frontier first
+    ASTAR,          // A* with the solver's heuristic (Manhattan by default)
+    DEAD_END_FILL   // Fill dead ends first, then BFS through what is left
+};
+
+const int SOLVER_MODE_COUNT = 4;
+
+/**
+ * Human-readable name of a solver mode
+ */
+const char* solverModeName(SolverMode mode);
+
+/**
+ * Lower bound on the steps from (x, y) to (endX, endY); must never
+ * overestimate, or A* may return a longer path
+ */
+using SolverHeuristic = uint32_t (*)(int x, int y, int endX, int endY);
+
+uint32_t manhattanDistance(int x, int y, int endX, int endY);
+
+/**
+ * Reusable shortest-path solver context
+ *
+ * All scratch (queues, heap, parent directions, distances, visited marks)
+ * is owned by the context and sized once per maze size, on first use by a
+ * mode that needs it. Visited marks are epoch stamps: a cell counts as
+ * visited when its stamp equals the current query's epoch, so nothing has
+ * to be cleared between queries. The scratch is indexed in the context's
+ * CellLayout (row-major by default; see MazeLayout.h), so a wide maze can
+ * be searched with tiled Morton or Hilbert order. Paths are cell indices
+ * (y * width + x) from start to end whatever the layout. No console I/O.
+ */
+class MazeSolver {
+public:
+    /**
+     * Search from (startX, startY) to (endX, endY). On success `path` holds
+     * the cells of a shortest path, start first; otherwise it is emptied.
+     * Returns false for out-of-range endpoints or when the end is
+     * unreachable.
+     */
+    bool solve(const MazeGrid& grid, int startX, int startY, int endX, int endY,
+               std::vector<uint32_t>& path, SolverMode mode = SolverMode::BFS);
+
+    /**
+     * Length in steps of the shortest path, or -1 if there is none
+     */
+    long long shortestPathLength(const MazeGrid& grid, int startX, int startY, int endX, int endY,
+                                 SolverMode mode = SolverMode::BFS);
+
+    /**
+     * Number of cells reachable from (x, y), the start included; 0 if the
+     * start is out of range. Equals cellCount() exactly when the maze is
+     * connected.
+     */
+    size_t reachableCells(const MazeGrid& grid, int x, int y);
+
+    /**
+     * Convert a cell path into Direction codes, one per step
+     */
+    static void pathToDirections(const std::vector<uint32_t>& path, int width, std::vector<uint8_t>& moves);
+
+    void setHeuristic(SolverHeuristic h) { heuristic = h; }
+
+    /**
+     * Memory order of the scratch for later queries; results do not change
+     */
+    void setLayout(CellLayout order) { layout = order; }
+    CellLayout getLayout() const { return layout; }
+
+    /**
+     * Cells taken off a queue or heap (or filled, for DEAD_END_FILL)
+     * during the last query
+     */
+    size_t nodesExpanded() const { return expanded; }
+
+    size_t memoryBytes() const;
+
+private:
+    // Per-direction search state; BIDIRECTIONAL uses both, the others only `forward`
+    struct Side {
+        std::vector<uint32_t> stamp;     // Epoch in which each cell was reached
+        std::vector<uint32_t> distance;  // Steps from this side's origin
+        std::vector<uint8_t> parent;     // Direction taken to enter each cell
+        std::vector<uint32_t> queue;     // FIFO, at most one entry per cell
+    };
+
+    struct HeapEntry {
+        uint32_t f;     // g + heuristic
+        uint32_t g;
+        uint32_t cell;
+    };
+
+    // Kernels, instantiated per layout; cells are scratch indices
+    template <class Index>
+    bool search(const MazeGrid& grid, const Index& index, uint32_t start, uint32_t end, SolverMode mode);
+    template <class Index>
+    bool searchBfs(const MazeGrid& grid, const Index& index, uint32_t start, uint32_t end, bool skipFilled = false);
+    template <class Index>
+    bool searchBidirectional(const MazeGrid& grid, const Index& index, uint32_t start, uint32_t end);
+    template <class Index>
+    bool searchAStar(const MazeGrid& grid, const Index& index, uint32_t start, uint32_t end);
+    template <class Index>
+    bool searchDeadEndFill(const MazeGrid& grid, const Index& index, uint32_t start, uint32_t end);
+    template <class Index>
+    void walkBack(const Index& index, int width, const Side& side, uint32_t from, uint32_t to,
+                  std::vector<uint32_t>& path);
+    void newQuery(size_t cells);
+    void ensure(Side& side, size_t cells);
+
+    Side forward;
+    Side backward;
+    std::vector<HeapEntry> heap;
+    std::vector<uint8_t> degree;  // Open sides per cell, for dead-end filling
+    SolverHeuristic heuristic = manhattanDistance;
+    CellLayout layout = CellLayout::ROW_MAJOR;
+    size_t cellCount = 0;
+    uint32_t epoch = 0;
+    size_t expanded = 0;
+
+    // Result of the last successful search: start ... meetFrom -> meetTo ... end.
+    // meetFrom == meetTo unless the search was bidirectional.
+    uint32_t meetFrom = 0;
+    uint32_t meetTo = 0;
+    bool usedBackward = false;
+};
+
+#endif // MAZE_SOLVER_H
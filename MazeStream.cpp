@@ -0,0 +1,278 @@
+#include "MazeStream.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+inline bool wallBit(const uint64_t* row, int x) {
+    return (row[x >> 6] >> (x & 63)) & 1ULL;
+}
+
+void putLE(char* buffer, uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; i++) {
+        buffer[i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+    }
+}
+
+/**
+ * A glyph of up to 3 UTF-8 bytes, copied as 4 bytes and advanced by length
+ */
+struct Glyph {
+    char bytes[4];
+    size_t length;
+};
+
+const Glyph SPACE = {{' ', 0, 0, 0}, 1};
+const Glyph VERTICAL = {{'\xE2', '\x94', '\x82', 0}, 3};    // │
+const Glyph HORIZONTAL = {{'\xE2', '\x94', '\x80', 0}, 3};  // ─
+const Glyph TEE_DOWN = {{'\xE2', '\x94', '\xAC', 0}, 3};    // ┬
+const Glyph TEE_RIGHT = {{'\xE2', '\x94', '\x9C', 0}, 3};   // ├
+const Glyph CROSS = {{'\xE2', '\x94', '\xBC', 0}, 3};       // ┼
+
+// Slack so a 4-byte glyph copy never runs past the reserved space
+const size_t GLYPH_SLACK = 4;
+
+inline char* put(char* p, const Glyph& glyph) {
+    std::memcpy(p, glyph.bytes, 4);
+    return p + glyph.length;
+}
+
+inline char* put(char* p, const char* text, size_t length) {
+    std::memcpy(p, text, length);
+    return p + length;
+}
+
+/**
+ * Corner glyph for index bottom | right << 1 | bottomRight << 2 | bottomLeft << 3,
+ * with the same precedence as the original per-corner if-chain
+ */
+struct CornerTable {
+    Glyph glyphs[16];
+
+    CornerTable() {
+        for (int i = 0; i < 16; i++) {
+            bool hasBottom = i & 1;
+            bool hasRight = i & 2;
+            bool hasBottomRight = i & 4;
+            bool hasBottomLeft = i & 8;
+            if (hasBottom && hasRight && hasBottomRight && hasBottomLeft) glyphs[i] = CROSS;
+            else if (hasBottom && hasBottomRight) glyphs[i] = TEE_DOWN;
+            else if (hasRight && hasBottomLeft) glyphs[i] = TEE_RIGHT;
+            else if (hasBottom || hasBottomRight) glyphs[i] = HORIZONTAL;
+            else if (hasRight || hasBottomLeft) glyphs[i] = VERTICAL;
+            else glyphs[i] = SPACE;
+        }
+    }
+};
+
+const CornerTable CORNERS;
+}
+
+/**
+ * Parse a stream format name
+ */
+bool parseStreamFormat(const std::string& name, StreamFormat& format) {
+    if (name == "box") {
+        format = StreamFormat::BOX;
+    } else if (name == "ascii") {
+        format = StreamFormat::ASCII;
+    } else if (name == "binary") {
+        format = StreamFormat::BINARY;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+BufferedSink::BufferedSink(std::ostream& os) : out(&os), chunk(CHUNK_BYTES) {}
+
+BufferedSink::BufferedSink(std::string& text) : target(&text), used(text.size()) {}
+
+BufferedSink::~BufferedSink() {
+    flush();
+}
+
+char* BufferedSink::reserve(size_t bytes) {
+    if (target) {
+        if (target->size() < used + bytes) {
+            target->resize(std::max(used + bytes, target->size() * 2));
+        }
+    } else if (used + bytes > chunk.size()) {
+        flush();
+        if (bytes > chunk.size()) chunk.resize(bytes);  // One very wide row
+    }
+    return base() + used;
+}
+
+void BufferedSink::append(const char* data, size_t bytes) {
+    commit(put(reserve(bytes), data, bytes));
+}
+
+/**
+ * Stream: one write of everything buffered. String: trim the spare tail.
+ */
+void BufferedSink::flush() {
+    if (target) {
+        target->resize(used);
+    } else if (used > 0) {
+        out->write(chunk.data(), static_cast<std::streamsize>(used));
+        used = 0;
+    }
+}
+
+/**
+ * Box drawing: top border
+ */
+void BoxDrawingSink::begin(int w, int, unsigned int) {
+    width = w;
+    rowsSeen = 0;
+    size_t words = (static_cast<size_t>(width) + 63) / 64;
+    pendingEast.assign(words, ~0ULL);
+    pendingSouth.assign(words, ~0ULL);
+
+    char* p = reserve(static_cast<size_t>(width) * 9 + 7 + GLYPH_SLACK);
+    p = put(p, "┌", 3);
+    for (int x = 0; x < width; x++) {
+        p = put(p, "──", 6);
+        if (x < width - 1) p = put(p, "┬", 3);
+    }
+    p = put(p, "┐\n", 4);
+    commit(p);
+}
+
+/**
+ * Box drawing: separator below the previous row, then this row's cells
+ */
+void BoxDrawingSink::row(const uint64_t* eastRow, const uint64_t* southRow) {
+    // Separator <= 9 bytes per cell, cell line <= 5 bytes per cell
+    char* p = reserve(static_cast<size_t>(width) * 14 + 14 + GLYPH_SLACK);
+
+    if (rowsSeen > 0) {
+        // Horizontal walls of the previous row, corners from the 16-entry table
+        const uint64_t* south = pendingSouth.data();
+        const uint64_t* east = pendingEast.data();
+        p = put(p, "├", 3);
+        for (int x = 0; x < width; x++) {
+            bool hasBottom = wallBit(south, x);
+            p = hasBottom ? put(p, "──", 6) : put(p, "  ", 2);
+            if (x < width - 1) {
+                unsigned index = static_cast<unsigned>(hasBottom)
+                               | static_cast<unsigned>(wallBit(east, x)) << 1
+                               | static_cast<unsigned>(wallBit(south, x + 1)) << 2
+                               | static_cast<unsigned>(wallBit(eastRow, x)) << 3;
+                p = put(p, CORNERS.glyphs[index]);
+            }
+        }
+        p = put(p, "┤\n", 4);
+    }
+
+    // Vertical walls and spaces
+    p = put(p, "│", 3);
+    for (int x = 0; x < width; x++) {
+        p = put(p, "  ", 2);
+        if (x < width - 1) {
+            p = put(p, wallBit(eastRow, x) ? VERTICAL : SPACE);
+        }
+    }
+    p = put(p, "│\n", 4);
+    commit(p);
+
+    std::copy(eastRow, eastRow + pendingEast.size(), pendingEast.begin());
+    std::copy(southRow, southRow + pendingSouth.size(), pendingSouth.begin());
+    rowsSeen++;
+}
+
+/**
+ * Box drawing: bottom border
+ */
+void BoxDrawingSink::end() {
+    char* p = reserve(static_cast<size_t>(width) * 9 + 7 + GLYPH_SLACK);
+    p = put(p, "└", 3);
+    for (int x = 0; x < width; x++) {
+        p = put(p, "──", 6);
+        if (x < width - 1) p = put(p, "┴", 3);
+    }
+    p = put(p, "┘\n", 4);
+    commit(p);
+    flush();
+}
+
+/**
+ * ASCII: top border
+ */
+void AsciiSink::begin(int w, int h, unsigned int) {
+    width = w;
+    height = h;
+    rowsSeen = 0;
+    char* p = reserve(static_cast<size_t>(width) * 2 + 2);
+    std::memset(p, '#', static_cast<size_t>(width) * 2 + 1);
+    p[width * 2 + 1] = '\n';
+    commit(p + width * 2 + 2);
+}
+
+/**
+ * ASCII: cell line, then bottom walls unless this is the last row
+ */
+void AsciiSink::row(const uint64_t* eastRow, const uint64_t* southRow) {
+    const size_t line = static_cast<size_t>(width) * 2 + 2;
+    char* p = reserve(line * 2);
+
+    // Left border, then cell content and right walls
+    *p++ = '#';
+    for (int x = 0; x < width; x++) {
+        *p++ = ' ';
+        *p++ = (x == width - 1 || wallBit(eastRow, x)) ? '#' : ' ';
+    }
+    *p++ = '\n';
+
+    rowsSeen++;
+    if (rowsSeen < height) {
+        *p++ = '#';
+        for (int x = 0; x < width; x++) {
+            *p++ = wallBit(southRow, x) ? '#' : ' ';
+            *p++ = '#';
+        }
+        *p++ = '\n';
+    }
+    commit(p);
+}
+
+/**
+ * ASCII: bottom border
+ */
+void AsciiSink::end() {
+    char* p = reserve(static_cast<size_t>(width) * 2 + 2);
+    std::memset(p, '#', static_cast<size_t>(width) * 2 + 1);
+    p[width * 2 + 1] = '\n';
+    commit(p + width * 2 + 2);
+    flush();
+}
+
+/**
+ * Binary: fixed header
+ */
+void BinaryRowSink::begin(int width, int height, unsigned int seed) {
+    rowWords = (static_cast<size_t>(width) + 63) / 64;
+    char* p = reserve(24);
+    std::memcpy(p, "MAZEROWS", 8);
+    putLE(p + 8, 1, 4);
+    putLE(p + 12, static_cast<uint32_t>(width), 4);
+    putLE(p + 16, static_cast<uint32_t>(height), 4);
+    putLE(p + 20, seed, 4);
+    commit(p + 24);
+}
+
+/**
+ * Binary: east words then south words of one row
+ */
+void BinaryRowSink::row(const uint64_t* eastRow, const uint64_t* southRow) {
+    char* p = reserve(rowWords * 16);
+    for (size_t w = 0; w < rowWords; w++) {
+        putLE(p + 8 * w, eastRow[w], 8);
+        putLE(p + 8 * (rowWords + w), southRow[w], 8);
+    }
+    commit(p + rowWords * 16);
+}
+
+void BinaryRowSink::end() {
+    flush();
+}
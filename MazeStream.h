@@ -0,0 +1,136 @@
+#ifndef MAZE_STREAM_H
+#define MAZE_STREAM_H
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * Output formats for row-by-row maze output
+ */
+enum class StreamFormat {
+    BOX,     // Unicode box drawing, same as Maze::printMaze
+    ASCII,   // '#' walls, same as Maze::printMazeASCII
+    BINARY   // Header followed by packed wall words per row
+};
+
+/**
+ * Parse "box", "ascii" or "binary"; returns false for anything else
+ */
+bool parseStreamFormat(const std::string& name, StreamFormat& format);
+
+/**
+ * Receiver for finished maze rows
+ *
+ * Rows arrive top to bottom in MazeGrid's packed row format: word w holds
+ * columns [64w, 64w + 64), a set bit means the east (or south) wall of that
+ * cell is present. Sinks keep at most one row of state, so their memory
+ * does not depend on the maze height.
+ */
+class MazeRowSink {
+public:
+    virtual ~MazeRowSink() = default;
+
+    virtual void begin(int width, int height, unsigned int seed) = 0;
+    virtual void row(const uint64_t* eastRow, const uint64_t* southRow) = 0;
+    virtual void end() = 0;
+};
+
+/**
+ * Common output path of the built-in sinks
+ *
+ * Rendered bytes go into a chunk buffer that is handed to the stream in
+ * one write() per CHUNK_BYTES, or are appended straight to a caller's
+ * string (reserve it up front to avoid any reallocation). The buffer is
+ * allocated once in the constructor.
+ */
+class BufferedSink : public MazeRowSink {
+public:
+    static const size_t CHUNK_BYTES = 64 * 1024;
+
+protected:
+    explicit BufferedSink(std::ostream& os);
+    explicit BufferedSink(std::string& target);
+    ~BufferedSink() override;
+
+    /**
+     * Room for at least `bytes` more bytes; returns where to write them.
+     * Call commit() with the number actually written.
+     */
+    char* reserve(size_t bytes);
+    void commit(char* end) { used = static_cast<size_t>(end - base()); }
+    void append(const char* data, size_t bytes);
+    void flush();
+
+private:
+    char* base() { return target ? &(*target)[0] : chunk.data(); }
+
+    std::ostream* out = nullptr;
+    std::string* target = nullptr;
+    std::vector<char> chunk;
+    size_t used = 0;  // Bytes of chunk (or target) filled
+};
+
+/**
+ * Box-drawing text, one row behind so corners can see the next row
+ */
+class BoxDrawingSink : public BufferedSink {
+public:
+    explicit BoxDrawingSink(std::ostream& os) : BufferedSink(os) {}
+    explicit BoxDrawingSink(std::string& target) : BufferedSink(target) {}
+
+    void begin(int width, int height, unsigned int seed) override;
+    void row(const uint64_t* eastRow, const uint64_t* southRow) override;
+    void end() override;
+
+private:
+    int width = 0;
+    int rowsSeen = 0;
+    std::vector<uint64_t> pendingEast;   // Previous row, for the separator line
+    std::vector<uint64_t> pendingSouth;
+};
+
+/**
+ * '#'-based ASCII text
+ */
+class AsciiSink : public BufferedSink {
+public:
+    explicit AsciiSink(std::ostream& os) : BufferedSink(os) {}
+    explicit AsciiSink(std::string& target) : BufferedSink(target) {}
+
+    void begin(int width, int height, unsigned int seed) override;
+    void row(const uint64_t* eastRow, const uint64_t* southRow) override;
+    void end() override;
+
+private:
+    int width = 0;
+    int height = 0;
+    int rowsSeen = 0;
+};
+
+/**
+ * Binary row stream
+ *
+ * Layout (all integers little-endian):
+ *   char[8]  magic "MAZEROWS"
+ *   uint32   version (1)
+ *   uint32   width
+ *   uint32   height
+ *   uint32   seed
+ *   then per row: ceil(width / 64) east words, ceil(width / 64) south words
+ */
+class BinaryRowSink : public BufferedSink {
+public:
+    explicit BinaryRowSink(std::ostream& os) : BufferedSink(os) {}
+    explicit BinaryRowSink(std::string& target) : BufferedSink(target) {}
+
+    void begin(int width, int height, unsigned int seed) override;
+    void row(const uint64_t* eastRow, const uint64_t* southRow) override;
+    void end() override;
+
+private:
+    size_t rowWords = 0;
+};
+
+#endif // MAZE_STREAM_H
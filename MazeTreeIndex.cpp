@@ -0,0 +1,199 @@
+#include "MazeTreeIndex.h"
+#include <algorithm>
+
+namespace {
+const uint32_t UNSET = 0xFFFFFFFFu;
+
+inline uint32_t floorLog2(uint32_t v) {
+    return 31u - static_cast<uint32_t>(__builtin_clz(v));
+}
+}
+
+void MazeTreeIndex::clear() {
+    width = height = 0;
+    cellCount = 0;
+    preorder.clear();
+    order.clear();
+    preorderDepth.clear();
+    parentDirection.clear();
+    stackMask.clear();
+    blockTable.clear();
+}
+
+size_t MazeTreeIndex::memoryBytes() const {
+    size_t bytes = (preorder.capacity() + order.capacity() + preorderDepth.capacity()) * sizeof(uint32_t)
+                 + parentDirection.capacity() + stackMask.capacity() * sizeof(uint64_t);
+    for (const std::vector<uint32_t>& level : blockTable) {
+        bytes += level.capacity() * sizeof(uint32_t);
+    }
+    return bytes;
+}
+
+/**
+ * Root at cell 0, record preorder, depth and parent direction, then build
+ * the range-minimum structure over preorder depths
+ */
+bool MazeTreeIndex::build(const MazeGrid& grid) {
+    clear();
+    const size_t cells = grid.cellCount();
+    // Connected with exactly n - 1 passages <=> spanning tree
+    if (cells == 0 || cells > UNSET || grid.countPassages() != cells - 1) return false;
+
+    width = grid.getWidth();
+    height = grid.getHeight();
+    preorder.assign(cells, UNSET);
+    order.resize(cells);
+    preorderDepth.resize(cells);
+    parentDirection.resize(cells);
+
+    // Iterative DFS; a node's subtree is finished before anything below it
+    // on the stack, so every subtree occupies a contiguous preorder range
+    std::vector<uint32_t> stack;
+    stack.push_back(0);
+    parentDirection[0] = 0;
+    uint32_t next = 0;
+    while (!stack.empty()) {
+        uint32_t cell = stack.back();
+        stack.pop_back();
+        if (preorder[cell] != UNSET) continue;  // Only possible with a cycle
+
+        int x = static_cast<int>(cell % width);
+        int y = static_cast<int>(cell / width);
+        preorder[cell] = next;
+        order[next] = cell;
+        preorderDepth[next] = cell == 0 ? 0 : preorderDepth[preorder[parent(cell)]] + 1;
+        next++;
+
+        unsigned open = grid.openDirections(x, y);
+        while (open) {
+            Direction dir = static_cast<Direction>(__builtin_ctz(open));
+            open &= open - 1;
+            uint32_t child = static_cast<uint32_t>((y + DY[dir]) * width + (x + DX[dir]));
+            if (preorder[child] == UNSET) {
+                parentDirection[child] = static_cast<uint8_t>((dir + 2) & 3);
+                stack.push_back(child);
+            }
+        }
+    }
+
+    if (next != cells) {
+        clear();
+        return false;
+    }
+    cellCount = cells;
+    buildRangeMinimum();
+    return true;
+}
+
+/**
+ * Per-position min-stack masks inside each block, and a sparse table of
+ * block minima on top
+ */
+void MazeTreeIndex::buildRangeMinimum() {
+    const uint32_t n = static_cast<uint32_t>(cellCount);
+    stackMask.resize(n);
+    uint64_t mask = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        uint32_t offset = i % BLOCK;
+        uint32_t blockStart = i - offset;
+        if (offset == 0) mask = 0;
+        // Drop stack entries at least as deep as position i
+        while (mask && preorderDepth[blockStart + 63 - __builtin_clzll(mask)] >= preorderDepth[i]) {
+            mask &= ~(1ULL << (63 - __builtin_clzll(mask)));
+        }
+        mask |= 1ULL << offset;
+        stackMask[i] = mask;
+    }
+
+    const uint32_t blocks = (n + BLOCK - 1) / BLOCK;
+    blockTable.assign(1, std::vector<uint32_t>(blocks));
+    for (uint32_t b = 0; b < blocks; b++) {
+        uint32_t last = std::min(n, (b + 1) * BLOCK) - 1;
+        blockTable[0][b] = b * BLOCK + static_cast<uint32_t>(__builtin_ctzll(stackMask[last]));
+    }
+    for (uint32_t k = 1; (1u << k) <= blocks; k++) {
+        const std::vector<uint32_t>& below = blockTable[k - 1];
+        std::vector<uint32_t> level(blocks - (1u << k) + 1);
+        for (uint32_t i = 0; i < level.size(); i++) {
+            level[i] = shallower(below[i], below[i + (1u << (k - 1))]);
+        }
+        blockTable.push_back(std::move(level));
+    }
+}
+
+uint32_t MazeTreeIndex::parent(uint32_t cell) const {
+    return neighbourIndex(cell, parentDirection[cell], width);
+}
+
+/**
+ * Shallowest preorder position in [l, r], l <= r
+ */
+uint32_t MazeTreeIndex::minPosition(uint32_t l, uint32_t r) const {
+    uint32_t lb = l / BLOCK;
+    uint32_t rb = r / BLOCK;
+    auto inBlock = [this](uint32_t from, uint32_t to) {
+        uint32_t blockStart = to - to % BLOCK;
+        uint64_t mask = stackMask[to] & (~0ULL << (from - blockStart));
+        return blockStart + static_cast<uint32_t>(__builtin_ctzll(mask));
+    };
+
+    if (lb == rb) return inBlock(l, r);
+
+    uint32_t best = shallower(inBlock(l, lb * BLOCK + BLOCK - 1), inBlock(rb * BLOCK, r));
+    if (rb - lb > 1) {
+        uint32_t first = lb + 1;
+        uint32_t count = rb - first;
+        uint32_t k = floorLog2(count);
+        best = shallower(best, shallower(blockTable[k][first], blockTable[k][rb - (1u << k)]));
+    }
+    return best;
+}
+
+/**
+ * Also correct when one cell is an ancestor of the other: the shallowest
+ * cell in (pa, pb] is then that ancestor's child on the way down
+ */
+uint32_t MazeTreeIndex::lowestCommonAncestor(uint32_t a, uint32_t b) const {
+    if (a == b) return a;
+    uint32_t pa = preorder[a];
+    uint32_t pb = preorder[b];
+    if (pa > pb) std::swap(pa, pb);
+    return parent(order[minPosition(pa + 1, pb)]);
+}
+
+uint32_t MazeTreeIndex::distance(uint32_t a, uint32_t b) const {
+    if (a == b) return 0;
+    uint32_t pa = preorder[a];
+    uint32_t pb = preorder[b];
+    if (pa > pb) std::swap(pa, pb);
+    // The LCA is one level above the shallowest cell in (pa, pb]
+    uint32_t lcaDepth = preorderDepth[minPosition(pa + 1, pb)] - 1;
+    return preorderDepth[pa] + preorderDepth[pb] - 2 * lcaDepth;
+}
+
+long long MazeTreeIndex::distance(int x1, int y1, int x2, int y2) const {
+    if (!valid() || x1 < 0 || x1 >= width || y1 < 0 || y1 >= height ||
+        x2 < 0 || x2 >= width || y2 < 0 || y2 >= height) {
+        return -1;
+    }
+    return distance(static_cast<uint32_t>(y1 * width + x1), static_cast<uint32_t>(y2 * width + x2));
+}
+
+/**
+ * Climb from both ends to the LCA; the second half is reversed in place
+ */
+bool MazeTreeIndex::path(int x1, int y1, int x2, int y2, std::vector<uint32_t>& path) const {
+    path.clear();
+    if (distance(x1, y1, x2, y2) < 0) return false;
+
+    uint32_t a = static_cast<uint32_t>(y1 * width + x1);
+    uint32_t b = static_cast<uint32_t>(y2 * width + x2);
+    uint32_t top = lowestCommonAncestor(a, b);
+
+    for (uint32_t cell = a; cell != top; cell = parent(cell)) path.push_back(cell);
+    path.push_back(top);
+    size_t half = path.size();
+    for (uint32_t cell = b; cell != top; cell = parent(cell)) path.push_back(cell);
+    std::reverse(path.begin() + half, path.end());
+    return true;
+}
@@ -0,0 +1,78 @@
+#ifndef MAZE_TREE_INDEX_H
+#define MAZE_TREE_INDEX_H
+
+#include <cstdint>
+#include <vector>
+#include "MazeGrid.h"
+
+/**
+ * Any-pair path index for perfect mazes
+ *
+ * A perfect maze is a spanning tree of its cells, so every pair of cells
+ * has exactly one path. build() roots the tree at cell 0, numbers the
+ * cells in DFS preorder and keeps each cell's depth and parent direction.
+ * For cells u, v with pre(u) < pre(v), the shallowest cell in preorder
+ * positions (pre(u), pre(v)] is a child of their lowest common ancestor.
+ * That range minimum is answered in O(1) by a sparse table over blocks of
+ * 64 positions plus one 64-bit min-stack mask per position, so memory
+ * stays O(n) (about 21 bytes per cell).
+ *
+ * distance() is O(1); path() is O(path length). Cells are indices
+ * y * width + x. The index is a snapshot: rebuild it after the maze
+ * changes.
+ */
+class MazeTreeIndex {
+public:
+    /**
+     * Index the maze. Returns false (and leaves the index empty) if the
+     * maze is not a perfect maze, i.e. not exactly one path between every
+     * pair of cells.
+     */
+    bool build(const MazeGrid& grid);
+
+    void clear();
+    bool valid() const { return cellCount != 0; }
+
+    /**
+     * Steps between two cells; -1 for out-of-range cells or an empty index
+     */
+    long long distance(int x1, int y1, int x2, int y2) const;
+    uint32_t distance(uint32_t a, uint32_t b) const;
+
+    /**
+     * Lowest common ancestor of two cells in the tree rooted at cell 0
+     */
+    uint32_t lowestCommonAncestor(uint32_t a, uint32_t b) const;
+
+    /**
+     * The unique path between two cells, first cell first. Returns false
+     * (path emptied) for out-of-range cells or an empty index.
+     */
+    bool path(int x1, int y1, int x2, int y2, std::vector<uint32_t>& path) const;
+
+    uint32_t depth(uint32_t cell) const { return preorderDepth[preorder[cell]]; }
+
+    size_t memoryBytes() const;
+
+private:
+    static const uint32_t BLOCK = 64;
+
+    uint32_t parent(uint32_t cell) const;
+    uint32_t minPosition(uint32_t l, uint32_t r) const;  // Shallowest position in [l, r]
+    uint32_t shallower(uint32_t a, uint32_t b) const {
+        return preorderDepth[b] < preorderDepth[a] ? b : a;
+    }
+    void buildRangeMinimum();
+
+    int width = 0;
+    int height = 0;
+    size_t cellCount = 0;
+    std::vector<uint32_t> preorder;       // Cell -> preorder position
+    std::vector<uint32_t> order;          // Preorder position -> cell
+    std::vector<uint32_t> preorderDepth;  // Depth of the cell at each position
+    std::vector<uint8_t> parentDirection; // Direction from each cell to its parent
+    std::vector<uint64_t> stackMask;      // In-block min-stack at each position
+    std::vector<std::vector<uint32_t>> blockTable;  // Level k: shallowest position of blocks [i, i + 2^k)
+};
+
+#endif // MAZE_TREE_INDEX_H
@@ -0,0 +1,115 @@
+#include "ThreadPool.h"
+
+/**
+ * Start threads - 1 helper threads; the caller acts as worker 0
+ */
+ThreadPool::ThreadPool(int threads) {
+    if (threads <= 0) {
+        threads = static_cast<int>(std::thread::hardware_concurrency());
+        if (threads <= 0) threads = 1;
+    }
+
+    for (int i = 0; i < threads; i++) {
+        queues.push_back(std::make_unique<WorkQueue>());
+    }
+    for (int i = 1; i < threads; i++) {
+        workers.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+/**
+ * Own queue first (front), then steal from the others (back)
+ */
+bool ThreadPool::takeTask(int worker, size_t& task) {
+    {
+        WorkQueue& own = *queues[worker];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = own.tasks.front();
+            own.tasks.pop_front();
+            return true;
+        }
+    }
+
+    int n = size();
+    for (int i = 1; i < n; i++) {
+        WorkQueue& victim = *queues[(worker + i) % n];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = victim.tasks.back();
+            victim.tasks.pop_back();
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::runTasks(int worker) {
+    size_t task;
+    while (takeTask(worker, task)) {
+        (*job)(task, worker);
+    }
+}
+
+void ThreadPool::workerLoop(int worker) {
+    size_t seenGeneration = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&] { return stopping || jobGeneration != seenGeneration; });
+            if (stopping) return;
+            seenGeneration = jobGeneration;
+        }
+
+        runTasks(worker);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            busyWorkers--;
+        }
+        finished.notify_one();
+    }
+}
+
+/**
+ * Distribute contiguous blocks of tasks and run them to completion
+ */
+void ThreadPool::parallelFor(size_t count, const std::function<void(size_t, int)>& fn) {
+    if (count == 0) return;
+
+    int n = size();
+    for (int w = 0; w < n; w++) {
+        size_t begin = count * w / n;
+        size_t end = count * (w + 1) / n;
+        WorkQueue& queue = *queues[w];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        for (size_t task = begin; task < end; task++) {
+            queue.tasks.push_back(task);
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        job = &fn;
+        busyWorkers = n - 1;
+        jobGeneration++;
+    }
+    wake.notify_all();
+
+    runTasks(0);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    finished.wait(lock, [&] { return busyWorkers == 0; });
+    job = nullptr;
+}
@@ -0,0 +1,59 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Small work-stealing thread pool for index-parallel loops
+ *
+ * parallelFor(count, fn) splits [0, count) into one contiguous block per
+ * worker. A worker takes tasks from the front of its own queue and, once
+ * it runs dry, steals from the back of the others. The calling thread is
+ * worker 0, so a pool of size 1 runs everything inline.
+ */
+class ThreadPool {
+public:
+    explicit ThreadPool(int threads = 0);  // 0 = hardware concurrency
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    int size() const { return static_cast<int>(queues.size()); }
+
+    /**
+     * Run fn(task, worker) for every task in [0, count); returns when all
+     * tasks have finished. worker is in [0, size()).
+     */
+    void parallelFor(size_t count, const std::function<void(size_t, int)>& fn);
+
+private:
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<size_t> tasks;
+    };
+
+    bool takeTask(int worker, size_t& task);
+    void runTasks(int worker);
+    void workerLoop(int worker);
+
+    std::vector<std::unique_ptr<WorkQueue>> queues;
+    std::vector<std::thread> workers;
+
+    std::mutex mutex;
+    std::condition_variable wake;     // New job or shutdown
+    std::condition_variable finished; // All helpers left the current job
+    const std::function<void(size_t, int)>* job = nullptr;
+    size_t jobGeneration = 0;
+    int busyWorkers = 0;
+    bool stopping = false;
+};
+
+#endif // THREAD_POOL_H
@@ -0,0 +1,119 @@
+#include "TiledGenerator.h"
+#include <algorithm>
+
+namespace {
+/**
+ * SplitMix64 finalizer, used to derive independent per-tile seeds
+ */
+uint64_t mix64(uint64_t z) {
+    z += 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// mt19937 takes the low 32 bits; the other engines use all 64
+uint64_t tileSeed(unsigned int seed, uint64_t tile) {
+    return mix64(mix64(seed) ^ tile);
+}
+}
+
+int TiledGenerator::tileWidth(int tileSize) {
+    if (tileSize < 1) tileSize = 1;
+    return (tileSize + 63) / 64 * 64;
+}
+
+/**
+ * Generate tiles in parallel, then stitch them with a spanning tree of seams
+ */
+void TiledGenerator::generate(MazeGrid& grid, unsigned int seed, int tileSize, ThreadPool& pool,
+                              MazeAlgorithm algorithm, RandomEngine engine) {
+    const int width = grid.getWidth();
+    const int height = grid.getHeight();
+    grid.clearVisited();
+    if (width <= 0 || height <= 0) return;
+
+    const int tileW = tileWidth(tileSize);
+    const int tileH = std::max(tileSize, 1);
+    const int tilesX = (width + tileW - 1) / tileW;
+    const int tilesY = (height + tileH - 1) / tileH;
+    const size_t tileCount = static_cast<size_t>(tilesX) * tilesY;
+
+    if (scratch.size() < static_cast<size_t>(pool.size())) {
+        scratch.resize(pool.size());
+    }
+
+    // Phase 1: every tile is an independent perfect maze. Its border walls
+    // stay closed, and its words do not overlap any other tile's.
+    pool.parallelFor(tileCount, [&](size_t tile, int worker) {
+        int tx = static_cast<int>(tile % tilesX);
+        int ty = static_cast<int>(tile / tilesX);
+        int x0 = tx * tileW;
+        int y0 = ty * tileH;
+        int w = std::min(tileW, width - x0);
+        int h = std::min(tileH, height - y0);
+
+        WorkerScratch& local = scratch[worker];
+        if (local.tile.getWidth() != w || local.tile.getHeight() != h) {
+            local.tile.resize(w, h);
+        }
+        MazeRandom rng(tileSeed(seed, tile), engine);
+        local.engine.generate(algorithm, local.tile, rng);
+
+        const size_t words = local.tile.getRowWords();
+        const size_t wordOffset = static_cast<size_t>(x0) / 64;
+        for (int r = 0; r < h; r++) {
+            std::copy(local.tile.eastRow(r), local.tile.eastRow(r) + words, grid.eastRow(y0 + r) + wordOffset);
+            std::copy(local.tile.southRow(r), local.tile.southRow(r) + words, grid.southRow(y0 + r) + wordOffset);
+        }
+    });
+
+    // Phase 2: random spanning tree over the tile graph; one opening per seam
+    MazeRandom rng(mix64(seed ^ 0x5EA11ULL), engine);
+    seams.clear();
+    for (size_t tile = 0; tile < tileCount; tile++) {
+        int tx = static_cast<int>(tile % tilesX);
+        int ty = static_cast<int>(tile / tilesX);
+        if (tx < tilesX - 1) seams.push_back(static_cast<uint32_t>(tile << 1));
+        if (ty < tilesY - 1) seams.push_back(static_cast<uint32_t>((tile << 1) | 1));
+    }
+    for (size_t i = seams.size(); i > 1; i--) {
+        std::swap(seams[i - 1], seams[boundedDraw(rng, static_cast<uint32_t>(i))]);
+    }
+
+    tileParent.resize(tileCount);
+    for (size_t i = 0; i < tileCount; i++) tileParent[i] = static_cast<uint32_t>(i);
+    auto find = [this](uint32_t v) {
+        while (tileParent[v] != v) {
+            tileParent[v] = tileParent[tileParent[v]];
+            v = tileParent[v];
+        }
+        return v;
+    };
+
+    for (uint32_t seam : seams) {
+        uint32_t tile = seam >> 1;
+        bool south = seam & 1u;
+        uint32_t other = south ? tile + tilesX : tile + 1;
+        uint32_t a = find(tile);
+        uint32_t b = find(other);
+        if (a == b) continue;
+        tileParent[a] = b;
+
+        int tx = static_cast<int>(tile % tilesX);
+        int ty = static_cast<int>(tile / tilesX);
+        int x0 = tx * tileW;
+        int y0 = ty * tileH;
+        if (south) {
+            // Random column along the bottom edge of this tile
+            int span = std::min(tileW, width - x0);
+            int x = x0 + static_cast<int>(boundedDraw(rng, span));
+            grid.removeWall(x, y0 + tileH - 1, BOTTOM);
+        } else {
+            // Random row along the right edge of this tile
+            int span = std::min(tileH, height - y0);
+            int y = y0 + static_cast<int>(boundedDraw(rng, span));
+            grid.removeWall(x0 + tileW - 1, y, RIGHT);
+        }
+    }
+}
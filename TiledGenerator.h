@@ -0,0 +1,45 @@
+#ifndef TILED_GENERATOR_H
+#define TILED_GENERATOR_H
+
+#include <cstdint>
+#include <vector>
+#include "MazeGenerators.h"
+#include "MazeGrid.h"
+#include "ThreadPool.h"
+
+/**
+ * Multithreaded tiled generation with stitched seams
+ *
+ * The grid is cut into tiles of tileWidth(tileSize) x tileSize cells (the
+ * width is rounded up to a multiple of 64 so every tile owns whole words of
+ * each row and tiles can be written concurrently). Each tile is generated
+ * as an independent perfect maze on the thread pool, seeded only from
+ * (seed, tile index). A random spanning tree over the tile adjacency graph
+ * - Kruskal, seeded from the seed alone - then opens one random wall on
+ * each chosen seam, so the whole grid is again a perfect maze.
+ *
+ * The output depends only on (seed, tileSize, algorithm, engine), never
+ * on the number of threads or on which worker ran which tile.
+ */
+class TiledGenerator {
+public:
+    void generate(MazeGrid& grid, unsigned int seed, int tileSize, ThreadPool& pool,
+                  MazeAlgorithm algorithm = MazeAlgorithm::DFS, RandomEngine engine = RandomEngine::MT19937);
+
+    /**
+     * Tile width actually used for a requested tile size
+     */
+    static int tileWidth(int tileSize);
+
+private:
+    struct WorkerScratch {
+        MazeGrid tile;
+        MazeGeneratorEngine engine;
+    };
+
+    std::vector<WorkerScratch> scratch;  // One per pool worker
+    std::vector<uint32_t> tileParent;    // Union-find over tiles
+    std::vector<uint32_t> seams;         // tile * 2 + (0 = east seam, 1 = south seam)
+};
+
+#endif // TILED_GENERATOR_H
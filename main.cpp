@@ -1,8 +1,16 @@
 #include "Maze.h"
+#include "Benchmarks.h"
+#include "MazeInstrumentation.h"
+#include "MazeParallelBfs.h"
 #include <iostream>
+#include <map>
+#include <thread>
 #include <string>
 #include <chrono>
+#include <fstream>
 #include <limits>
+#include <algorithm>
+#include <cstdio>
 
 /**
  * Display the main menu
@@ -21,6 +29,25 @@ void displayMenu() {
     std::cout << "8. Generate multiple mazes comparison\n";
     std::cout << "9. Performance test\n";
     std::cout << "A. Check maze connectivity (debug)\n";
+    std::cout << "B. Generate maze with another algorithm\n";
+    std::cout << "C. Parallel generation scaling benchmark\n";
+    std::cout << "D. Batch generation throughput benchmark\n";
+    std::cout << "E. Solver comparison benchmark\n";
+    std::cout << "F. Tree index query benchmark\n";
+    std::cout << "G. Rendering throughput benchmark\n";
+    std::cout << "H. Save current maze to file\n";
+    std::cout << "I. Load maze from file\n";
+    std::cout << "J. File load vs regenerate benchmark\n";
+    std::cout << "K. Export current maze as image (PBM/PGM)\n";
+    std::cout << "L. Random engine benchmark\n";
+    std::cout << "M. Connectivity check benchmark\n";
+    std::cout << "N. Parallel BFS distance field benchmark\n";
+    std::cout << "O. Maze analytics benchmark\n";
+    std::cout << "P. Maze reuse (pool) benchmark\n";
+    std::cout << "Q. Live wall edit benchmark\n";
+    std::cout << "R. Cell layout benchmark\n";
+    std::cout << "S. Compile-time maze size benchmark\n";
+    std::cout << "T. Batched distance query benchmark\n";
     std::cout << "0. Exit\n";
     std::cout << std::string(50, '=') << "\n";
     std::cout << "Choose an option: ";
@@ -45,6 +72,22 @@ int getIntInput(const std::string& prompt, int min = 0, int max = 1000) {
     }
 }
 
+/**
+ * Counter summary of one phase; prints nothing in uninstrumented builds
+ */
+void printPhaseCounters(const PhaseProfiler::Phase& phase) {
+    if (!MAZE_INSTRUMENTED) return;
+    const MazeCounters& c = phase.counters;
+    std::cout << "  cells visited " << c.cellsVisited << ", backtracks " << c.backtracks
+              << ", max stack depth " << c.maxStackDepth << ", nodes expanded " << c.nodesExpanded
+              << ", allocations " << c.allocations << " (" << c.bytesAllocated << " bytes)\n";
+    if (phase.hardware.available) {
+        const HardwareCounters& h = phase.hardware;
+        std::cout << "  cycles " << h.cycles << ", instructions " << h.instructions
+                  << ", cache misses " << h.cacheMisses << ", branch misses " << h.branchMisses << "\n";
+    }
+}
+
 /**
  * Generate and display a basic maze
  */
@@ -53,7 +96,8 @@ void generateBasicMaze(Maze& maze, bool useRecursive = false) {
               << (useRecursive ? "recursive" : "iterative") 
               << " algorithm...\n";
     
-    auto start = std::chrono::high_resolution_clock::now();
+    PhaseProfiler profiler;
+    profiler.begin("generate");
     
     if (useRecursive) {
         maze.generateMazeRecursive();
@@ -61,10 +105,10 @@ void generateBasicMaze(Maze& maze, bool useRecursive = false) {
         maze.generateMazeIterative();
     }
     
-    auto end = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
-    
-    std::cout << "Generation completed in " << duration.count() << " microseconds.\n";
+    profiler.end();
+    std::cout << "Generation completed in " << static_cast<long long>(profiler.phases()[0].milliseconds * 1000)
+              << " microseconds.\n";
+    printPhaseCounters(profiler.phases()[0]);
     maze.printMaze();
 }
 
@@ -75,18 +119,15 @@ void generateCustomMaze(Maze &currentMaze) {
     int width = getIntInput("Enter maze width (3-50): ", 3, 50);
     int height = getIntInput("Enter maze height (3-50): ", 3, 50);
 
-    Maze customMaze(width, height);
-
     std::cout << "\nChoose algorithm:\n";
     std::cout << "1. Iterative (Stack-based)\n";
     std::cout << "2. Recursive\n";
     int choice = getIntInput("Choice (1-2): ", 1, 2);
 
-    generateBasicMaze(customMaze, choice == 2);
-
-    // Replace the currentMaze with the newly generated maze so option 7
-    // (solve current maze) operates on the maze the user just created.
-    currentMaze = std::move(customMaze);
+    // Reuse currentMaze in place so option 7 (solve current maze) operates
+    // on the maze the user just created, without reallocating it
+    currentMaze.reset(width, height);
+    generateBasicMaze(currentMaze, choice == 2);
 }
 
 /**
@@ -97,18 +138,67 @@ void generateSeededMaze(Maze &currentMaze) {
     int height = getIntInput("Enter maze height (3-30): ", 3, 30);
     unsigned int seed = getIntInput("Enter seed value: ", 0, 999999);
 
-    Maze seededMaze(width, height, seed);
-
     std::cout << "\nChoose algorithm:\n";
     std::cout << "1. Iterative (Stack-based)\n";
     std::cout << "2. Recursive\n";
     int choice = getIntInput("Choice (1-2): ", 1, 2);
 
     std::cout << "\nUsing seed: " << seed << "\n";
-    generateBasicMaze(seededMaze, choice == 2);
+    // The seeded maze becomes the current maze for subsequent operations
+    currentMaze.reset(width, height, seed);
+    generateBasicMaze(currentMaze, choice == 2);
+}
 
-    // Make the seeded maze the current maze for subsequent operations
-    currentMaze = std::move(seededMaze);
+/**
+ * Report the connectivity check; true when every cell is reachable
+ */
+bool printConnectivity(const Maze& maze) {
+    size_t visitedCount = maze.reachableCells();
+    size_t totalCells = maze.getGrid().cellCount();
+    std::cout << "\nMaze connectivity check:\n";
+    std::cout << "Visited cells: " << visitedCount << "/" << totalCells << "\n";
+    
+    if (visitedCount == totalCells) {
+        std::cout << "✓ Maze is properly connected!\n";
+        return true;
+    } else {
+        std::cout << "✗ Maze has isolated regions! " << (totalCells - visitedCount) << " cells unreachable.\n";
+        return false;
+    }
+}
+
+/**
+ * Generate a maze with any of the pluggable algorithms and verify it
+ */
+void generateAlgorithmMaze(Maze &currentMaze) {
+    int width = getIntInput("Enter maze width (3-50): ", 3, 50);
+    int height = getIntInput("Enter maze height (3-50): ", 3, 50);
+    unsigned int seed = getIntInput("Enter seed value: ", 0, 999999);
+
+    std::cout << "\nChoose algorithm:\n";
+    for (int i = 0; i < MAZE_ALGORITHM_COUNT; i++) {
+        std::cout << (i + 1) << ". " << algorithmName(static_cast<MazeAlgorithm>(i)) << "\n";
+    }
+    int choice = getIntInput("Choice (1-" + std::to_string(MAZE_ALGORITHM_COUNT) + "): ", 1, MAZE_ALGORITHM_COUNT);
+    MazeAlgorithm algorithm = static_cast<MazeAlgorithm>(choice - 1);
+
+    currentMaze.reset(width, height, seed);
+    std::cout << "\nGenerating maze using " << algorithmName(algorithm) << " (seed " << seed << ")...\n";
+
+    auto start = std::chrono::high_resolution_clock::now();
+    currentMaze.generate(algorithm, seed);
+    auto end = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+
+    std::cout << "Generation completed in " << duration.count() << " microseconds.\n";
+    currentMaze.printMaze();
+
+    // A perfect maze is connected and has exactly cells - 1 passages
+    size_t cells = static_cast<size_t>(width) * height;
+    bool connected = printConnectivity(currentMaze);
+    bool perfect = connected && currentMaze.countPassages() == cells - 1;
+    std::cout << "Passages: " << currentMaze.countPassages() << " (perfect maze needs " << (cells - 1) << ")\n";
+    std::cout << (perfect ? "✓ Perfect maze\n" : "✗ Not a perfect maze\n");
 }
 
 /**
@@ -137,37 +227,234 @@ void compareMazes() {
  * Performance testing
  */
 void performanceTest() {
-    std::cout << "\nPerformance Test - Maze Generation Times\n";
-    std::cout << std::string(45, '-') << "\n";
+    // Quick pass of the benchmark suite (10^2 .. 10^5 cells); `make bench` runs it all
+    BenchmarkSuiteOptions options;
+    options.maxCells = 100000;
+    options.repetitions = 11;
+    options.budgetMs = 200;
+    if (!runBenchmarkSuite(std::cout, options)) {
+        std::cout << "File cases skipped: cannot write " << options.scratchPath << "\n";
+    }
+}
+
+/**
+ * Parallel generation scaling benchmark
+ */
+void parallelScalingTest() {
+    int size = getIntInput("Enter maze size (100-10000): ", 100, 10000);
+    int tile = getIntInput("Enter tile size (16-4096): ", 16, 4096);
+    int hardware = std::max(1u, std::thread::hardware_concurrency());
+    int threads = getIntInput("Maximum threads (1-" + std::to_string(hardware) + "): ", 1, hardware);
     
-    std::vector<std::pair<int, int>> sizes = {{10, 10}, {20, 20}, {30, 30}, {40, 40}};
+    runParallelScalingBenchmark(std::cout, size, size, tile, threads, 12345);
+}
+
+/**
+ * Batch generation throughput benchmark
+ */
+void batchThroughputTest() {
+    int size = getIntInput("Enter maze size (3-100): ", 3, 100);
+    int count = getIntInput("Number of mazes (1-1000000): ", 1, 1000000);
+    int hardware = std::max(1u, std::thread::hardware_concurrency());
+    int threads = getIntInput("Threads (1-" + std::to_string(hardware) + "): ", 1, hardware);
     
-    for (const auto& size : sizes) {
-        int width = size.first;
-        int height = size.second;
-        
-        std::cout << "Testing " << width << "x" << height << " maze:\n";
-        
-        // Test iterative algorithm
-        Maze iterativeMaze(width, height);
-        auto start = std::chrono::high_resolution_clock::now();
-        iterativeMaze.generateMazeIterative();
-        auto end = std::chrono::high_resolution_clock::now();
-        auto iterativeTime = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
-        
-        // Test recursive algorithm
-        Maze recursiveMaze(width, height);
-        start = std::chrono::high_resolution_clock::now();
-        recursiveMaze.generateMazeRecursive();
-        end = std::chrono::high_resolution_clock::now();
-        auto recursiveTime = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
-        
-        std::cout << "  Iterative: " << std::setw(8) << iterativeTime.count() << " μs\n";
-        std::cout << "  Recursive: " << std::setw(8) << recursiveTime.count() << " μs\n";
-        std::cout << "  Difference: " << std::setw(7) << (recursiveTime.count() - iterativeTime.count()) << " μs\n\n";
+    runBatchBenchmark(std::cout, size, size, count, threads, 12345);
+}
+
+/**
+ * Compare the solver modes on one large maze
+ */
+void solverComparisonTest() {
+    int size = getIntInput("Enter maze size (3-8000): ", 3, 8000);
+    int queries = getIntInput("Random queries (0-10000): ", 0, 10000);
+    
+    runSolverBenchmark(std::cout, size, size, queries, 12345);
+}
+
+/**
+ * Tree index queries against repeated BFS
+ */
+void treeIndexTest() {
+    int size = getIntInput("Enter maze size (3-8000): ", 3, 8000);
+    int queries = getIntInput("Random queries (1-10000000): ", 1, 10000000);
+    
+    runTreeIndexBenchmark(std::cout, size, size, queries, 20, 12345);
+}
+
+/**
+ * Text renderer throughput
+ */
+void renderThroughputTest() {
+    int size = getIntInput("Enter maze size (3-8000): ", 3, 8000);
+    
+    runRenderBenchmark(std::cout, size, size, 12345);
+}
+
+/**
+ * Random engines: draw rate and generation throughput
+ */
+void randomEngineTest() {
+    int size = getIntInput("Enter maze size (3-8000): ", 3, 8000);
+    
+    runRandomBenchmark(std::cout, size, size, 12345);
+}
+
+/**
+ * Bit-parallel flood fill against the old DFS connectivity check
+ */
+void connectivityTest() {
+    int size = getIntInput("Enter maze size (3-8000): ", 3, 8000);
+    
+    runConnectivityBenchmark(std::cout, size, size, 12345);
+}
+
+/**
+ * Multi-threaded BFS distance fields across thread counts
+ */
+void parallelBfsTest() {
+    int size = getIntInput("Enter maze size (3-8000): ", 3, 8000);
+    int hardware = std::max(1u, std::thread::hardware_concurrency());
+    int threads = getIntInput("Maximum threads (1-" + std::to_string(hardware) + "): ", 1, hardware);
+    
+    runParallelBfsBenchmark(std::cout, size, size, threads, 12345);
+}
+
+/**
+ * Dead ends, corridors, diameter and solution shape per algorithm
+ */
+void analyticsTest() {
+    int size = getIntInput("Enter maze size (3-8000): ", 3, 8000);
+    
+    runAnalyticsBenchmark(std::cout, size, size, 12345);
+}
+
+/**
+ * Construction against reset and pool leases for short-lived mazes
+ */
+void mazePoolTest() {
+    int size = getIntInput("Enter maze size (3-2000): ", 3, 2000);
+    int cycles = getIntInput("Cycles (1-1000000): ", 1, 1000000);
+    
+    runPoolBenchmark(std::cout, size, size, cycles, 12345);
+}
+
+/**
+ * Incremental connectivity and path length against full recompute per edit
+ */
+void wallEditTest() {
+    int size = getIntInput("Enter maze size (3-2000): ", 3, 2000);
+    int edits = getIntInput("Edits per stream (1-100000): ", 1, 100000);
+    
+    runEditBenchmark(std::cout, size, size, edits, 12345);
+}
+
+/**
+ * Solver scratch in row-major, Morton and Hilbert order
+ */
+void cellLayoutTest() {
+    int size = getIntInput("Enter maze size (3-4000): ", 3, 4000);
+    
+    runLayoutBenchmark(std::cout, size, size, 12345);
+}
+
+/**
+ * FixedMaze at 16, 32 and 64 against the dynamic grid
+ */
+void fixedMazeTest() {
+    int count = getIntInput("Mazes per size (1-100000): ", 1, 100000);
+    
+    runFixedBenchmark(std::cout, count, 12345);
+}
+
+/**
+ * Batched distance fields and pair queries against one BFS per query
+ */
+void multiSourceTest() {
+    int size = getIntInput("Enter maze size (3-2000): ", 3, 2000);
+    int sources = getIntInput("Source cells (1-1000): ", 1, 1000);
+    int pairs = getIntInput("Pair queries (1-100000): ", 1, 100000);
+    int threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    
+    runMultiSourceBenchmark(std::cout, size, size, sources, pairs, threads, 12345);
+}
+
+/**
+ * Save the current maze in the binary maze format
+ */
+void saveMazeToFile(const Maze& maze) {
+    std::string path;
+    std::cout << "Enter file name: ";
+    std::cin >> path;
+    
+    MazeFileStatus status = maze.save(path);
+    if (status == MazeFileStatus::OK) {
+        std::cout << "Saved " << maze.getWidth() << "x" << maze.getHeight() << " maze to " << path << "\n";
+    } else {
+        std::cout << "Could not save " << path << ": " << mazeFileStatusName(status) << "\n";
     }
 }
 
+/**
+ * Replace the current maze with one loaded (memory-mapped) from a file
+ */
+void loadMazeFromFile(Maze& maze) {
+    std::string path;
+    std::cout << "Enter file name: ";
+    std::cin >> path;
+    
+    auto start = std::chrono::high_resolution_clock::now();
+    MazeFileStatus status = maze.load(path);
+    auto end = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+    
+    if (status != MazeFileStatus::OK) {
+        std::cout << "Could not load " << path << ": " << mazeFileStatusName(status) << "\n";
+        return;
+    }
+    const MazeOrigin& origin = maze.getOrigin();
+    std::cout << "Loaded " << maze.getWidth() << "x" << maze.getHeight() << " maze ("
+              << algorithmName(origin.algorithm) << ", seed " << origin.seed << ") in "
+              << duration.count() << " microseconds.\n";
+    if (maze.getWidth() <= 100 && maze.getHeight() <= 100) {
+        maze.printMaze();
+    }
+}
+
+/**
+ * Write the current maze (and its last solution, if any) as a raster image
+ */
+void exportMazeImage(const Maze& maze) {
+    std::string path;
+    std::cout << "Enter file name (.pbm or .pgm): ";
+    std::cin >> path;
+    
+    RasterOptions options;
+    if (path.size() >= 4 && path.compare(path.size() - 4, 4, ".pbm") == 0) {
+        options.format = RasterFormat::PBM;
+    }
+    options.cellPixels = getIntInput("Pixels per cell (1-64): ", 1, 64);
+    
+    std::ofstream file(path, std::ios::binary);
+    if (!file) {
+        std::cout << "Could not open " << path << " for writing\n";
+        return;
+    }
+    const std::vector<uint32_t>& solution = maze.getSolution();
+    maze.writeImage(file, options, solution.empty() ? nullptr : &solution);
+    std::cout << "Wrote " << RasterSink::imageWidth(maze.getWidth(), options) << "x"
+              << RasterSink::imageHeight(maze.getHeight(), options) << " image to " << path
+              << (solution.empty() ? "" : " (with solution path)") << "\n";
+}
+
+/**
+ * Mapped load against regeneration
+ */
+void fileLoadTest() {
+    int size = getIntInput("Enter maze size (3-20000): ", 3, 20000);
+    
+    runFileBenchmark(std::cout, size, size, 12345, "maze_benchmark.maze");
+}
+
 /**
  * Demonstrate maze solving
  */
@@ -176,22 +463,838 @@ void solveMazeDemo(Maze& maze) {
     std::cout << "Attempting to solve maze from (0,0) to (" 
               << (maze.getWidth()-1) << "," << (maze.getHeight()-1) << ")...\n";
     
-    auto start = std::chrono::high_resolution_clock::now();
+    PhaseProfiler profiler;
+    profiler.begin("solve");
     bool solved = maze.solveMaze();
-    auto end = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+    profiler.end();
     
     if (solved) {
-        std::cout << "Maze solved in " << duration.count() << " microseconds!\n";
+        std::cout << "Maze solved in " << static_cast<long long>(profiler.phases()[0].milliseconds * 1000)
+                  << " microseconds!\n";
+        printPhaseCounters(profiler.phases()[0]);
+        maze.printSolution();
     } else {
         std::cout << "Maze could not be solved.\n";
     }
 }
 
+/**
+ * Parse "--name value" pairs from argv[first] on; false on a malformed list.
+ * Names listed in `flags` take no value and are stored as "1".
+ */
+bool parseOptions(int argc, char* argv[], int first, std::map<std::string, std::string>& options,
+                  std::initializer_list<const char*> flags = {}) {
+    for (int i = first; i < argc; i += 2) {
+        std::string name = argv[i];
+        if (name.size() < 3 || name.compare(0, 2, "--") != 0) {
+            std::cerr << "Unexpected argument: " << name << "\n";
+            return false;
+        }
+        if (std::find(flags.begin(), flags.end(), name.substr(2)) != flags.end()) {
+            options[name.substr(2)] = "1";
+            i--;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << name << "\n";
+            return false;
+        }
+        options[name.substr(2)] = argv[i + 1];
+    }
+    return true;
+}
+
+/**
+ * Read an integer option within [min, max], keeping the default when absent
+ */
+bool optionValue(const std::map<std::string, std::string>& options, const std::string& name,
+                 long long& value, long long min, long long max) {
+    auto it = options.find(name);
+    if (it == options.end()) return true;
+    try {
+        size_t used = 0;
+        long long parsed = std::stoll(it->second, &used);
+        if (used == it->second.size() && parsed >= min && parsed <= max) {
+            value = parsed;
+            return true;
+        }
+    } catch (...) {
+    }
+    std::cerr << "Invalid value for --" << name << ": " << it->second
+              << " (expected " << min << ".." << max << ")\n";
+    return false;
+}
+
+/**
+ * Reject options a command does not understand
+ */
+bool onlyKnownOptions(const std::map<std::string, std::string>& options, std::initializer_list<const char*> known) {
+    for (const auto& option : options) {
+        if (std::find(known.begin(), known.end(), option.first) == known.end()) {
+            std::cerr << "Unknown option: --" << option.first << "\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Command-line streaming mode:
+ *   maze_generator stream --w W --h H [--seed S] [--format box|ascii|binary] [--out FILE]
+ * Generates with Eller's algorithm row by row, so memory does not grow
+ * with the height of the maze.
+ */
+int runStreamCommand(int argc, char* argv[]) {
+    const long long maxInt = std::numeric_limits<int>::max();
+    std::map<std::string, std::string> options;
+    long long width = 0, height = 0, seed = 0;
+    StreamFormat format = StreamFormat::BOX;
+
+    if (!parseOptions(argc, argv, 2, options) || !onlyKnownOptions(options, {"w", "h", "seed", "format", "out"}) ||
+        !optionValue(options, "w", width, 1, maxInt) || !optionValue(options, "h", height, 1, maxInt) ||
+        !optionValue(options, "seed", seed, 0, std::numeric_limits<unsigned int>::max())) {
+        return 2;
+    }
+    if (options.count("format") && !parseStreamFormat(options["format"], format)) {
+        std::cerr << "Unknown format: " << options["format"] << " (use box, ascii or binary)\n";
+        return 2;
+    }
+    if (width < 1 || height < 1) {
+        std::cerr << "Usage: maze_generator stream --w W --h H [--seed S] "
+                  << "[--format box|ascii|binary] [--out FILE]\n";
+        return 2;
+    }
+
+    std::ios::sync_with_stdio(false);
+    if (!options.count("out")) {
+        Maze::generateMazeStreaming(static_cast<int>(width), static_cast<int>(height),
+                                    static_cast<unsigned int>(seed), format, std::cout);
+        return std::cout ? 0 : 1;
+    }
+
+    std::ofstream file(options["out"], std::ios::binary);
+    if (!file) {
+        std::cerr << "Cannot open " << options["out"] << " for writing\n";
+        return 1;
+    }
+    Maze::generateMazeStreaming(static_cast<int>(width), static_cast<int>(height),
+                                static_cast<unsigned int>(seed), format, file);
+    return file ? 0 : 1;
+}
+
+/**
+ * Command-line scaling benchmark:
+ *   maze_generator scaling [--w W] [--h H] [--tile T] [--threads N] [--seed S] [--reps R]
+ */
+int runScalingCommand(int argc, char* argv[]) {
+    const long long maxInt = std::numeric_limits<int>::max();
+    std::map<std::string, std::string> options;
+    long long width = 4000, height = 4000, tile = 256, seed = 42, reps = 3;
+    long long threads = std::max(1u, std::thread::hardware_concurrency());
+
+    if (!parseOptions(argc, argv, 2, options) ||
+        !onlyKnownOptions(options, {"w", "h", "tile", "threads", "seed", "reps"}) ||
+        !optionValue(options, "w", width, 1, maxInt) || !optionValue(options, "h", height, 1, maxInt) ||
+        !optionValue(options, "tile", tile, 1, maxInt) || !optionValue(options, "threads", threads, 1, 1024) ||
+        !optionValue(options, "seed", seed, 0, std::numeric_limits<unsigned int>::max()) ||
+        !optionValue(options, "reps", reps, 1, 1000)) {
+        return 2;
+    }
+
+    runParallelScalingBenchmark(std::cout, static_cast<int>(width), static_cast<int>(height), static_cast<int>(tile),
+                                static_cast<int>(threads), static_cast<unsigned int>(seed), static_cast<int>(reps));
+    return 0;
+}
+
+/**
+ * Command-line batch benchmark:
+ *   maze_generator batch [--w W] [--h H] [--count N] [--threads T] [--seed S]
+ */
+int runBatchCommand(int argc, char* argv[]) {
+    std::map<std::string, std::string> options;
+    long long width = 30, height = 30, count = 100000, seed = 42;
+    long long threads = std::max(1u, std::thread::hardware_concurrency());
+
+    if (!parseOptions(argc, argv, 2, options) ||
+        !onlyKnownOptions(options, {"w", "h", "count", "threads", "seed"}) ||
+        !optionValue(options, "w", width, 1, 100000) || !optionValue(options, "h", height, 1, 100000) ||
+        !optionValue(options, "count", count, 1, 100000000) || !optionValue(options, "threads", threads, 1, 1024) ||
+        !optionValue(options, "seed", seed, 0, std::numeric_limits<unsigned int>::max())) {
+        return 2;
+    }
+
+    runBatchBenchmark(std::cout, static_cast<int>(width), static_cast<int>(height), static_cast<size_t>(count),
+                      static_cast<int>(threads), static_cast<unsigned int>(seed));
+    return 0;
+}
+
+/**
+ * Command-line solver comparison:
+ *   maze_generator solvers [--w W] [--h H] [--queries Q] [--seed S]
+ */
+int runSolversCommand(int argc, char* argv[]) {
+    std::map<std::string, std::string> options;
+    long long width = 4000, height = 4000, queries = 100, seed = 42;
+
+    if (!parseOptions(argc, argv, 2, options) ||
+        !onlyKnownOptions(options, {"w", "h", "queries", "seed"}) ||
+        !optionValue(options, "w", width, 1, 65535) || !optionValue(options, "h", height, 1, 65535) ||
+        !optionValue(options, "queries", queries, 0, 10000000) ||
+        !optionValue(options, "seed", seed, 0, std::numeric_limits<unsigned int>::max())) {
+        return 2;
+    }
+
+    runSolverBenchmark(std::cout, static_cast<int>(width), static_cast<int>(height), static_cast<int>(queries),
+                       static_cast<unsigned int>(seed));
+    return 0;
+}
+
+/**
+ * Command-line tree index benchmark:
+ *   maze_generator treeindex [--w W] [--h H] [--queries Q] [--bfs B] [--seed S]
+ */
+int runTreeIndexCommand(int argc, char* argv[]) {
+    std::map<std::string, std::string> options;
+    long long width = 4000, height = 4000, queries = 1000000, bfs = 20, seed = 42;
+
+    if (!parseOptions(argc, argv, 2, options) ||
+        !onlyKnownOptions(options, {"w", "h", "queries", "bfs", "seed"}) ||
+        !optionValue(options, "w", width, 1, 65535) || !optionValue(options, "h", height, 1, 65535) ||
+        !optionValue(options, "queries", queries, 1, 100000000) || !optionValue(options, "bfs", bfs, 1, 100000) ||
+        !optionValue(options, "seed", seed, 0, std::numeric_limits<unsigned int>::max())) {
+        return 2;
+    }
+
+    runTreeIndexBenchmark(std::cout, static_cast<int>(width), static_cast<int>(height), static_cast<int>(queries),
+                          static_cast<int>(bfs), static_cast<unsigned int>(seed));
+    return 0;
+}
+
+/**
+ * Command-line rendering benchmark:
+ *   maze_generator render [--w W] [--h H] [--seed S] [--reps R]
+ */
+int runRenderCommand(int argc, char* argv[]) {
+    std::map<std::string, std::string> options;
+    long long width = 2000, height = 2000, seed = 42, reps = 3;
+
+    if (!parseOptions(argc, argv, 2, options) ||
+        !onlyKnownOptions(options, {"w", "h", "seed", "reps"}) ||
+        !optionValue(options, "w", width, 1, 100000) || !optionValue(options, "h", height, 1, 100000) ||
+        !optionValue(options, "seed", seed, 0, std::numeric_limits<unsigned int>::max()) ||
+        !optionValue(options, "reps", reps, 1, 1000)) {
+        return 2;
+    }
+
+    runRenderBenchmark(std::cout, static_cast<int>(width), static_cast<int>(height), static_cast<unsigned int>(seed),
+                       static_cast<int>(reps));
+    return 0;
+}
+
+/**
+ * Command-line random engine benchmark:
+ *   maze_generator rng [--w W] [--h H] [--seed S] [--reps R]
+ */
+int runRngCommand(int argc, char* argv[]) {
+    std::map<std::string, std::string> options;
+    long long width = 1000, height = 1000, seed = 42, reps = 3;
+
+    if (!parseOptions(argc, argv, 2, options) ||
+        !onlyKnownOptions(options, {"w", "h", "seed", "reps"}) ||
+        !optionValue(options, "w", width, 1, 100000) || !optionValue(options, "h", height, 1, 100000) ||
+        !optionValue(options, "seed", seed, 0, std::numeric_limits<unsigned int>::max()) ||
+        !optionValue(options, "reps", reps, 1, 1000)) {
+        return 2;
+    }
+
+    runRandomBenchmark(std::cout, static_cast<int>(width), static_cast<int>(height), static_cast<unsigned int>(seed),
+                       static_cast<int>(reps));
+    return 0;
+}
+
+/**
+ * Command-line connectivity benchmark:
+ *   maze_generator connectivity [--w W] [--h H] [--seed S] [--reps R]
+ */
+int runConnectivityCommand(int argc, char* argv[]) {
+    std::map<std::string, std::string> options;
+    long long width = 2000, height = 2000, seed = 42, reps = 3;
+
+    if (!parseOptions(argc, argv, 2, options) ||
+        !onlyKnownOptions(options, {"w", "h", "seed", "reps"}) ||
+        !optionValue(options, "w", width, 1, 100000) || !optionValue(options, "h", height, 1, 100000) ||
+        !optionValue(options, "seed", seed, 0, std::numeric_limits<unsigned int>::max()) ||
+        !optionValue(options, "reps", reps, 1, 1000)) {
+        return 2;
+    }
+
+    runConnectivityBenchmark(std::cout, static_cast<int>(width), static_cast<int>(height),
+                             static_cast<unsigned int>(seed), static_cast<int>(reps));
+    return 0;
+}
+
+/**
+ * Command-line analytics benchmark:
+ *   maze_generator analyze [--w W] [--h H] [--seed S] [--reps R]
+ */
+int runAnalyzeCommand(int argc, char* argv[]) {
+    std::map<std::string, std::string> options;
+    long long width = 1000, height = 1000, seed = 42, reps = 3;
+
+    if (!parseOptions(argc, argv, 2, options) ||
+        !onlyKnownOptions(options, {"w", "h", "seed", "reps"}) ||
+        !optionValue(options, "w", width, 1, 100000) || !optionValue(options, "h", height, 1, 100000) ||
+        !optionValue(options, "seed", seed, 0, std::numeric_limits<unsigned int>::max()) ||
+        !optionValue(options, "reps", reps, 1, 1000)) {
+        return 2;
+    }
+
+    runAnalyticsBenchmark(std::cout, static_cast<int>(width), static_cast<int>(height),
+                          static_cast<unsigned int>(seed), static_cast<int>(reps));
+    return 0;
+}
+
+/**
+ * Command-line maze reuse benchmark:
+ *   maze_generator pool [--w W] [--h H] [--cycles N] [--seed S] [--reps R]
+ */
+int runPoolCommand(int argc, char* argv[]) {
+    std::map<std::string, std::string> options;
+    long long width = 32, height = 32, cycles = 20000, seed = 42, reps = 3;
+
+    if (!parseOptions(argc, argv, 2, options) ||
+        !onlyKnownOptions(options, {"w", "h", "cycles", "seed", "reps"}) ||
+        !optionValue(options, "w", width, 1, 100000) || !optionValue(options, "h", height, 1, 100000) ||
+        !optionValue(options, "cycles", cycles, 1, 100000000) ||
+        !optionValue(options, "seed", seed, 0, std::numeric_limits<unsigned int>::max()) ||
+        !optionValue(options, "reps", reps, 1, 1000)) {
+        return 2;
+    }
+
+    runPoolBenchmark(std::cout, static_cast<int>(width), static_cast<int>(height), static_cast<int>(cycles),
+                     static_cast<unsigned int>(seed), static_cast<int>(reps));
+    return 0;
+}
+
+/**
+ * Command-line live wall edit benchmark:
+ *   maze_generator edits [--w W] [--h H] [--edits N] [--seed S]
+ */
+int runEditsCommand(int argc, char* argv[]) {
+    std::map<std::string, std::string> options;
+    long long width = 500, height = 500, edits = 500, seed = 42;
+
+    if (!parseOptions(argc, argv, 2, options) ||
+        !onlyKnownOptions(options, {"w", "h", "edits", "seed"}) ||
+        !optionValue(options, "w", width, 2, 100000) || !optionValue(options, "h", height, 2, 100000) ||
+        !optionValue(options, "edits", edits, 1, 10000000) ||
+        !optionValue(options, "seed", seed, 0, std::numeric_limits<unsigned int>::max())) {
+        return 2;
+    }
+
+    runEditBenchmark(std::cout, static_cast<int>(width), static_cast<int>(height), static_cast<int>(edits),
+                     static_cast<unsigned int>(seed));
+    return 0;
+}
+
+/**
+ * Command-line cell layout benchmark:
+ *   maze_generator layout [--w W] [--h H] [--seed S] [--reps R]
+ */
+int runLayoutCommand(int argc, char* argv[]) {
+    std::map<std::string, std::string> options;
+    long long width = 2000, height = 2000, seed = 42, reps = 3;
+
+    if (!parseOptions(argc, argv, 2, options) ||
+        !onlyKnownOptions(options, {"w", "h", "seed", "reps"}) ||
+        !optionValue(options, "w", width, 1, 100000) || !optionValue(options, "h", height, 1, 100000) ||
+        !optionValue(options, "seed", seed, 0, std::numeric_limits<unsigned int>::max()) ||
+        !optionValue(options, "reps", reps, 1, 1000)) {
+        return 2;
+    }
+
+    runLayoutBenchmark(std::cout, static_cast<int>(width), static_cast<int>(height), static_cast<unsigned int>(seed),
+                       static_cast<int>(reps));
+    return 0;
+}
+
+/**
+ * Command-line compile-time size benchmark:
+ *   maze_generator fixed [--count N] [--seed S] [--reps R]
+ */
+int runFixedCommand(int argc, char* argv[]) {
+    std::map<std::string, std::string> options;
+    long long count = 2000, seed = 42, reps = 3;
+
+    if (!parseOptions(argc, argv, 2, options) ||
+        !onlyKnownOptions(options, {"count", "seed", "reps"}) ||
+        !optionValue(options, "count", count, 1, 1000000) ||
+        !optionValue(options, "seed", seed, 0, std::numeric_limits<unsigned int>::max()) ||
+        !optionValue(options, "reps", reps, 1, 1000)) {
+        return 2;
+    }
+
+    runFixedBenchmark(std::cout, static_cast<int>(count), static_cast<unsigned int>(seed), static_cast<int>(reps));
+    return 0;
+}
+
+/**
+ * Command-line batched distance query benchmark:
+ *   maze_generator multi [--w W] [--h H] [--sources N] [--pairs N] [--threads T] [--seed S] [--reps R]
+ */
+int runMultiCommand(int argc, char* argv[]) {
+    std::map<std::string, std::string> options;
+    long long width = 400, height = 400, sources = 256, pairs = 1000, seed = 42, reps = 3;
+    long long threads = std::max(1u, std::thread::hardware_concurrency());
+
+    if (!parseOptions(argc, argv, 2, options) ||
+        !onlyKnownOptions(options, {"w", "h", "sources", "pairs", "threads", "seed", "reps"}) ||
+        !optionValue(options, "w", width, 1, 100000) || !optionValue(options, "h", height, 1, 100000) ||
+        !optionValue(options, "sources", sources, 1, 100000) ||
+        !optionValue(options, "pairs", pairs, 1, 10000000) ||
+        !optionValue(options, "threads", threads, 1, 1024) ||
+        !optionValue(options, "seed", seed, 0, std::numeric_limits<unsigned int>::max()) ||
+        !optionValue(options, "reps", reps, 1, 1000)) {
+        return 2;
+    }
+
+    runMultiSourceBenchmark(std::cout, static_cast<int>(width), static_cast<int>(height), static_cast<int>(sources),
+                            static_cast<int>(pairs), static_cast<int>(threads), static_cast<unsigned int>(seed),
+                            static_cast<int>(reps));
+    return 0;
+}
+
+/**
+ * Command-line parallel BFS benchmark:
+ *   maze_generator pbfs [--w W] [--h H] [--threads T] [--seed S] [--reps R]
+ */
+int runParallelBfsCommand(int argc, char* argv[]) {
+    std::map<std::string, std::string> options;
+    long long width = 2000, height = 2000, seed = 42, reps = 3;
+    long long threads = std::max(1u, std::thread::hardware_concurrency());
+
+    if (!parseOptions(argc, argv, 2, options) ||
+        !onlyKnownOptions(options, {"w", "h", "threads", "seed", "reps"}) ||
+        !optionValue(options, "w", width, 1, 100000) || !optionValue(options, "h", height, 1, 100000) ||
+        !optionValue(options, "threads", threads, 1, 1024) ||
+        !optionValue(options, "seed", seed, 0, std::numeric_limits<unsigned int>::max()) ||
+        !optionValue(options, "reps", reps, 1, 1000)) {
+        return 2;
+    }
+
+    runParallelBfsBenchmark(std::cout, static_cast<int>(width), static_cast<int>(height), static_cast<int>(threads),
+                            static_cast<unsigned int>(seed), static_cast<int>(reps));
+    return 0;
+}
+
+/**
+ * Command-line file benchmark:
+ *   maze_generator filebench [--w W] [--h H] [--seed S] [--out FILE] [--reps R]
+ */
+int runFileBenchCommand(int argc, char* argv[]) {
+    std::map<std::string, std::string> options;
+    long long width = 4000, height = 4000, seed = 42, reps = 3;
+
+    if (!parseOptions(argc, argv, 2, options) ||
+        !onlyKnownOptions(options, {"w", "h", "seed", "out", "reps"}) ||
+        !optionValue(options, "w", width, 1, 100000) || !optionValue(options, "h", height, 1, 100000) ||
+        !optionValue(options, "seed", seed, 0, std::numeric_limits<unsigned int>::max()) ||
+        !optionValue(options, "reps", reps, 1, 1000)) {
+        return 2;
+    }
+    std::string path = options.count("out") ? options["out"] : "maze_benchmark.maze";
+
+    runFileBenchmark(std::cout, static_cast<int>(width), static_cast<int>(height), static_cast<unsigned int>(seed),
+                     path, static_cast<int>(reps));
+    return 0;
+}
+
+/**
+ * Command-line image export:
+ *   maze_generator image --w W --h H [--seed S] [--algo NAME] [--format pbm|pgm]
+ *                        [--cell PX] [--wall PX] [--solve 0|1] [--out FILE]
+ * Eller without --solve streams rows straight into the image, so memory
+ * stays at a few image rows whatever the maze size; everything else
+ * builds the maze first.
+ */
+int runImageCommand(int argc, char* argv[]) {
+    const long long maxInt = std::numeric_limits<int>::max();
+    std::map<std::string, std::string> options;
+    long long width = 0, height = 0, seed = 0, cell = 4, wall = 1, solve = 0;
+    MazeAlgorithm algorithm = MazeAlgorithm::DFS;
+    RasterOptions raster;
+
+    if (!parseOptions(argc, argv, 2, options) ||
+        !onlyKnownOptions(options, {"w", "h", "seed", "algo", "format", "cell", "wall", "solve", "out"}) ||
+        !optionValue(options, "w", width, 1, maxInt) || !optionValue(options, "h", height, 1, maxInt) ||
+        !optionValue(options, "seed", seed, 0, std::numeric_limits<unsigned int>::max()) ||
+        !optionValue(options, "cell", cell, 1, 1024) || !optionValue(options, "wall", wall, 1, 1024) ||
+        !optionValue(options, "solve", solve, 0, 1)) {
+        return 2;
+    }
+    if (options.count("algo") && !parseAlgorithm(options["algo"], algorithm)) {
+        std::cerr << "Unknown algorithm: " << options["algo"] << "\n";
+        return 2;
+    }
+    if (options.count("format") && !parseRasterFormat(options["format"], raster.format)) {
+        std::cerr << "Unknown format: " << options["format"] << " (use pbm or pgm)\n";
+        return 2;
+    }
+    if (width < 1 || height < 1) {
+        std::cerr << "Usage: maze_generator image --w W --h H [--seed S] [--algo NAME] [--format pbm|pgm] "
+                  << "[--cell PX] [--wall PX] [--solve 0|1] [--out FILE]\n";
+        return 2;
+    }
+    raster.cellPixels = static_cast<int>(cell);
+    raster.wallPixels = static_cast<int>(wall);
+
+    std::ios::sync_with_stdio(false);
+    std::ofstream file;
+    if (options.count("out")) {
+        file.open(options["out"], std::ios::binary);
+        if (!file) {
+            std::cerr << "Cannot open " << options["out"] << " for writing\n";
+            return 1;
+        }
+    }
+    std::ostream& out = options.count("out") ? static_cast<std::ostream&>(file) : std::cout;
+
+    if (algorithm == MazeAlgorithm::ELLER && !solve) {
+        RasterSink sink(out, raster);
+        Maze::generateMazeStreaming(static_cast<int>(width), static_cast<int>(height),
+                                    static_cast<unsigned int>(seed), sink);
+    } else {
+        Maze maze(static_cast<int>(width), static_cast<int>(height));
+        maze.generate(algorithm, static_cast<unsigned int>(seed));
+        std::vector<uint32_t> path;
+        if (solve) maze.findPath(0, 0, static_cast<int>(width) - 1, static_cast<int>(height) - 1, path);
+        maze.writeImage(out, raster, solve ? &path : nullptr);
+    }
+    out.flush();
+    return out ? 0 : 1;
+}
+
+/**
+ * Command-line benchmark suite (see BenchmarkSuiteOptions):
+ *   maze_generator bench [--min-cells N] [--max-cells N] [--warmup W] [--reps R] [--min-reps R]
+ *                        [--budget MS] [--seed S] [--only TEXT] [--format table|csv|json]
+ *                        [--out FILE] [--scratch FILE]
+ */
+int runBenchCommand(int argc, char* argv[]) {
+    std::map<std::string, std::string> options;
+    BenchmarkSuiteOptions suite;
+    long long minCells = 100, maxCells = 100000000, warmup = suite.warmup, reps = suite.repetitions;
+    long long minReps = suite.minRepetitions, budget = static_cast<long long>(suite.budgetMs), seed = suite.seed;
+
+    if (!parseOptions(argc, argv, 2, options) ||
+        !onlyKnownOptions(options, {"min-cells", "max-cells", "warmup", "reps", "min-reps", "budget", "seed", "only",
+                                    "format", "out", "scratch"}) ||
+        !optionValue(options, "min-cells", minCells, 1, 1000000000000LL) ||
+        !optionValue(options, "max-cells", maxCells, 1, 1000000000000LL) ||
+        !optionValue(options, "warmup", warmup, 0, 1000) || !optionValue(options, "reps", reps, 1, 100000) ||
+        !optionValue(options, "min-reps", minReps, 1, 100000) ||
+        !optionValue(options, "budget", budget, 0, 3600000) ||
+        !optionValue(options, "seed", seed, 0, std::numeric_limits<unsigned int>::max())) {
+        return 2;
+    }
+    if (options.count("format") && !parseBenchmarkFormat(options["format"], suite.format)) {
+        std::cerr << "Unknown format: " << options["format"] << " (use table, csv or json)\n";
+        return 2;
+    }
+    suite.minCells = static_cast<unsigned long long>(minCells);
+    suite.maxCells = static_cast<unsigned long long>(maxCells);
+    suite.warmup = static_cast<int>(warmup);
+    suite.repetitions = static_cast<int>(reps);
+    suite.minRepetitions = static_cast<int>(minReps);
+    suite.budgetMs = static_cast<double>(budget);
+    suite.seed = static_cast<unsigned int>(seed);
+    if (options.count("only")) suite.filter = options["only"];
+    if (options.count("scratch")) suite.scratchPath = options["scratch"];
+
+    std::ofstream file;
+    if (options.count("out")) {
+        file.open(options["out"]);
+        if (!file) {
+            std::cerr << "Cannot open " << options["out"] << " for writing\n";
+            return 1;
+        }
+    }
+    std::ostream& out = options.count("out") ? static_cast<std::ostream&>(file) : std::cout;
+
+    bool complete = runBenchmarkSuite(out, suite);
+    if (!complete) std::cerr << "File cases skipped: cannot write " << suite.scratchPath << "\n";
+    return complete && out ? 0 : 1;
+}
+
+/**
+ * Quote a string for JSON output
+ */
+std::string jsonString(const std::string& text) {
+    std::string quoted = "\"";
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            quoted += '\\';
+            quoted += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            char escape[8];
+            std::snprintf(escape, sizeof(escape), "\\u%04x", static_cast<unsigned char>(c));
+            quoted += escape;
+        } else {
+            quoted += c;
+        }
+    }
+    return quoted + "\"";
+}
+
+/**
+ * Non-interactive generation for scripts and pipelines:
+ *   maze_generator gen --w W --h H [--seed S] [--algo NAME] [--rng ENGINE] [--threads N]
+ *                      [--tile T] [--out FILE] [--solve] [--stats]
+ *                      [--render box|ascii|pbm|pgm --render-out FILE]
+ * Generates (tiled on N threads when --threads > 1 or --tile is given),
+ * checks connectivity, optionally solves corner to corner (with the
+ * parallel BFS when --threads > 1), optionally adds MazeAnalytics
+ * statistics, saves a maze file and renders. Prints one JSON object with per-phase timings to
+ * stdout; nothing else goes there. Instrumented builds (`make instrument`)
+ * add per-phase counters, and hardware counters where perf_event_open
+ * is allowed.
+ *
+ * Exit codes: 0 success, 1 I/O or resource error, 2 bad arguments,
+ * 3 maze not connected, 4 --solve found no path.
+ */
+int runGenCommand(int argc, char* argv[]) {
+    const long long maxInt = std::numeric_limits<int>::max();
+    std::map<std::string, std::string> options;
+    long long width = 0, height = 0, seed = 0, threads = 1, tile = 256;
+    MazeAlgorithm algorithm = MazeAlgorithm::DFS;
+    RandomEngine engine = RandomEngine::MT19937;
+    StreamFormat textFormat = StreamFormat::BOX;
+    RasterOptions raster;
+    bool image = false;
+
+    if (!parseOptions(argc, argv, 2, options, {"solve", "stats"}) ||
+        !onlyKnownOptions(options, {"w", "h", "seed", "algo", "rng", "threads", "tile", "out", "solve",
+                                    "stats", "render", "render-out"}) ||
+        !optionValue(options, "w", width, 1, maxInt) || !optionValue(options, "h", height, 1, maxInt) ||
+        !optionValue(options, "seed", seed, 0, std::numeric_limits<unsigned int>::max()) ||
+        !optionValue(options, "threads", threads, 1, 1024) || !optionValue(options, "tile", tile, 1, maxInt)) {
+        return 2;
+    }
+    if (options.count("algo") && !parseAlgorithm(options["algo"], algorithm)) {
+        std::cerr << "Unknown algorithm: " << options["algo"] << "\n";
+        return 2;
+    }
+    if (options.count("rng") && !parseRandomEngine(options["rng"], engine)) {
+        std::cerr << "Unknown random engine: " << options["rng"] << " (mt19937, xoshiro, pcg32, splitmix)\n";
+        return 2;
+    }
+    if (options.count("render")) {
+        const std::string& name = options["render"];
+        image = parseRasterFormat(name, raster.format);
+        if ((!image && (!parseStreamFormat(name, textFormat) || textFormat == StreamFormat::BINARY)) ||
+            !options.count("render-out")) {
+            std::cerr << "--render takes box, ascii, pbm or pgm, and needs --render-out FILE\n";
+            return 2;
+        }
+    }
+    if (width < 1 || height < 1) {
+        std::cerr << "Usage: maze_generator gen --w W --h H [--seed S] [--algo NAME] [--rng ENGINE] [--threads N]\n"
+                  << "                          [--tile T] [--out FILE] [--solve] [--stats]\n"
+                  << "                          [--render box|ascii|pbm|pgm --render-out FILE]\n";
+        return 2;
+    }
+
+    const bool tiled = threads > 1 || options.count("tile");
+    const bool solve = options.count("solve") > 0;
+    const bool analyze = options.count("stats") > 0;
+    MazeStats stats;
+    PhaseProfiler profiler;
+    size_t reachable = 0;
+    long long pathLength = -1;
+    int status = 0;
+
+    try {
+        profiler.begin("generate");
+        Maze maze(static_cast<int>(width), static_cast<int>(height), static_cast<unsigned int>(seed));
+        maze.setRandomEngine(engine);
+        if (tiled) {
+            maze.generateParallel(static_cast<unsigned int>(seed), static_cast<int>(tile), static_cast<int>(threads),
+                                  algorithm);
+        } else {
+            maze.generate(algorithm, static_cast<unsigned int>(seed));
+        }
+        profiler.end();
+
+        profiler.begin("check");
+        reachable = maze.reachableCells();
+        profiler.end();
+        if (reachable != maze.getGrid().cellCount()) status = 3;
+
+        std::vector<uint32_t> path;
+        if (solve) {
+            profiler.begin("solve");
+            bool found;
+            if (threads > 1) {
+                ThreadPool pool(static_cast<int>(threads));
+                MazeParallelBfs bfs;
+                found = bfs.solve(maze.getGrid(), 0, 0, maze.getWidth() - 1, maze.getHeight() - 1, pool, path);
+            } else {
+                found = maze.findPath(0, 0, maze.getWidth() - 1, maze.getHeight() - 1, path);
+            }
+            if (found) {
+                pathLength = static_cast<long long>(path.size()) - 1;
+            } else if (status == 0) {
+                status = 4;
+            }
+            profiler.end();
+        }
+
+        if (analyze) {
+            profiler.begin("stats");
+            stats = maze.analyze();
+            profiler.end();
+        }
+
+        if (options.count("out")) {
+            profiler.begin("save");
+            MazeFileStatus saved = maze.save(options["out"]);
+            profiler.end();
+            if (saved != MazeFileStatus::OK) {
+                std::cerr << "Cannot save " << options["out"] << ": " << mazeFileStatusName(saved) << "\n";
+                return 1;
+            }
+        }
+
+        if (options.count("render")) {
+            profiler.begin("render");
+            std::ofstream file(options["render-out"], std::ios::binary);
+            if (file) {
+                if (image) {
+                    maze.writeImage(file, raster, pathLength >= 0 ? &path : nullptr);
+                } else {
+                    maze.writeMaze(file, textFormat);
+                }
+                file.flush();
+            }
+            profiler.end();
+            if (!file) {
+                std::cerr << "Cannot write " << options["render-out"] << "\n";
+                return 1;
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "gen: " << e.what() << "\n";
+        return 1;
+    }
+
+    const unsigned long long cells = static_cast<unsigned long long>(width) * static_cast<unsigned long long>(height);
+    std::cout << std::fixed << std::setprecision(3)
+              << "{\"width\":" << width << ",\"height\":" << height << ",\"cells\":" << cells
+              << ",\"seed\":" << seed << ",\"algorithm\":" << jsonString(algorithmName(algorithm))
+              << ",\"rng\":" << jsonString(randomEngineKey(engine))
+              << ",\"threads\":" << threads << ",\"tile\":" << (tiled ? tile : 0)
+              << ",\"connected\":" << (reachable == cells ? "true" : "false")
+              << ",\"reachable\":" << reachable;
+    if (solve) {
+        std::cout << ",\"solved\":" << (pathLength >= 0 ? "true" : "false") << ",\"path_length\":" << pathLength;
+    }
+    if (analyze) {
+        std::cout << ",\"stats\":{\"dead_ends\":" << stats.deadEnds << ",\"junctions\":" << stats.junctions
+                  << ",\"degrees\":[";
+        for (int d = 0; d < 5; d++) std::cout << (d ? "," : "") << stats.degreeCounts[d];
+        std::cout << "],\"branching_factor\":" << stats.branchingFactor << ",\"corridors\":" << stats.corridors
+                  << ",\"mean_corridor\":" << stats.meanCorridor << ",\"longest_corridor\":" << stats.longestCorridor
+                  << ",\"corridor_histogram\":[";
+        for (size_t i = 1; i < stats.corridorHistogram.size(); i++) {
+            std::cout << (i > 1 ? "," : "") << stats.corridorHistogram[i];
+        }
+        std::cout << "],\"diameter\":" << stats.diameter << ",\"diameter_ends\":[[" << stats.diameterFrom % width
+                  << "," << stats.diameterFrom / width << "],[" << stats.diameterTo % width << ","
+                  << stats.diameterTo / width << "]],\"solution_length\":" << stats.solutionLength
+                  << ",\"solution_turns\":" << stats.solutionTurns << ",\"tortuosity\":" << stats.tortuosity
+                  << ",\"river_factor\":" << stats.riverFactor << "}";
+    }
+    if (options.count("out")) std::cout << ",\"out\":" << jsonString(options["out"]);
+    if (options.count("render")) std::cout << ",\"render_out\":" << jsonString(options["render-out"]);
+    std::cout << ",\"timings_ms\":{";
+    for (size_t i = 0; i < profiler.phases().size(); i++) {
+        const PhaseProfiler::Phase& phase = profiler.phases()[i];
+        std::cout << (i ? "," : "") << jsonString(phase.name) << ":" << phase.milliseconds;
+    }
+    std::cout << "},\"instrumented\":" << (MAZE_INSTRUMENTED ? "true" : "false")
+              << ",\"hardware_counters\":" << (profiler.hardwareAvailable() ? "true" : "false");
+    if (MAZE_INSTRUMENTED || profiler.hardwareAvailable()) {
+        std::cout << ",\"phases\":";
+        profiler.writeJson(std::cout);
+    }
+    std::cout << ",\"exit_code\":" << status << "}\n";
+    std::cout.unsetf(std::ios::floatfield);
+    return std::cout ? status : 1;
+}
+
 /**
  * Main program loop
  */
-int main() {
+int main(int argc, char* argv[]) {
+    if (argc > 1 && std::string(argv[1]) == "stream") {
+        return runStreamCommand(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "scaling") {
+        return runScalingCommand(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "batch") {
+        return runBatchCommand(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "solvers") {
+        return runSolversCommand(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "treeindex") {
+        return runTreeIndexCommand(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "render") {
+        return runRenderCommand(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "filebench") {
+        return runFileBenchCommand(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "image") {
+        return runImageCommand(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "bench") {
+        return runBenchCommand(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "gen") {
+        return runGenCommand(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "rng") {
+        return runRngCommand(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "connectivity") {
+        return runConnectivityCommand(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "pbfs") {
+        return runParallelBfsCommand(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "analyze") {
+        return runAnalyzeCommand(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "pool") {
+        return runPoolCommand(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "edits") {
+        return runEditsCommand(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "layout") {
+        return runLayoutCommand(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "fixed") {
+        return runFixedCommand(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "multi") {
+        return runMultiCommand(argc, argv);
+    }
+    
+
     std::cout << "Welcome to the Recursive Maze Generator!\n";
     std::cout << "This program demonstrates various maze generation algorithms.\n";
     
@@ -208,6 +1311,44 @@ int main() {
         // Handle both numeric and letter input
         if (input == "A" || input == "a") {
             choice = 10; // Use 10 for connectivity check
+        } else if (input == "B" || input == "b") {
+            choice = 11; // Use 11 for algorithm selection
+        } else if (input == "C" || input == "c") {
+            choice = 12; // Use 12 for the scaling benchmark
+        } else if (input == "D" || input == "d") {
+            choice = 13; // Use 13 for the batch benchmark
+        } else if (input == "E" || input == "e") {
+            choice = 14; // Use 14 for the solver comparison
+        } else if (input == "F" || input == "f") {
+            choice = 15; // Use 15 for the tree index benchmark
+        } else if (input == "G" || input == "g") {
+            choice = 16; // Use 16 for the rendering benchmark
+        } else if (input == "H" || input == "h") {
+            choice = 17; // Use 17 to save the current maze
+        } else if (input == "I" || input == "i") {
+            choice = 18; // Use 18 to load a maze
+        } else if (input == "J" || input == "j") {
+            choice = 19; // Use 19 for the file benchmark
+        } else if (input == "K" || input == "k") {
+            choice = 20; // Use 20 to export an image
+        } else if (input == "L" || input == "l") {
+            choice = 21; // Use 21 for the random engine benchmark
+        } else if (input == "M" || input == "m") {
+            choice = 22; // Use 22 for the connectivity benchmark
+        } else if (input == "N" || input == "n") {
+            choice = 23; // Use 23 for the parallel BFS benchmark
+        } else if (input == "O" || input == "o") {
+            choice = 24; // Use 24 for the analytics benchmark
+        } else if (input == "P" || input == "p") {
+            choice = 25; // Use 25 for the maze reuse benchmark
+        } else if (input == "Q" || input == "q") {
+            choice = 26; // Use 26 for the wall edit benchmark
+        } else if (input == "R" || input == "r") {
+            choice = 27; // Use 27 for the cell layout benchmark
+        } else if (input == "S" || input == "s") {
+            choice = 28; // Use 28 for the compile-time size benchmark
+        } else if (input == "T" || input == "t") {
+            choice = 29; // Use 29 for the batched distance query benchmark
         } else {
             try {
                 choice = std::stoi(input);
@@ -218,12 +1359,12 @@ int main() {
         
         switch (choice) {
             case 1:
-                currentMaze = Maze(10, 10);
+                currentMaze.reset(10, 10);
                 generateBasicMaze(currentMaze, false);
                 break;
                 
             case 2:
-                currentMaze = Maze(10, 10);
+                currentMaze.reset(10, 10);
                 generateBasicMaze(currentMaze, true);
                 break;
                 
@@ -258,7 +1399,83 @@ int main() {
                 
             case 10:
                 std::cout << "\nChecking maze connectivity...\n";
-                currentMaze.isMazeConnected();
+                printConnectivity(currentMaze);
+                break;
+                
+            case 11:
+                generateAlgorithmMaze(currentMaze);
+                break;
+                
+            case 12:
+                parallelScalingTest();
+                break;
+                
+            case 13:
+                batchThroughputTest();
+                break;
+                
+            case 14:
+                solverComparisonTest();
+                break;
+                
+            case 15:
+                treeIndexTest();
+                break;
+                
+            case 16:
+                renderThroughputTest();
+                break;
+                
+            case 17:
+                saveMazeToFile(currentMaze);
+                break;
+                
+            case 18:
+                loadMazeFromFile(currentMaze);
+                break;
+                
+            case 19:
+                fileLoadTest();
+                break;
+                
+            case 20:
+                exportMazeImage(currentMaze);
+                break;
+                
+            case 21:
+                randomEngineTest();
+                break;
+                
+            case 22:
+                connectivityTest();
+                break;
+                
+            case 23:
+                parallelBfsTest();
+                break;
+                
+            case 24:
+                analyticsTest();
+                break;
+                
+            case 25:
+                mazePoolTest();
+                break;
+                
+            case 26:
+                wallEditTest();
+                break;
+                
+            case 27:
+                cellLayoutTest();
+                break;
+                
+            case 28:
+                fixedMazeTest();
+                break;
+                
+            case 29:
+                multiSourceTest();
                 break;
                 
             case 0: